@@ -111,6 +111,34 @@ static uint8_t buffer[SSD1306_LCDHEIGHT * SSD1306_LCDWIDTH / 8] = {
 
 #define ssd1306_swap(a, b) { int16_t t = a; a = b; b = t; }
 
+#define SSD1306_PAGES (SSD1306_LCDHEIGHT / 8)
+
+// i2c_t3 buffers a whole page of data in one transmission. Wire only 32 bytes.
+#ifdef I2C_TX_BUFFER_LENGTH
+  #define SSD1306_I2C_DATA_LENGTH SSD1306_LCDWIDTH
+#else
+  #define SSD1306_I2C_DATA_LENGTH 16
+#endif
+
+// Partial refresh. 17/10/2026 John Semmens
+// shown is a copy of what the display RAM holds. For each 8 row page, the columns drawn since the last display()
+// are from dirtyFirst to dirtyLast. display() sends only the columns in that range that differ from shown,
+// so a page that redraws everything but changes a few numbers sends only those numbers.
+static uint8_t shown[SSD1306_LCDHEIGHT * SSD1306_LCDWIDTH / 8];
+static boolean shownValid = false;    // false until the whole display has been sent, or after a failed send or a scroll.
+static uint8_t dirtyFirst[SSD1306_PAGES];
+static uint8_t dirtyLast[SSD1306_PAGES];  // a page is clean when dirtyFirst > dirtyLast
+
+static inline void markDirty(uint8_t page, uint8_t first, uint8_t last) {
+  if (first < dirtyFirst[page]) dirtyFirst[page] = first;
+  if (last > dirtyLast[page]) dirtyLast[page] = last;
+}
+
+static void markAllDirty(void) {
+  memset(dirtyFirst, 0, sizeof(dirtyFirst));
+  memset(dirtyLast, SSD1306_LCDWIDTH - 1, sizeof(dirtyLast));
+}
+
 // the most basic function, set a single pixel
 void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
   if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
@@ -133,6 +161,7 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
   }
 
   // x is which column
+    markDirty(y/8, x, x);
     switch (color)
     {
       case WHITE:   buffer[x+ (y/8)*SSD1306_LCDWIDTH] |=  (1 << (y&7)); break;
@@ -171,6 +200,10 @@ void Adafruit_SSD1306::begin(uint8_t vccstate, uint8_t i2caddr, bool reset) {
   _vccstate = vccstate;
   _i2caddr = i2caddr;
 
+  // the display RAM is unknown, so the first display() sends everything.
+  shownValid = false;
+  markAllDirty();
+
   // set pin directions
   if (sid != -1){
     pinMode(dc, OUTPUT);
@@ -394,6 +427,10 @@ void Adafruit_SSD1306::startscrolldiagleft(uint8_t start, uint8_t stop){
 
 void Adafruit_SSD1306::stopscroll(void){
   ssd1306_command(SSD1306_DEACTIVATE_SCROLL);
+
+  // scrolling moves the data in the display RAM, which then has to be rewritten.
+  shownValid = false;
+  markAllDirty();
 }
 
 // Dim the display
@@ -418,76 +455,90 @@ void Adafruit_SSD1306::dim(boolean dim) {
 }
 
 void Adafruit_SSD1306::display(void) {
-  ssd1306_command(SSD1306_COLUMNADDR);
-  ssd1306_command(0);   // Column start address (0 = reset)
-  ssd1306_command(SSD1306_LCDWIDTH-1); // Column end address (127 = reset)
-
-  ssd1306_command(SSD1306_PAGEADDR);
-  ssd1306_command(0); // Page start address (0 = reset)
-  #if SSD1306_LCDHEIGHT == 64
-    ssd1306_command(7); // Page end address
-  #endif
-  #if SSD1306_LCDHEIGHT == 32
-    ssd1306_command(3); // Page end address
-  #endif
-  #if SSD1306_LCDHEIGHT == 16
-    ssd1306_command(1); // Page end address
-  #endif
+  // send the changed columns of each page. The whole buffer is 1 KB, about 25 ms of I2C at 400 kHz,
+  // and most pages change only a few numbers each time they are drawn.
+  boolean sendFailed = false;
+
+  for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+    int16_t first = dirtyFirst[page];
+    int16_t last = dirtyLast[page];
+    dirtyFirst[page] = SSD1306_LCDWIDTH;
+    dirtyLast[page] = 0;
+
+    uint8_t *pBuf = buffer + page * SSD1306_LCDWIDTH;
+    uint8_t *pShown = shown + page * SSD1306_LCDWIDTH;
+
+    if (shownValid) {
+      while ((first <= last) && (pBuf[first] == pShown[first])) first++;
+      while ((last >= first) && (pBuf[last] == pShown[last])) last--;
+    }
+    if (first > last) continue;
 
-  if (sid != -1)
-  {
-    // SPI
+    const uint8_t window[] = { SSD1306_COLUMNADDR, (uint8_t)first, (uint8_t)last, SSD1306_PAGEADDR, page, page };
+    if (!ssd1306_commandList(window, sizeof(window))) sendFailed = true;
+
+    if (sid != -1)
+    {
+      // SPI
 #ifdef HAVE_PORTREG
-    *csport |= cspinmask;
-    *dcport |= dcpinmask;
-    *csport &= ~cspinmask;
+      *csport |= cspinmask;
+      *dcport |= dcpinmask;
+      *csport &= ~cspinmask;
 #else
-    digitalWrite(cs, HIGH);
-    digitalWrite(dc, HIGH);
-    digitalWrite(cs, LOW);
+      digitalWrite(cs, HIGH);
+      digitalWrite(dc, HIGH);
+      digitalWrite(cs, LOW);
 #endif
 
-    for (uint16_t i=0; i<(SSD1306_LCDWIDTH*SSD1306_LCDHEIGHT/8); i++) {
-      fastSPIwrite(buffer[i]);
-    }
+      for (int16_t x=first; x<=last; x++) {
+        fastSPIwrite(pBuf[x]);
+      }
 #ifdef HAVE_PORTREG
-    *csport |= cspinmask;
+      *csport |= cspinmask;
 #else
-    digitalWrite(cs, HIGH);
+      digitalWrite(cs, HIGH);
 #endif
+    }
+    else
+    {
+      // I2C
+      for (int16_t x=first; x<=last; ) {
+        // send a bunch of data in one xmission
+        Wire.beginTransmission(_i2caddr);
+        WIRE_WRITE(0x40);
+        for (uint8_t n=0; (n<SSD1306_I2C_DATA_LENGTH) && (x<=last); n++) {
+          WIRE_WRITE(pBuf[x++]);
+        }
+        if (Wire.endTransmission() != 0) sendFailed = true;
+      }
+    }
+
+    memcpy(pShown + first, pBuf + first, last - first + 1);
   }
-  else
-  {
-    // save I2C bitrate
-#ifdef TWBR
-    uint8_t twbrbackup = TWBR;
-    TWBR = 12; // upgrade to 400KHz!
-#endif
 
-    //Serial.println(TWBR, DEC);
-    //Serial.println(TWSR & 0x3, DEC);
+  // if the display didn't acknowledge, its RAM is unknown. Send everything next time.
+  shownValid = !sendFailed;
+  if (sendFailed) markAllDirty();
+}
 
-    // I2C
-    for (uint16_t i=0; i<(SSD1306_LCDWIDTH*SSD1306_LCDHEIGHT/8); i++) {
-      // send a bunch of data in one xmission
-      Wire.beginTransmission(_i2caddr);
-      WIRE_WRITE(0x40);
-      for (uint8_t x=0; x<16; x++) {
-        WIRE_WRITE(buffer[i]);
-        i++;
-      }
-      i--;
-      Wire.endTransmission();
-    }
-#ifdef TWBR
-    TWBR = twbrbackup;
-#endif
+boolean Adafruit_SSD1306::ssd1306_commandList(const uint8_t *c, uint8_t n) {
+  // send several commands. Over I2C they are sent in one transmission. Returns false if the display didn't acknowledge.
+  if (sid != -1)
+  {
+    while (n--) ssd1306_command(*c++);
+    return true;
   }
+
+  Wire.beginTransmission(_i2caddr);
+  WIRE_WRITE((uint8_t)0x00);   // Co = 0, D/C = 0
+  while (n--) WIRE_WRITE(*c++);
+  return Wire.endTransmission() == 0;
 }
 
 // clear everything
 void Adafruit_SSD1306::clearDisplay(void) {
   memset(buffer, 0, (SSD1306_LCDWIDTH*SSD1306_LCDHEIGHT/8));
+  markAllDirty();
 }
 
 
@@ -564,6 +615,8 @@ void Adafruit_SSD1306::drawFastHLineInternal(int16_t x, int16_t y, int16_t w, ui
   // if our width is now negative, punt
   if(w <= 0) { return; }
 
+  markDirty(y/8, x, x + w - 1);
+
   // set up the pointer for  movement through the buffer
   register uint8_t *pBuf = buffer;
   // adjust the buffer pointer for the current row
@@ -642,6 +695,10 @@ void Adafruit_SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h
   register uint8_t y = __y;
   register uint8_t h = __h;
 
+  for (uint8_t page = y/8; page <= (y+h-1)/8; page++) {
+    markDirty(page, x, x);
+  }
+
 
   // set up the pointer for fast movement through the buffer
   register uint8_t *pBuf = buffer;
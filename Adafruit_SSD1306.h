@@ -171,6 +171,7 @@ class Adafruit_SSD1306 : public Adafruit_GFX {
  private:
   int8_t _i2caddr, _vccstate, sid, sclk, dc, rst, cs;
   void fastSPIwrite(uint8_t c);
+  boolean ssd1306_commandList(const uint8_t *c, uint8_t n);
 
   boolean hwSPI;
 #ifdef HAVE_PORTREG
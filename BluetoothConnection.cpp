@@ -6,10 +6,13 @@
 #include "configValues.h"
 #include "Wingsail.h"
 #include "HAL_SDCard.h"
+#include "CommandTable.h"
+#include "TextFormat.h"
 
 extern byte BluetoothStatePin;
 extern BTStateType BTState;
-extern HardwareSerial *Serials[];
+extern Stream *Serials[];
+extern HardwareSerial *UARTs[];
 extern configValuesType Configuration;
 extern int CommandPort;
 extern WingSailType WingSail;
@@ -24,7 +27,7 @@ void Bluetooth_Init(int BluetoothPort)
 	Serial.print(Configuration.BTPortBaudRate);
 	Serial.println("Baud.");
 
-	(*Serials[BluetoothPort]).begin(Configuration.BTPortBaudRate);
+	(*UARTs[BluetoothPort]).begin(Configuration.BTPortBaudRate);
 	pinMode(BluetoothStatePin, INPUT_PULLUP);
 	Serial.println("*** Bluetooth Serial Initialised.");
 }
@@ -34,7 +37,7 @@ void BluetoothManageConnection(int BluetoothPort)
 	// call this connection management procedure at around 5 second intervals
 
 	static BTStateType BTStatePrev;
-	String BTStatus;
+	char BTStatus[40];
 
 	if (digitalRead(BluetoothStatePin) == LOW) // LOW is not connected
 	{
@@ -52,7 +55,7 @@ void BluetoothManageConnection(int BluetoothPort)
 		
 			BTState = Connecting;
 
-			BTStatus = "BT:" + GetBTStatus(BTState) + ":" + Configuration.BT_MAC_Address;
+			FormatText(BTStatus, sizeof(BTStatus), "BT:%s:%.12s", GetBTStatus(BTState), Configuration.BT_MAC_Address);
 			Serial.println(BTStatus);
 			SD_Logging_Event_Messsage(BTStatus);
 			break;
@@ -60,7 +63,7 @@ void BluetoothManageConnection(int BluetoothPort)
 		case Connecting:
 			BTState = Initialised;
 
-			BTStatus = "BT:" + GetBTStatus(BTState);
+			FormatText(BTStatus, sizeof(BTStatus), "BT:%s", GetBTStatus(BTState));
 			Serial.println(BTStatus);
 			SD_Logging_Event_Messsage(BTStatus);
 			break;
@@ -73,7 +76,7 @@ void BluetoothManageConnection(int BluetoothPort)
 			{
 				BTState = Initialised;
 
-				BTStatus = "BT:" + GetBTStatus(BTState);
+				FormatText(BTStatus, sizeof(BTStatus), "BT:%s", GetBTStatus(BTState));
 				Serial.println(BTStatus);
 				SD_Logging_Event_Messsage(BTStatus);
 			}
@@ -99,7 +102,7 @@ void BluetoothManageConnection(int BluetoothPort)
 			(*Serials[Configuration.BluetoothPort]).println("");
 			(*Serials[Configuration.BluetoothPort]).println(F("flg,3")); // flash green led x 3
 
-			BTStatus = "BT:" + GetBTStatus(BTState);
+			FormatText(BTStatus, sizeof(BTStatus), "BT:%s", GetBTStatus(BTState));
 			Serial.println(BTStatus);
 			SD_Logging_Event_Messsage(BTStatus);
 
@@ -181,7 +184,7 @@ void BluetoothInitialiseConnection(int BluetoothPort)
 	}
 }
 
-String GetBTStatus(BTStateType BTState)
+const char* GetBTStatus(BTStateType BTState)
 {
 	// return a string representation of the Bluetooth state
 
@@ -199,121 +202,86 @@ String GetBTStatus(BTStateType BTState)
 
 
 
-// Command Line Interpreter - Global Variables
-char BT_CLI_Msg[50];
-unsigned int BT_CLI_i = 0;
+// ===============================================
+// Wingsail Command pow, WingSail Power.
+// ===============================================
+// Parameter 1: Solar Cell Voltage
+// Parameter 2: Solar Cell current
+// Parameter 3: Charge Voltage
+// Parameter 4: Charge current
+// Parameter 5: Discharge Voltage
+// Parameter 6: Discharge current
+static void BT_pow(int BluetoothPort, char* Param[])
+{
+	WingSail.SolarCell_V = atof(Param[1]);
+	WingSail.SolarCell_mA = atof(Param[2]);
+	WingSail.Charge_V = atof(Param[3]);
+	WingSail.Charge_mA = atof(Param[4]);
+	WingSail.Discharge_V = atof(Param[5]);
+	WingSail.Discharge_mA = atof(Param[6]);
 
-// Collect the characters into a command string until end end of line,
-// and then process it.
-// V1.0 22/12/2015
-// called from a 1 second loop (logging loop)
-void BT_CLI_Process_Message(int BluetoothPort)
+	WingSail.LastPowerResponseTime = millis();
+	WingSailLinkResponse(wlPower);
+
+	SD_Logging_Event_Wingsail_Power();
+}
+
+// gsv - Get Wingsail Servo response
+static void BT_gsv(int BluetoothPort, char* Param[])
+{
+	WingSail.Servo_microseconds_reponse = atoi(Param[1]);
+	WingSail.LastResponseTime = millis();
+	WingSailLinkResponse(wlQuery);
+
+	SD_Logging_Event_Wingsail_Monitor("Response");
+}
+
+// ver - Wingsail version and date
+static void BT_ver(int BluetoothPort, char* Param[])
 {
-	// Accumulate characters in a command string up to a CR or LF or buffer fills. 
-	while ((*Serials[BluetoothPort]).available())
+	// log the wingsail version to the SD Card
+	// the version and date are the first two parameters. Put back the comma between them.
+	if (*Param[2])
 	{
-		char received = (*Serials[BluetoothPort]).read();
-		if (BT_CLI_i < sizeof(BT_CLI_Msg) - 1) // Ensure there is space for the received character and null terminator
-		{
-			BT_CLI_Msg[BT_CLI_i++] = received;
-		}
+		Param[1][strlen(Param[1])] = ',';
+	}
 
-		// Process message when new line character is received
-		if (received == '\n' || received == '\r' || BT_CLI_i == sizeof(BT_CLI_Msg) - 1)
-		{
-			BT_CLI_Msg[BT_CLI_i] = '\0';
+	// the CLISession has already removed the CR/LF from the end of the line.
+	strncpy(WingSail.VersionDate, Param[1], sizeof(WingSail.VersionDate) - 1);
+	WingSail.VersionDate[sizeof(WingSail.VersionDate) - 1] = '\0';
 
-			// only pass strings to CLI Processor if we are connected.
-			// the test is here, because we want pre-connection strings to be reflected
-			// through to the serial port for diag.
-			if (BTState == BTStateType::Connected)
-			{
-				BT_CLI_Processor(BluetoothPort);
-			}					
+	WingSailLinkResponse(wlVersion);
 
-			BT_CLI_i = 0;
-		}
-	}
+	SD_Logging_Event_Messsage(WingSail.VersionDate);
 }
 
+// The wingsail responses, in order of command for the binary search in CommandDispatch.
+static constexpr CommandEntryType BT_Commands[] = {
+	{ CommandKey("gsv"), BT_gsv },
+	{ CommandKey("pow"), BT_pow },
+	{ CommandKey("ver"), BT_ver },
+};
+static_assert(CommandTableSorted(BT_Commands), "BT_Commands must be in order of command, with no command repeated.");
 
 // Process the BT Response String.
 // Split into command and parameters separated by commas. 
 // V1.0 22/12/2015
 // V1.1 13/01/2018 added support for a Vessel Command Parameter. i.e. steer a magnetic heading
 // V1.2 1/12/2018 changed strcpy to strncpy to guard against corrupting memory with long strings
+// V1.3 17/10/2026 the response is found in the BT_Commands table, and the parameters point into BT_CLI_Msg rather than being copied.
+// V1.4 17/10/2026 the line is passed in by the Bluetooth port's CLISession, polled every 10 ms.
 
-void BT_CLI_Processor(int BluetoothPort)
+void BT_CLI_Processor(int BluetoothPort, char* line)
 {
 	// debug
 	//Serial.print("BT_CLI_Msg:");
-	//Serial.print(BT_CLI_Msg);
+	//Serial.print(line);
 	//Serial.println("/BT_CLI_Msg");
 
-	char cmd[4] = "";
-	char param1[30] = "";
-	char param2[20] = "";
-	char param3[12] = "";
-	char param4[12] = "";
-	char param5[12] = "";
-	char param6[12] = "";
-
-	strcat(BT_CLI_Msg, ",");
-
-	// Split into command and parameters separated by commas. 
-	strncpy(cmd, strtok(BT_CLI_Msg, ","), sizeof(cmd)-1);
-	strncpy(param1, strtok(NULL, ","), sizeof(param1)-1);
-	strncpy(param2, strtok(NULL, ","), sizeof(param2)-1);
-	strncpy(param3, strtok(NULL, ","), sizeof(param3)-1);
-	strncpy(param4, strtok(NULL, ","), sizeof(param4)-1);
-	strncpy(param5, strtok(NULL, ","), sizeof(param5)-1);
-	strncpy(param6, strtok(NULL, ","), sizeof(param6)-1);
-
-
-	// ===============================================
-	// Wingsail Command wsv, WingSail Voltage.
-	// ===============================================
-	// Parameter 1: WingSail Battery Voltage
-	// Parameter 2: WingSail Battery currrent
-	// 
-	if (!strncmp(cmd, "pow", 3))
-	{
-		WingSail.SolarCell_V = atof(param1);
-		WingSail.SolarCell_mA = atof(param2);
-		WingSail.Charge_V = atof(param3);
-		WingSail.Charge_mA = atof(param4);
-		WingSail.Discharge_V = atof(param5);
-		WingSail.Discharge_mA = atof(param6);
-
-		WingSail.LastPowerResponseTime = millis();
-
-		SD_Logging_Event_Wingsail_Power();
-	}
-
-	// gsv - Get Wingsail Servo response
-	if (!strncmp(cmd, "gsv", 3))
-	{
-		WingSail.Servo_microseconds_reponse = atoi(param1);
-		WingSail.LastResponseTime = millis();
-
-		SD_Logging_Event_Wingsail_Monitor("Response");
-	}
-
-	if (!strncmp(cmd, "ver", 3))
+	// only process responses once we are connected.
+	// lines received before the connection are discarded.
+	if (BTState == BTStateType::Connected)
 	{
-		// log the wingsail version to the SD Card
-		strcat(param1, ",");
-		strcat(param1, param2);
-		
-		// strip the CrLf off the end of the string
-		// simply shorten the string, as long as its got some length
-		if (strlen(param1) > 4)
-		{
-			param1[strlen(param1) - 1] = '\0';
-		}
-
-		strcpy(WingSail.VersionDate, param1);
-
-		SD_Logging_Event_Messsage(param1);
+		CommandDispatch(BT_Commands, sizeof(BT_Commands) / sizeof(BT_Commands[0]), BluetoothPort, line);
 	}
-};
\ No newline at end of file
+}
@@ -17,10 +17,9 @@ void BluetoothInitialiseConnection(int BluetoothPort);
 
 void BluetoothManageConnection(int BluetoothPort);
 
-String GetBTStatus(BTStateType BTState);
+const char* GetBTStatus(BTStateType BTState);
 
-void BT_CLI_Process_Message(int BluetoothPort);
-void BT_CLI_Processor(int BluetoothPort);
+void BT_CLI_Processor(int BluetoothPort, char* line);
 
 #endif
 
@@ -21,6 +21,32 @@
 // V1.16 22/5/2022 removing relaying and addressing.
 // V1.17 22/7/2023 removed GPS power controls.
 //					Removed telemetry feedback on MIS and MCC. They were interfering with the mission programming sequence.
+// V1.18 17/10/2026 added tpl and tpc, for listing and clearing the task execution time profile.
+// V1.19 17/10/2026 added idl, scheduler idle mode set/get and current comparison.
+// V1.20 17/10/2026 added sms, Set Simulation Speed.
+// V1.21 17/10/2026 added mcr, simulated mission batch runs.
+// V1.22 17/10/2026 added spb, Simulated Polar Benchmark.
+// V1.23 17/10/2026 added optional wind speed to ssw.
+// V1.24 17/10/2026 added srs, Set Random Seed of the simulation.
+// V1.25 17/10/2026 added lrp, Log RePlay through the sailing navigation.
+// V1.26 17/10/2026 added parameter 56 SDCardLogBinary, and lbd, Log Binary Decode.
+// V1.27 17/10/2026 added parameter 57 TelemetryBinary.
+// V1.28 17/10/2026 each command is a handler function in the CLI_Commands table, found by a binary search.
+// V1.29 17/10/2026 parameters get and set through the parameter registry. added prd, Parameter Dump, and prb, Parameter Bulk load.
+// V1.30 17/10/2026 lines assembled by a CLISession per port, polled every 10 ms. added css, CLI Session Statistics.
+// V1.31 17/10/2026 added wsl, WingSail Link statistics.
+// V1.32 17/10/2026 log messages formatted with FormatText rather than Strings. added mem, heap memory statistics.
+// V1.33 17/10/2026 added parameter 58 CompassOversampling, and ims, IMU Statistics.
+// V1.34 17/10/2026 added i2c, I2C manager statistics.
+// V1.35 17/10/2026 added parameter 59 CompassEllipsoid, mgf, MaGnetometer ellipsoid Fit, mgr, MaGnetometer Record, and mgb, MaGnetometer Bench comparison.
+// V1.36 17/10/2026 lbd lists a range of records, so a long file doesn't hold up the other tasks.
+// V1.37 17/10/2026 lrp is refused unless the vessel is idle.
+// V1.38 17/10/2026 srs writes the seed as a log header line rather than an event.
+// V1.39 17/10/2026 mem reports the heap allocator calls.
+// V1.40 17/10/2026 prs logs the parameter change only if the value was accepted.
+// V1.41 17/10/2026 commands accepted from the USB port, port 0. css reports the USB session.
+// V1.42 17/10/2026 lbd only when the vessel is idle, and 2 records by default, so a range is sent in a few hundred ms.
+// V1.43 17/10/2026 lrp reports the decisions matched by type and reason with the logged DEC records.
 
 #include "CommandState_Processor.h"
 #include "Mission.h"
@@ -39,9 +65,21 @@
 #include "location.h"
 #include "sim_vessel.h"
 #include "sim_weather.h"
+#include "sim_batch.h"
+#include "sim_rng.h"
 #include "DisplayStrings.h"
 #include "LoRaManagement.h"
 #include "HAL_Time.h"
+#include "SchedulerCooperative.h"
+#include "HAL_PowerMeasurement.h"
+#include "LogReplay.h"
+#include "CommandTable.h"
+#include "ParameterRegistry.h"
+#include "CLISession.h"
+#include "TextFormat.h"
+#include "HeapMonitor.h"
+#include "I2CManager.h"
+#include "CompassBench.h"
 
 extern NavigationDataType NavData;
 extern HALGPS gps;
@@ -51,7 +89,7 @@ extern configValuesType Configuration;
 extern MissionValuesStruct MissionValues;
 extern StateValuesStruct StateValues;
 extern bool UseSimulatedVessel;
-extern HardwareSerial *Serials[];
+extern Stream *Serials[];
 
 extern char MessageDisplayLine1[10];
 extern char MessageDisplayLine2[10];
@@ -69,1366 +107,1462 @@ extern int LastParameterIndex;
 
 extern sim_vessel simulated_vessel;
 extern sim_weather simulated_weather;
+extern sim_batch simulated_batch;
+extern uint32_t SimulationSeed;
 extern HALIMU imu;
+extern HALPowerMeasure PowerSensor;
+extern CLISession USBCLI;
+extern CLISession LoRaCLI;
+extern CLISession BluetoothCLI;
 
-// Command Line Interpreter - Global Variables
-char CLI_Msg[60];
-unsigned int CLI_i = 0;
-
+// ===============================================
+// Command ech: Echo the command and parameters
+// ===============================================
+static void CLI_ech(int CommandPort, char* Param[])
+{
+	(*Serials[CommandPort]).print(Param[0]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[1]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[2]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[3]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[4]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[5]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[6]);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(Param[7]);
+	(*Serials[CommandPort]).println();
+}
 
-// Collect the characters into a command string until end end of line,
-// and then process it.
-// V1.0 22/12/2015
-void CLI_Process_Message(int CommandPort)
+// ===============================================
+// Command mcs: Mission Command Set
+// ===============================================
+// set a Mission Command
+// Parameter 1: Mission Sequence Number 
+// Parameter 2: Mission Command 
+// Parameter 3: MC Param 1
+// Parameter 4: MC Param 2
+// Parameter 5: MC Param 3  
+// Parameter 6: MC Param 4
+// Parameter 7: MC Param 5
+static void CLI_mcs(int CommandPort, char* Param[])
 {
-	// This is called from the medium loop, about 1 sec.
-	// Accumulate characters in a command string up to a CR or LF or buffer fills. 
-	while ((*Serials[CommandPort]).available())
+	// set the sequence number of the command starting with zero
+	int Mission_cmd_ptr = atoi(Param[1]);
+
+	// Advance the mission size to encompass the specified position
+	if ((Mission_cmd_ptr + 1) > MissionValues.mission_size) {
+		MissionValues.mission_size = Mission_cmd_ptr + 1;
+	}
+
+	MissionCommandType mc = MissionCommandType(atoi(Param[2]));
+	MissionValues.MissionList[Mission_cmd_ptr].cmd = mc;
+
+	switch (mc)
 	{
-		char received = (*Serials[CommandPort]).read();
-		if (CLI_i < sizeof(CLI_Msg) - 1)
-		{
-			CLI_Msg[CLI_i++] = received;
-		}
+	case ctGotoWaypoint:
+		MissionValues.MissionList[Mission_cmd_ptr].waypoint.lat = atof(Param[3]) * 10000000UL;  //Latitude  * 10**7
+		MissionValues.MissionList[Mission_cmd_ptr].waypoint.lng = atof(Param[4]) * 10000000UL;  //Longitude * 10**7
+		MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(Param[5]);      // metres
+		MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(Param[6]);      // Control Mask
+		break;
 
-		// Process message when new line character is received
-		if (received == '\n' || CLI_i >= sizeof(CLI_Msg) - 1) // || received == '\r'
-		{
-			// Adjust CLI_i to correctly remove trailing CRLF if they exist
-			if (CLI_i >= 2 && CLI_Msg[CLI_i - 2] == '\r')
-			{
-				CLI_i -= 2;
-			}
-			else if (CLI_i >= 1 && (CLI_Msg[CLI_i - 1] == '\n' || CLI_Msg[CLI_i - 1] == '\r'))
-			{
-				CLI_i -= 1;
-			}
+	case ctLoiter:
+	case ctLoiterUntil:
+		MissionValues.MissionList[Mission_cmd_ptr].waypoint.lat = atof(Param[3]) * 10000000UL;  //Latitude  * 10**7
+		MissionValues.MissionList[Mission_cmd_ptr].waypoint.lng = atof(Param[4]) * 10000000UL;  //Longitude * 10**7
+		MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(Param[5]);	   // metres
+		MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(Param[6]);      // Control Mask
+		MissionValues.MissionList[Mission_cmd_ptr].duration = atoi(Param[7]);	   // minutes
+		break;
 
-			CLI_Msg[CLI_i] = '\0';
+	case ctReturnToHome:
+		MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(Param[3]);	   // metres
+		MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(Param[4]);      // Control Mask
+		break;
 
-			if (strlen(CLI_Msg) >= 3) // check the command is long enough
-			{
-				CLI_Processor(CommandPort);
-			}
-			CLI_i = 0;
-		}
+	case ctSteerWindCourse:
+		MissionValues.MissionList[Mission_cmd_ptr].SteerAWA = atoi(Param[3]);		// SteerAWA degrees
+		MissionValues.MissionList[Mission_cmd_ptr].TrimTabAngle = atoi(Param[4]);  //TrimTabAngle degrees
+		MissionValues.MissionList[Mission_cmd_ptr].duration = atoi(Param[5]);      // metres
+		MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(Param[6]);      // Control Mask
+		break;
+
+	default:;
 	}
 }
 
-void CLI_Processor(int CommandPort, String Command)
+// ===============================================
+// Command scs: Set Command State
+// ===============================================
+// Set the vessel into a specifed command State
+// Parameter 1: Command State (enumerated Type) 
+	//vcsIdle,					// idle state, feathered settings for sails.
+	//vcsFullManual,				// The vessel is under manual command via RC
+	//vcsPartialManual,				// The vessel is under manual command via RC
+	//vcsFollowMission,		// The vessel is under automatic control following the mission list.
+	//vcsSteerMagneticCourse,	// The vessel is steering a course relative to the compass
+	//vcsSteerWindCourse,		// The vessel is steering a course relative to the wind.
+	//vcsReturnToHome,			// return to the preset home location
+	//vcsSetHome,				// set home location
+	//vcsResetMissionIndex		// Reset the Mission Index, to force a restsart of the mission.		
+	//vcsLoiter				// Loiter here.
+static void CLI_scs(int CommandPort, char* Param[])
 {
-	Command.toCharArray(CLI_Msg, Command.length()); 
-	CLI_Processor(CommandPort);
-	CLI_i = 0;
+	StateValues.CommandState = VesselCommandStateType(atoi(Param[1]));
+	// set both steering angles to the command parameter
+	StateValues.SteerCompassBearing = wrap_360_Int(atoi(Param[2]));
+	StateValues.SteerWindAngle = atoi(Param[2]);
+
+	// Only set the TrimTabDefaultAngle if the command is vcsSteerWindCourse, otherwise it will interfere normal mission operation
+	if (StateValues.CommandState == VesselCommandStateType::vcsSteerWindCourse)
+	{
+		Configuration.TrimTabDefaultAngle = atoi(Param[3]);
+		DecisionEventValue2 = Configuration.TrimTabDefaultAngle;
+	}
+
+	// start command timer. Record the start time of each new command	
+	MissionValues.MissionCommandStartTime = VirtualMillis();
+
+	// save the state
+	Save_EEPROM_StateValues();
+
+	DecisionEvent = DecisionEventType::deChangeCommandState;
+	DecisionEventReason = DecisionEventReasonType::rManualIntervention;
+	DecisionEventValue = atoi(Param[2]);
+
+	// explictly log the commands to set the steering values for wind or compass.
+	SD_Logging_Event_Decisions();
+
+	// print the command state
+	QueueMessage(TelMessageType::SCS);
 }
 
-// Process the Command String.
-// Split into command and parameters separated by commas. 
-// V1.0 22/12/2015
-// V1.1 13/01/2018 added support for a Vessel Command Parameter. i.e. steer a magnetic heading
-// V1.2 1/12/2018 changed strcpy to strncpy to guard against corrupting memory with long strings
+// ===============================================
+// Command scg: Get Command State
+// ===============================================
+// get the current Command State.
+static void CLI_scg(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::SCG);
+}
 
-void CLI_Processor(int CommandPort)
-{
-	char cmd[4] = "";
-	char param1[12] = "";
-	char param2[12] = "";
-	char param3[12] = "";
-	char param4[12] = "";
-	char param5[12] = "";
-	char param6[12] = "";
-	char param7[12] = "";
-
-	strcat(CLI_Msg, ",");
-
-	// Split into command and parameters separated by commas. 
-	strncpy(cmd, strtok(CLI_Msg, ","), sizeof(cmd) - 1);
-	strncpy(param1, strtok(NULL, ","), sizeof(param1) - 1);
-	strncpy(param2, strtok(NULL, ","), sizeof(param2) - 1);
-	strncpy(param3, strtok(NULL, ","), sizeof(param3) - 1);
-	strncpy(param4, strtok(NULL, ","), sizeof(param4) - 1);
-	strncpy(param5, strtok(NULL, ","), sizeof(param5) - 1);
-	strncpy(param6, strtok(NULL, ","), sizeof(param6) - 1);
-	strncpy(param7, strtok(NULL, ","), sizeof(param7) - 1);
-
-	// ===============================================
-	// Command ech: Echo the command and parameters
-	// ===============================================
-	if (!strncmp(cmd, "ech", 3))
-	{
-		(*Serials[CommandPort]).print(cmd);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param1);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param2);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param3);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param4);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param5);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param6);
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(param7);
-		(*Serials[CommandPort]).println();
+// ===============================================
+// Command mis: Mission Command Index Set
+// ===============================================
+// Set the index to the one less the desired step. i.e. set to zero to commence with step 1.
+// This is usually 0 to start the mission
+// Parameter 1: Mission Sequence Number  
+static void CLI_mis(int CommandPort, char* Param[])
+{
+	StateValues.mission_index = atoi(Param[1]);
+
+	// save the state
+	Save_EEPROM_StateValues();
+
+	// since we are forcing a change in the mission index, then force a restart at that index.
+	StateValues.StartingMission = true;
+	NavData.next_WP_valid = false;
+
+	// update next WP for display purposes.
+	set_next_WP_for_display();
+}
+
+// ===============================================
+// Command mig: Mission Command Index Get
+// ===============================================
+// Get the current value of mission command index 
+// No parameters
+static void CLI_mig(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::MIG);
+}
+
+// ===============================================
+// Command mcl: Mission Command List
+// ===============================================
+// return the whole Mission Command list; no parameters needed.
+// No parameters
+static void CLI_mcl(int CommandPort, char* Param[])
+{
+	(*Serials[CommandPort]).print(F("Mission Command List:"));
+	(*Serials[CommandPort]).println();
+	char FloatFormatString[16];
+
+	if (MissionValues.mission_size == 0) {
+		(*Serials[CommandPort]).println(F("Empty."));
 	}
 
-	// ===============================================
-	// Command mcs: Mission Command Set
-	// ===============================================
-	// set a Mission Command
-	// Parameter 1: Mission Sequence Number 
-	// Parameter 2: Mission Command 
-	// Parameter 3: MC Param 1
-	// Parameter 4: MC Param 2
-	// Parameter 5: MC Param 3  
-	// Parameter 6: MC Param 4
-	// Parameter 7: MC Param 5
-	if (!strncmp(cmd, "mcs", 3))
+	// loop through the mission list array
+	for (int i = 0; i < MissionValues.mission_size; i++)
 	{
-		// set the sequence number of the command starting with zero
-		int Mission_cmd_ptr = atoi(param1);
+		(*Serials[CommandPort]).print(i);
+		(*Serials[CommandPort]).print(":");
 
-		// Advance the mission size to encompass the specified position
-		if ((Mission_cmd_ptr + 1) > MissionValues.mission_size) {
-			MissionValues.mission_size = Mission_cmd_ptr + 1;
-		}
-
-		MissionCommandType mc = MissionCommandType(atoi(param2));
-		MissionValues.MissionList[Mission_cmd_ptr].cmd = mc;
+		MissionCommandType mc = MissionValues.MissionList[i].cmd;
 
 		switch (mc)
 		{
 		case ctGotoWaypoint:
-			MissionValues.MissionList[Mission_cmd_ptr].waypoint.lat = atof(param3) * 10000000UL;  //Latitude  * 10**7
-			MissionValues.MissionList[Mission_cmd_ptr].waypoint.lng = atof(param4) * 10000000UL;  //Longitude * 10**7
-			MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(param5);      // metres
-			MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(param6);      // Control Mask
+			(*Serials[CommandPort]).print(F("GotoWaypoint:"));
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(",");
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(F(",Boundary: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
+			(*Serials[CommandPort]).print(F(",Control: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
+			(*Serials[CommandPort]).println();
 			break;
 
 		case ctLoiter:
+			(*Serials[CommandPort]).print(F("Loiter:"));
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(",");
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(F(",Boundary: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
+			(*Serials[CommandPort]).print(F(",Control: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
+			(*Serials[CommandPort]).print(F(",Duration: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
+			(*Serials[CommandPort]).println();
+			break;
+
 		case ctLoiterUntil:
-			MissionValues.MissionList[Mission_cmd_ptr].waypoint.lat = atof(param3) * 10000000UL;  //Latitude  * 10**7
-			MissionValues.MissionList[Mission_cmd_ptr].waypoint.lng = atof(param4) * 10000000UL;  //Longitude * 10**7
-			MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(param5);	   // metres
-			MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(param6);      // Control Mask
-			MissionValues.MissionList[Mission_cmd_ptr].duration = atoi(param7);	   // minutes
+			(*Serials[CommandPort]).print(F("Loiter Until:"));
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(",");
+			(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
+			(*Serials[CommandPort]).print(F(",Boundary: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
+			(*Serials[CommandPort]).print(F(",Control: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
+			(*Serials[CommandPort]).print(F(",Time: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
+			(*Serials[CommandPort]).println();
 			break;
 
 		case ctReturnToHome:
-			MissionValues.MissionList[Mission_cmd_ptr].boundary = atoi(param3);	   // metres
-			MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(param4);      // Control Mask
+			(*Serials[CommandPort]).print(F("ReturnToHome,Boundary: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
+			(*Serials[CommandPort]).print(F(",Control: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
+			(*Serials[CommandPort]).println();
 			break;
 
 		case ctSteerWindCourse:
-			MissionValues.MissionList[Mission_cmd_ptr].SteerAWA = atoi(param3);		// SteerAWA degrees
-			MissionValues.MissionList[Mission_cmd_ptr].TrimTabAngle = atoi(param4);  //TrimTabAngle degrees
-			MissionValues.MissionList[Mission_cmd_ptr].duration = atoi(param5);      // metres
-			MissionValues.MissionList[Mission_cmd_ptr].controlMask = atoi(param6);      // Control Mask
+			(*Serials[CommandPort]).print(F("SteerWindCourse,AWA:"));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].SteerAWA);
+			(*Serials[CommandPort]).print(F(",TrimTabAngle:"));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].TrimTabAngle);
+			(*Serials[CommandPort]).print(F(",Duration: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
+			(*Serials[CommandPort]).print(F(",Control: "));
+			(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
+			(*Serials[CommandPort]).println();
 			break;
 
-		default:;
+		default:
+			(*Serials[CommandPort]).print(F("Unknown command"));
 		}
 	}
+}
 
-	// ===============================================
-	// Command scs: Set Command State
-	// ===============================================
-	// Set the vessel into a specifed command State
-	// Parameter 1: Command State (enumerated Type) 
-		//vcsIdle,					// idle state, feathered settings for sails.
-		//vcsFullManual,				// The vessel is under manual command via RC
-		//vcsPartialManual,				// The vessel is under manual command via RC
-		//vcsFollowMission,		// The vessel is under automatic control following the mission list.
-		//vcsSteerMagneticCourse,	// The vessel is steering a course relative to the compass
-		//vcsSteerWindCourse,		// The vessel is steering a course relative to the wind.
-		//vcsReturnToHome,			// return to the preset home location
-		//vcsSetHome,				// set home location
-		//vcsResetMissionIndex		// Reset the Mission Index, to force a restsart of the mission.		
-		//vcsLoiter				// Loiter here.
-
-	if (!strncmp(cmd, "scs", 3))
-	{
-		StateValues.CommandState = VesselCommandStateType(atoi(param1));
-		// set both steering angles to the command parameter
-		StateValues.SteerCompassBearing = wrap_360_Int(atoi(param2));
-		StateValues.SteerWindAngle = atoi(param2);
-
-		// Only set the TrimTabDefaultAngle if the command is vcsSteerWindCourse, otherwise it will interfere normal mission operation
-		if (StateValues.CommandState == VesselCommandStateType::vcsSteerWindCourse)
-		{
-			Configuration.TrimTabDefaultAngle = atoi(param3);
-			DecisionEventValue2 = Configuration.TrimTabDefaultAngle;
-		}
-
-		// start command timer. Record the start time of each new command	
-		MissionValues.MissionCommandStartTime = millis();
+// ===============================================
+// Command mcp: Mission Command List for Plotting
+// ===============================================
+// return the whole Mission Command list; no parameters needed.
+// No parameters
+static void CLI_mcp(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::MCP);
+}
 
-		// save the state
-		Save_EEPROM_StateValues();
+// ===============================================
+// Command mcc:  Mission Command List - Clear All
+// ===============================================
+// clear the Mission Command List
+// No parameters
+static void CLI_mcc(int CommandPort, char* Param[])
+{
+	// reset all mission values and flags
+	MissionValues.mission_size = 0;
+	StateValues.mission_index = 0;
+	StateValues.StartingMission = true;
+	NavData.next_WP_valid = false;
 
-		DecisionEvent = DecisionEventType::deChangeCommandState;
-		DecisionEventReason = DecisionEventReasonType::rManualIntervention;
-		DecisionEventValue = atoi(param2);
+	//QueueMessage(TelMessageType::MCC); // don't send feedback. its blocking the next message.
+}
 
-		// explictly log the commands to set the steering values for wind or compass.
-		SD_Logging_Event_Decisions();
+// ===============================================
+// Command lcs: Set Current Location, and disable GPS. 
+// i.e. use a simulated GPS. 
+// ===============================================
+// Set Current Location
+// Parameter 1: simulated Lat 
+// Parameter 2: simulated Lon 
+static void CLI_lcs(int CommandPort, char* Param[])
+{
+	UseSimulatedVessel = true;
 
-		// print the command state
-		QueueMessage(TelMessageType::SCS);
-	}
+	simulated_vessel.Currentloc.lat = atof(Param[1]) * 10000000UL;  //Latitude  * 10**7
+	simulated_vessel.Currentloc.lng = atof(Param[2]) * 10000000UL;  //Longitude * 10**7
+	simulated_vessel.Heading = atoi(Param[3]);
+}
 
-	// ===============================================
-	// Command scg: Get Command State
-	// ===============================================
-	// get the current Command State.
-	if (!strncmp(cmd, "scg", 3))
+// ===============================================
+// Command ssw: Set Simulated Wind
+// i.e. use with simulated location. 
+// ===============================================
+// Set Current Location
+// Parameter 1: simulated wind direction  
+// Parameter 2 (optional): simulated mean wind speed, knots
+static void CLI_ssw(int CommandPort, char* Param[])
+{
+	simulated_weather.MajorWindDirection = atoi(Param[1]);
+	if (*Param[2])
 	{
-		QueueMessage(TelMessageType::SCG);
+		simulated_weather.BaseWindSpeed = atof(Param[2]);
 	}
+}
 
-	// ===============================================
-	// Command mis: Mission Command Index Set
-	// ===============================================
-	// Set the index to the one less the desired step. i.e. set to zero to commence with step 1.
-	// This is usually 0 to start the mission
-	// Parameter 1: Mission Sequence Number  
-	if (!strncmp(cmd, "mis", 3))
+// ===============================================
+// Command lrp: Log RePlay
+// Replay a log file from the SD card through the sailing navigation, and compare the recomputed
+// CTS, CourseType and decisions with those logged. Use ashore; the navigation is suspended while replaying.
+// Refused unless the vessel is idle (vcsIdle), as the steering and the other tasks wait until the replay is finished.
+// ===============================================
+// Parameter 1: log file name without the .log extension, i.e. <boot number><minute number> as in 01200345
+// returns: lrp,seconds,updates,CTS mismatches,max CTS error,CourseType mismatches,logged DEC,replayed DEC,
+//	DEC matches,DEC mismatches,ms. A match is a replayed decision with the type and reason of a logged one.
+static void CLI_lrp(int CommandPort, char* Param[])
+{
+	if (StateValues.CommandState != vcsIdle)
 	{
-		StateValues.mission_index = atoi(param1);
-
-		// save the state
-		Save_EEPROM_StateValues();
-
-		// since we are forcing a change in the mission index, then force a restart at that index.
-		StateValues.StartingMission = true;
-		NavData.next_WP_valid = false;
-
-		// update next WP for display purposes.
-		set_next_WP_for_display();
+		(*Serials[CommandPort]).println(F("lrp,vessel not idle"));
+		return;
 	}
 
-	// ===============================================
-	// Command mig: Mission Command Index Get
-	// ===============================================
-	// Get the current value of mission command index 
-	// No parameters
-	if (!strncmp(cmd, "mig", 3))
+	LogReplayResultType result;
+	char ReplayFileName[16];
+	snprintf(ReplayFileName, sizeof(ReplayFileName), "%s.log", Param[1]);
+
+	if (LogReplay(ReplayFileName, result))
 	{
-		QueueMessage(TelMessageType::MIG);
+		(*Serials[CommandPort]).print(F("lrp,"));
+		(*Serials[CommandPort]).print(result.Seconds);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.Updates);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.CTSMismatches);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.MaxCTSError);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.CourseTypeMismatches);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.LoggedDecisions);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.ReplayDecisions);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.DecisionMatches);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).print(result.DecisionMismatches);
+		(*Serials[CommandPort]).print(F(","));
+		(*Serials[CommandPort]).println(result.Duration_ms);
+
+		char message[64];
+		FormatText(message, sizeof(message), "Replay %s CTS mismatches %lu/%lu", ReplayFileName, result.CTSMismatches, result.Updates);
+		SD_Logging_Event_Messsage(message);
 	}
-
-	// ===============================================
-	// Command mcl: Mission Command List
-	// ===============================================
-	// return the whole Mission Command list; no parameters needed.
-	// No parameters
-	if (!strncmp(cmd, "mcl", 3))
+	else
 	{
-		(*Serials[CommandPort]).print(F("Mission Command List:"));
-		(*Serials[CommandPort]).println();
-		char FloatFormatString[16];
+		(*Serials[CommandPort]).println(F("lrp,file not found"));
+	}
+}
 
-		if (MissionValues.mission_size == 0) {
-			(*Serials[CommandPort]).println(F("Empty."));
-		}
+// ===============================================
+// Command lbd: Log Binary Decode
+// List a binary log file from the SD card as delimited text, one line per second, on the command port.
+// The file is listed a range of records at a time. If there are more records, the range ends with lbd,next,<record>.
+// The range is decoded in the CLI task, so it is only available when the vessel is idle. 
+// A record is about 150 characters, so the default range takes about 300 ms at 9600 baud.
+// ===============================================
+// Parameter 1: log file name without the .bin extension, i.e. <boot number><minute number> as in 01200345
+// Parameter 2: first record. Omit to start at the beginning, with the column names.
+// Parameter 3: number of records. Omit for 2.
+static const unsigned long LbdDefaultRecords = 2;
 
-		// loop through the mission list array
-		for (int i = 0; i < MissionValues.mission_size; i++)
-		{
-			(*Serials[CommandPort]).print(i);
-			(*Serials[CommandPort]).print(":");
+static void CLI_lbd(int CommandPort, char* Param[])
+{
+	if (StateValues.CommandState != vcsIdle)
+	{
+		(*Serials[CommandPort]).println(F("lbd,vessel not idle"));
+		return;
+	}
 
-			MissionCommandType mc = MissionValues.MissionList[i].cmd;
+	char BinaryFileName[16];
+	snprintf(BinaryFileName, sizeof(BinaryFileName), "%s.bin", Param[1]);
 
-			switch (mc)
-			{
-			case ctGotoWaypoint:
-				(*Serials[CommandPort]).print(F("GotoWaypoint:"));
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(",");
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(F(",Boundary: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
-				(*Serials[CommandPort]).print(F(",Control: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
-				(*Serials[CommandPort]).println();
-				break;
-
-			case ctLoiter:
-				(*Serials[CommandPort]).print(F("Loiter:"));
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(",");
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(F(",Boundary: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
-				(*Serials[CommandPort]).print(F(",Control: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
-				(*Serials[CommandPort]).print(F(",Duration: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
-				(*Serials[CommandPort]).println();
-				break;
-
-			case ctLoiterUntil:
-				(*Serials[CommandPort]).print(F("Loiter Until:"));
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lat) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(",");
-				(*Serials[CommandPort]).print(dtostrf(float(MissionValues.MissionList[i].waypoint.lng) / 10000000UL, 10, 5, FloatFormatString));
-				(*Serials[CommandPort]).print(F(",Boundary: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
-				(*Serials[CommandPort]).print(F(",Control: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
-				(*Serials[CommandPort]).print(F(",Time: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
-				(*Serials[CommandPort]).println();
-				break;
-
-			case ctReturnToHome:
-				(*Serials[CommandPort]).print(F("ReturnToHome,Boundary: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].boundary);
-				(*Serials[CommandPort]).print(F(",Control: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
-				(*Serials[CommandPort]).println();
-				break;
-
-			case ctSteerWindCourse:
-				(*Serials[CommandPort]).print(F("SteerWindCourse,AWA:"));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].SteerAWA);
-				(*Serials[CommandPort]).print(F(",TrimTabAngle:"));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].TrimTabAngle);
-				(*Serials[CommandPort]).print(F(",Duration: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].duration);
-				(*Serials[CommandPort]).print(F(",Control: "));
-				(*Serials[CommandPort]).print(MissionValues.MissionList[i].controlMask);
-				(*Serials[CommandPort]).println();
-				break;
-
-			default:
-				(*Serials[CommandPort]).print(F("Unknown command"));
-			}
-		}
-	}
+	unsigned long first = *Param[2] ? strtoul(Param[2], NULL, 10) : 0;
+	unsigned long count = *Param[3] ? strtoul(Param[3], NULL, 10) : LbdDefaultRecords;
+	unsigned long next;
 
-	// ===============================================
-	// Command mcp: Mission Command List for Plotting
-	// ===============================================
-	// return the whole Mission Command list; no parameters needed.
-	// No parameters
-	if (!strncmp(cmd, "mcp", 3))
+	if (!SD_Logging_DecodeBinary(BinaryFileName, *Serials[CommandPort], first, count, next))
 	{
-		QueueMessage(TelMessageType::MCP);
+		(*Serials[CommandPort]).println(F("lbd,file not found"));
 	}
-
-	// ===============================================
-	// Command mcc:  Mission Command List - Clear All
-	// ===============================================
-	// clear the Mission Command List
-	// No parameters
-	if (!strncmp(cmd, "mcc", 3))
+	else if (next)
 	{
-		// reset all mission values and flags
-		MissionValues.mission_size = 0;
-		StateValues.mission_index = 0;
-		StateValues.StartingMission = true;
-		NavData.next_WP_valid = false;
-
-		//QueueMessage(TelMessageType::MCC); // don't send feedback. its blocking the next message.
+		(*Serials[CommandPort]).print(F("lbd,next,"));
+		(*Serials[CommandPort]).println(next);
 	}
+}
 
-	// ===============================================
-	// Command lcs: Set Current Location, and disable GPS. 
-	// i.e. use a simulated GPS. 
-	// ===============================================
-	// Set Current Location
-	// Parameter 1: simulated Lat 
-	// Parameter 2: simulated Lon 
-	if (!strncmp(cmd, "lcs", 3))
+// ===============================================
+// Command srs: Set Random Seed
+// Restart the simulated weather and vessel random numbers from the seed, so that the wind and vessel of a simulated run can be repeated.
+// The seed is written to the log as a Seed header line.
+// A batch (mcr) started after this uses the seed for its first run, and seed+1, seed+2 ... for the following runs.
+// ===============================================
+// Parameter 1: seed. Omit to report the current seed.
+static void CLI_srs(int CommandPort, char* Param[])
+{
+	if (*Param[1])
 	{
-		UseSimulatedVessel = true;
-
-		simulated_vessel.Currentloc.lat = atof(param1) * 10000000UL;  //Latitude  * 10**7
-		simulated_vessel.Currentloc.lng = atof(param2) * 10000000UL;  //Longitude * 10**7
-		simulated_vessel.Heading = atoi(param3);
+		SetSimulationSeed(strtoul(Param[1], NULL, 10));
+		LogSeedHeader();
 	}
 
+	(*Serials[CommandPort]).print(F("srs,"));
+	(*Serials[CommandPort]).println(SimulationSeed);
+}
 
-	// ===============================================
-	// Command ssw: Set Simulated Wind
-	// i.e. use with simulated location. 
-	// ===============================================
-	// Set Current Location
-	// Parameter 1: simulated wind direction  
-	if (!strncmp(cmd, "ssw", 3))
+// ===============================================
+// Command sms: Set Simulation Speed
+// i.e. run the navigation, mission and simulated vessel faster than real time. 
+// Only available with a simulated location (lcs).
+// ===============================================
+// Parameter 1: speed as a multiple of real time, 1 to 20. 
+static void CLI_sms(int CommandPort, char* Param[])
+{
+	if (UseSimulatedVessel)
 	{
-		simulated_weather.MajorWindDirection = atoi(param1);
+		SetSimulationSpeed(constrain(atoi(Param[1]), 1, MaxSimulationSpeed));
+
+		char message[24];
+		FormatText(message, sizeof(message), "Simulation Speed %d", GetSimulationSpeed());
+		SD_Logging_Event_Messsage(message);
 	}
+}
 
+// ===============================================
+// Command spb: Simulated Polar Benchmark
+// Time the polar table lookup, and compare with the time taken by the last simulated vessel update.
+// ===============================================
+// No parameters
+// returns: spb,lookups,total us,ns per lookup,last update us
+static void CLI_spb(int CommandPort, char* Param[])
+{
+	const int Lookups = 1000;
+	volatile float speed = 0; // prevent the loop being optimised away
 
-	// ===============================================
-	// Command HLS, Set Home Location
-	// ===============================================
-	// Parameter 1: Range from current location - metres
-	// Parameter 2: True Bearing from current location - degrees
-	// 
-	if (!strncmp(cmd, "hls", 3))
+	unsigned long start_us = micros();
+	for (int i = 0; i < Lookups; i++)
 	{
-		// get the current location 
-		StateValues.home = NavData.Currentloc;
-
-		float distance = atof(param1); // metres
-		float bearing = atof(param2);  // degrees
-
-		location_update(StateValues.home, bearing, distance);
-		StateValues.home_is_set = true;
-
-		// save the state
-		Save_EEPROM_StateValues();
-
-		SD_Logging_Event_Messsage(F("Set Home"));
-
-		QueueMessage(TelMessageType::HLG);
+		speed += simulated_vessel.vpp(i % 181, i % 26);
 	}
+	unsigned long elapsed_us = micros() - start_us;
 
-	// ===============================================
-	// Command HLG, Get Home Location
-	// ===============================================
-	// No parameters
-	if (!strncmp(cmd, "hlg", 3))
-	{
-		QueueMessage(TelMessageType::HLG);
-	}
+	(*Serials[CommandPort]).print(F("spb,"));
+	(*Serials[CommandPort]).print(Lookups);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(elapsed_us);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(elapsed_us * 1000UL / Lookups);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(simulated_vessel.update_duration_us);
+	(*Serials[CommandPort]).println();
+}
 
-	// ===============================================
-	// Command HLC, Clear Home Location
-	// ===============================================
-	// No parameters
-	if (!strncmp(cmd, "hlc", 3))
+// ===============================================
+// Command mcr: simulated Mission batch Runs
+// i.e. repeat the current mission from the current simulated location, each run with a different wind. 
+// Only available with a simulated location (lcs).
+// ===============================================
+// Parameter 1 (optional): number of runs to start, or 0 to stop. 
+// With no parameter, report the distribution of the results so far.
+static void CLI_mcr(int CommandPort, char* Param[])
+{
+	if (*Param[1] == 0)
 	{
-		// Clear the flag
-		StateValues.home_is_set = false;
-
-		SD_Logging_Event_Messsage(F("Clear Home"));
-
-		char MsgString[16];
-
-		(*Serials[CommandPort]).print("hom:");
-		(*Serials[CommandPort]).print(dtostrf(float(StateValues.home.lat) / 10000000UL, 10, 5, MsgString));
-		(*Serials[CommandPort]).print(",");
-		(*Serials[CommandPort]).print(dtostrf(float(StateValues.home.lng) / 10000000UL, 10, 5, MsgString));
-		(*Serials[CommandPort]).print(",");
-		StateValues.home_is_set ? (*Serials[CommandPort]).print("Set:true") : (*Serials[CommandPort]).print("Set:false");
-		(*Serials[CommandPort]).println();
+		QueueMessage(TelMessageType::MCR);
 	}
-
-	// ===============================================
-	// Command ver, Get Software Version
-	// ===============================================
-	// No parameters
-	if (!strncmp(cmd, "ver", 3))
+	else if (atoi(Param[1]) == 0)
 	{
-		QueueMessage(TelMessageType::VER);
+		simulated_batch.stop();
 	}
-
-	// ===============================================
-	// Command TMG, Get Current Time
-	// ===============================================
-	// No parameters
-	if (!strncmp(cmd, "tmg", 3))
+	else if (UseSimulatedVessel)
 	{
-		QueueMessage(TelMessageType::TMG);
+		simulated_batch.start(atoi(Param[1]));
 	}
+}
 
-	// ===============================================
-	// Command lcd, Set LCD Logging Level.
-	// ===============================================
-	// Parameter 1: Logging Level: 0,1,2,3
-	// 
-	if (!strncmp(cmd, "lcd", 3))
-	{
-		Configuration.DisplayScreenView = *param1;
-	
-		if (Configuration.DisplayScreenView == 'W')
-		{
-			CheckWingSailPower();
-		}
+// ===============================================
+// Command HLS, Set Home Location
+// ===============================================
+// Parameter 1: Range from current location - metres
+// Parameter 2: True Bearing from current location - degrees
+// 
+static void CLI_hls(int CommandPort, char* Param[])
+{
+	// get the current location 
+	StateValues.home = NavData.Currentloc;
 
-		QueueMessage(TelMessageType::LCD);
-	}
+	float distance = atof(Param[1]); // metres
+	float bearing = atof(Param[2]);  // degrees
 
-	// ===============================================
-	// Command rst, Restore Config back to default at next power up
-	// ===============================================
-	// No Parameter
-	// 
-	if (!strncmp(cmd, "rst", 3))
-	{
-		Configuration.EEPROM_Storage_Version--; // force the config ID to be invalid, then save it.
+	location_update(StateValues.home, bearing, distance);
+	StateValues.home_is_set = true;
 
-		// save the Calibration values, using the save procedure without restoring the config version number
-		Save_EEPROM_ConfigValues_LeaveVersion();
+	// save the state
+	Save_EEPROM_StateValues();
 
-		// .......
+	SD_Logging_Event_Messsage(F("Set Home"));
 
-		// Then on next power up the config should revert to the default values
-	}
+	QueueMessage(TelMessageType::HLG);
+}
 
-	// ===============================================
-	// Command sat: initiate a simulated Sat Com Vessel message. 
-	// i.e. it stores the simulated message on the SD Card
-	// ===============================================
-	if (!strncmp(cmd, "stv", 3))
-	{
-		// SatComm.sendSatComVesselState();
-	}
+// ===============================================
+// Command HLG, Get Home Location
+// ===============================================
+// No parameters
+static void CLI_hlg(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::HLG);
+}
 
-	// ===============================================
-	// Command sat: initiate a simulated Sat Com Mission Step message. 
-	// i.e. it stores the simulated message on the SD Card
-	// ===============================================
-	if (!strncmp(cmd, "stm", 3))
-	{
-		// SatComm.sendSatComMissionEvent(StateValues.mission_index);
-	}
+// ===============================================
+// Command HLC, Clear Home Location
+// ===============================================
+// No parameters
+static void CLI_hlc(int CommandPort, char* Param[])
+{
+	// Clear the flag
+	StateValues.home_is_set = false;
 
-	// ===============================================
-	// Command eqg, Get Equipment Status
-	// ===============================================
-	//  No parameters
-	// 
-	// Return the status of the Wing Angle Sensor, SD Card.
+	SD_Logging_Event_Messsage(F("Clear Home"));
 
-	if (!strncmp(cmd, "eqg", 3))
-	{
-		QueueMessage(TelMessageType::EQG);
-	}
+	char MsgString[16];
 
-	// ===============================================
-	// Command cal,  Compass calibration y/n
-	// ===============================================
-	//  1 parameter: y/n
-	// 
-	if (!strncmp(cmd, "cal", 3))
-	{
-		switch (*param1)
-		{
-		case 'y':
-			(*Serials[CommandPort]).print(F("Compass Calibrate-Yes"));
-			imu.compass.CalibrateMode = true;
-			break;
+	(*Serials[CommandPort]).print("hom:");
+	(*Serials[CommandPort]).print(dtostrf(float(StateValues.home.lat) / 10000000UL, 10, 5, MsgString));
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(dtostrf(float(StateValues.home.lng) / 10000000UL, 10, 5, MsgString));
+	(*Serials[CommandPort]).print(",");
+	StateValues.home_is_set ? (*Serials[CommandPort]).print("Set:true") : (*Serials[CommandPort]).print("Set:false");
+	(*Serials[CommandPort]).println();
+}
 
-		case 'n':
-			(*Serials[CommandPort]).print(F("Compass Calibrate-No"));
-			imu.compass.CalibrateMode = false;
-			break;
-		}
-	}
+// ===============================================
+// Command ver, Get Software Version
+// ===============================================
+// No parameters
+static void CLI_ver(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::VER);
+}
 
-	// ===============================================
-	// Command ccs,  Compass calibration Save
-	// ===============================================
-	//  No parameters
-	// 
-	if (!strncmp(cmd, "ccs", 3))
-	{
-		QueueMessage(TelMessageType::CCS);
+// ===============================================
+// Command TMG, Get Current Time
+// ===============================================
+// No parameters
+static void CLI_tmg(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::TMG);
+}
 
-		//		IMU_Save_Cal();
-	}
+// ===============================================
+// Command tpl, Task Profile List
+// ===============================================
+// No parameters
+// list the execution time profile of each scheduler task.
+static void CLI_tpl(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::TPL);
+}
 
-	// ===============================================
-	// Command ccg,  Compass calibration Get Status
-	// ===============================================
-	//  No parameters
-	// 
-	if (!strncmp(cmd, "ccg", 3))
-	{
-		QueueMessage(TelMessageType::CCG);
-	}
+// ===============================================
+// Command tpc, Task Profile Clear
+// ===============================================
+// No parameters
+// clear the execution time profile of each scheduler task, to start a new measurement.
+static void CLI_tpc(int CommandPort, char* Param[])
+{
+	SchedulerResetProfile();
+	SD_Logging_Event_Messsage(F("Task Profile Cleared"));
+}
 
-	// ===============================================
-	// Command wc1,  Wingsail Angle Sensor calibration ON
-	// ===============================================
-	//  No parameters
-	// 
-	if (!strncmp(cmd, "wc1", 3))
+// ===============================================
+// Command idl, Scheduler Idle Mode
+// ===============================================
+// Parameter 1 (optional): 1 = idle mode on, 0 = idle mode off, c = clear the current comparison.
+// With no parameter, just report the idle mode and the mean current in each mode.
+static void CLI_idl(int CommandPort, char* Param[])
+{
+	switch (*Param[1])
 	{
-		QueueMessage(TelMessageType::WC1);
-
-		// enable calibration mode. Fast reads and maintain enable setting of the min/max calibration values
-		WingAngleSensor.WingSailAngleSensorPort.WingSailAngleSensor->MagneticCompassCalibrationMode = true;
+	case '0':
+		SchedulerSetIdle(false);
+		SD_Logging_Event_Messsage(F("Idle Off"));
+		break;
 
+	case '1':
+		SchedulerSetIdle(true);
+		SD_Logging_Event_Messsage(F("Idle On"));
+		break;
 
-		Configuration.WingAngle_mXScale = 0;
-		Configuration.WingAngle_mYScale = 0;
+	case 'c':
+		PowerSensor.ResetIdleCurrent();
+		break;
 
-		// init the Calibration limits
-		WingAngleSensor.WingSailAngleSensorPort.IMU_Mag_Init();
+	default:;
 	}
 
-	// ===============================================
-	// Command wc0,  Wingsail Angle Sensor calibration OFF
-	// ===============================================
-	//  No parameters
-	// 
-	if (!strncmp(cmd, "wc0", 3))
-	{
-		QueueMessage(TelMessageType::WC0);
+	QueueMessage(TelMessageType::IDL);
+}
 
-		// disable calibation mode
-		WingAngleSensor.WingSailAngleSensorPort.WingSailAngleSensor->MagneticCompassCalibrationMode = false;
+// ===============================================
+// Command lcd, Set LCD Logging Level.
+// ===============================================
+// Parameter 1: Logging Level: 0,1,2,3
+// 
+static void CLI_lcd(int CommandPort, char* Param[])
+{
+	Configuration.DisplayScreenView = *Param[1];
 
-		// save the Calibration values
-		Save_EEPROM_ConfigValues();
+	if (Configuration.DisplayScreenView == 'W')
+	{
+		CheckWingSailPower();
 	}
 
+	QueueMessage(TelMessageType::LCD);
+}
 
-	// ===============================================
-	// Command sav, Save Data to EEPROM
-	// ===============================================
-	//  Parameter 1: Entity to be saved: m-Mission, c-Config, s-State , y-Save State-On, n-Save-State-Off
-	// 
-	if (!strncmp(cmd, "sav", 3))
-	{
-		(*Serials[CommandPort]).print(F("SAV, Save to EEPROM: "));
-
-		switch (*param1)
-		{
-		case 'm':
-			(*Serials[CommandPort]).print(F("Mission"));
-			Save_EEPROM_Mission();
-			break;
+// ===============================================
+// Command rst, Restore Config back to default at next power up
+// ===============================================
+// No Parameter
+// 
+static void CLI_rst(int CommandPort, char* Param[])
+{
+	Configuration.EEPROM_Storage_Version--; // force the config ID to be invalid, then save it.
 
-		case 'c':
-			(*Serials[CommandPort]).print(F("Configuration"));
-			Save_EEPROM_ConfigValues();
-			break;
+	// save the Calibration values, using the save procedure without restoring the config version number
+	Save_EEPROM_ConfigValues_LeaveVersion();
 
-		case 's':
-			(*Serials[CommandPort]).print(F("State"));
-			Save_EEPROM_StateValues();
-			break;
+	// .......
 
-		case 'y':
-			(*Serials[CommandPort]).print(F("Save State-Yes"));
-			Configuration.SaveStateValues = true;
-			break;
+	// Then on next power up the config should revert to the default values
+}
 
-		case 'n':
-			(*Serials[CommandPort]).print(F("Save State-No"));
-			Configuration.SaveStateValues = false;
-			break;
+// ===============================================
+// Command sat: initiate a simulated Sat Com Vessel message. 
+// i.e. it stores the simulated message on the SD Card
+// ===============================================
+static void CLI_stv(int CommandPort, char* Param[])
+{
+	// SatComm.sendSatComVesselState();
+}
 
-		default:
-			(*Serials[CommandPort]).print(F("unknown"));
-		}
-		(*Serials[CommandPort]).println();
-	}
+// ===============================================
+// Command sat: initiate a simulated Sat Com Mission Step message. 
+// i.e. it stores the simulated message on the SD Card
+// ===============================================
+static void CLI_stm(int CommandPort, char* Param[])
+{
+	// SatComm.sendSatComMissionEvent(StateValues.mission_index);
+}
 
-	// ===============================================
-	// 	Command dsp, Display messages on LCD/OLED
-	// ===============================================
-	// Paramters: Line1, Line2
-	// 
-	//if (!strncmp(cmd, "dsp", 3))
-	//{
-	//	strcpy(MessageDisplayLine1, param1);
-	//	strcpy(MessageDisplayLine2, param2);
-	//}
-
-	//// ===============================================
-	//// 	Command gps, set GPS Power Mode
-	//// ===============================================
-	//// Paramters: Line1, Line2
-	//// 
-	//if (!strncmp(cmd, "gps", 3))
-	//{
-	//	Configuration.GPS_PowerMode = (GPS_PowerModeType)atoi(param1);
-	//}
-
-	// ===============================================
-	// 	prl, Parameter List   
-	// ===============================================
-	// Parameters: none.
-	// this initiates listing all parameters
-	if (!strncmp(cmd, "prl", 3))
-	{
-		QueueMessage(TelMessageType::PRL);
-	}
+// ===============================================
+// Command eqg, Get Equipment Status
+// ===============================================
+//  No parameters
+// 
+// Return the status of the Wing Angle Sensor, SD Card.
+static void CLI_eqg(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::EQG);
+}
 
-	// ===============================================
-// 	prm, Max Parameter Number 
 // ===============================================
-// Parameters: none.
-// this initiates listing all parameters
-	if (!strncmp(cmd, "prm", 3))
+// Command cal,  Compass calibration y/n
+// ===============================================
+//  1 parameter: y/n
+// 
+static void CLI_cal(int CommandPort, char* Param[])
+{
+	switch (*Param[1])
 	{
-		QueueMessage(TelMessageType::PRM);
-	}
+	case 'y':
+		(*Serials[CommandPort]).print(F("Compass Calibrate-Yes"));
+		imu.compass.CalibrateMode = true;
+		break;
 
-	// ===============================================
-	// 	prg, Parameter Get   
-	// ===============================================
-	// Parameters: Parameter Index Number
-	// 
-	if (!strncmp(cmd, "prg", 3))
-	{
-		LastParameterIndex = atoi(param1); // set a global variable (sorry for that) with the single parameter number to be used next.
-		QueueMessage(TelMessageType::PRG);
+	case 'n':
+		(*Serials[CommandPort]).print(F("Compass Calibrate-No"));
+		imu.compass.CalibrateMode = false;
+		break;
 	}
+}
 
-	// ===============================================
-	// 	prs, Parameter Set   
-	// ===============================================
-	// Parameters: Parameter Index Number, Parameter Value
-	// 
-	if (!strncmp(cmd, "prs", 3))
-	{
-		LastParameterIndex = atoi(param1);
-		QueueMessage(TelMessageType::PRG);
-
-		// log the change to the SD Card.
-		SD_Logging_Event_ParameterChange(LastParameterIndex, param2);
-
-		switch (LastParameterIndex)
-		{
-		case 1:
-			Configuration.CompassOffsetAngle = atof(param2);
-			break;
-
-		case 2:
-			Configuration.TrimTabOffset = atoi(param2);
-			break;
-
-		case 3:
-			Configuration.TrimTabScale = atoi(param2);
-			break;
-
-		case 4:
-			Configuration.TrimTabDefaultAngle = atoi(param2);
-			break;
-
-		case 5:
-			Configuration.SailableAngleMargin = atoi(param2);
-			break;
-
-		case 6:
-			Configuration.LoiterRadius = atol(param2);
-			break;
-
-		case 7:
-			Configuration.timezone_offset = atoi(param2);
-			break;
-
-		case 8:
-			Configuration.DisplayScreenView = *param2;
-			break;
-
-		case 9:
-			// temporary test code to investigate init strings for the NEO-8M GPS.
-			//GPSInitMessageNumber = atoi(param2);
-			//gps.SendConfigurationString(GPSInitMessageNumber);
-			break;
-
-		case 10:
-			//Configuration.UseGPSInitString = atoi(param2);
-			break;
-
-		case 11:
-			Configuration.SaveStateValues = atoi(param2);
-			break;
-
-		case 12:
-			Configuration.MinimumAngleUpWind = atoi(param2);
-			break;
-
-		case 13:
-			Configuration.MinimumAngleDownWind = atoi(param2);
-			break;
-
-		case 14:
-			Configuration.WindAngleCalibrationOffset = atoi(param2);
-			break;
-
-		case 15:
-			Configuration.WPCourseHoldRadius = atoi(param2);
-			break;
-
-		case 16:
-			if (!strncmp(param2, "t", 1)) { Configuration.SDCardLogDelimiter = '\t'; }
-			if (!strncmp(param2, ",", 1)) { Configuration.SDCardLogDelimiter = ','; }
-			break;
-
-		case 17:
-			Configuration.RTHTimeManualControl = atoi(param2);
-			break;
-
-		case 18:
-			Configuration.TWD_Offset = atoi(param2);
-			break;
-
-		case 19:
-			Configuration.TargetHeadingFilterConstant = atof(param2);
-			break;
-
-		case 20:
-			Configuration.MaxFileSize = atoi(param2);
-			break;
-
-		case 21:
-			Configuration.MagnetVariation = atof(param2);
-			break;
-
-		case 22:
-			Configuration.LoRaPort = atoi(param2);
-			break;
-
-		case 23:
-			Configuration.SatCommsPort = atoi(param2);
-			break;
-
-		case 24:
-			Configuration.LoRaPortBaudRate = atol(param2);
-			break;
-
-		case 25:
-			Configuration.SatCommsPortBaudRate = atol(param2);
-			break;
-
-		case 26:
-			break;
-
-		case 27:
-			break;
-
-		case 28:
-			break;
-
-		case 29:
-			Configuration.Servo_Channel_Steering = atoi(param2);
-			break;
-
-		case 30:
-			Configuration.Servo_Channel_Steering_Stbd = atoi(param2);
-			break;
-
-		case 31:
-			Configuration.SteeringDeadBand = atoi(param2);
-			break;
-
-		case 32:
-			Configuration.Servo_Channel_Motor = atoi(param2);
-			break;
-
-		case 33:
-			Configuration.UseMotor = atoi(param2);
-			break;
-
-		case 34:
-			Configuration.DualRudder = atoi(param2);
-			break;
-
-		case 35:
-			Configuration.SteeringFilterConstant = atof(param2);
-			SteeringPID_Init(); // update filter immediately
-			break;
-
-		case 36:
-			Configuration.pidDirection = atoi(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+// ===============================================
+// Command ccs,  Compass calibration Save
+// ===============================================
+//  No parameters
+// 
+static void CLI_ccs(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::CCS);
 
-		case 37:
-			Configuration.pidKp = atol(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+	//		IMU_Save_Cal();
+}
 
-		case 38:
-			Configuration.pidKi = atol(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+// ===============================================
+// Command ccg,  Compass calibration Get Status
+// ===============================================
+//  No parameters
+// 
+static void CLI_ccg(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::CCG);
+}
 
-		case 39:
-			Configuration.pidKd = atol(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+// ===============================================
+// Command wc1,  Wingsail Angle Sensor calibration ON
+// ===============================================
+//  No parameters
+// 
+static void CLI_wc1(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::WC1);
 
-		case 40:
-			Configuration.pidOutputmin = atol(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+	// enable calibration mode. Fast reads and maintain enable setting of the min/max calibration values
+	WingAngleSensor.WingSailAngleSensorPort.WingSailAngleSensor->MagneticCompassCalibrationMode = true;
 
-		case 41:
-			Configuration.pidOutputmax = atol(param2);
-			SteeringPID_Init(); // update PID immediately
-			break;
+	Configuration.WingAngle_mXScale = 0;
+	Configuration.WingAngle_mYScale = 0;
 
-		case 42:
-			Configuration.pidCentre = atol(param2);
-			break;
+	// init the Calibration limits
+	WingAngleSensor.WingSailAngleSensorPort.IMU_Mag_Init();
+}
 
+// ===============================================
+// Command wc0,  Wingsail Angle Sensor calibration OFF
+// ===============================================
+//  No parameters
+// 
+static void CLI_wc0(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::WC0);
 
-		case 43:
-			Configuration.WingAngleError000 = atoi(param2);
-			break;
+	// disable calibation mode
+	WingAngleSensor.WingSailAngleSensorPort.WingSailAngleSensor->MagneticCompassCalibrationMode = false;
 
-		case 44:
-			Configuration.WingAngleError090 = atoi(param2);
-			break;
+	// save the Calibration values
+	Save_EEPROM_ConfigValues();
+}
 
-		case 45:
-			Configuration.WingAngleError180 = atoi(param2);
-			break;
+// ===============================================
+// Command sav, Save Data to EEPROM
+// ===============================================
+//  Parameter 1: Entity to be saved: m-Mission, c-Config, s-State , y-Save State-On, n-Save-State-Off
+// 
+static void CLI_sav(int CommandPort, char* Param[])
+{
+	(*Serials[CommandPort]).print(F("SAV, Save to EEPROM: "));
 
-		case 46:
-			Configuration.WingAngleError270 = atoi(param2);
-			break;
+	switch (*Param[1])
+	{
+	case 'm':
+		(*Serials[CommandPort]).print(F("Mission"));
+		Save_EEPROM_Mission();
+		break;
 
-		case 47:
-			Configuration.WingAngle_mXScale = atoi(param2);
-			break;
+	case 'c':
+		(*Serials[CommandPort]).print(F("Configuration"));
+		Save_EEPROM_ConfigValues();
+		break;
 
-		case 48:
-			Configuration.WingAngle_mYScale = atoi(param2);
-			break;
+	case 's':
+		(*Serials[CommandPort]).print(F("State"));
+		Save_EEPROM_StateValues();
+		break;
 
-		case 49:
-			Configuration.CompassError000 = atoi(param2);
-			break;
+	case 'y':
+		(*Serials[CommandPort]).print(F("Save State-Yes"));
+		Configuration.SaveStateValues = true;
+		break;
 
-		case 50:
-			Configuration.CompassError090 = atoi(param2);
-			break;
+	case 'n':
+		(*Serials[CommandPort]).print(F("Save State-No"));
+		Configuration.SaveStateValues = false;
+		break;
 
-		case 51:
-			Configuration.CompassError180 = atoi(param2);
-			break;
+	default:
+		(*Serials[CommandPort]).print(F("unknown"));
+	}
+	(*Serials[CommandPort]).println();
+}
 
-		case 52:
-			Configuration.CompassError270 = atoi(param2);
-			break;
+// ===============================================
+// 	Command dsp, Display messages on LCD/OLED
+// ===============================================
+// Paramters: Line1, Line2
+// 
+//if (!strncmp(cmd, "dsp", 3))
+//{
+//	strcpy(MessageDisplayLine1, param1);
+//	strcpy(MessageDisplayLine2, param2);
+//}
+
+//// ===============================================
+//// 	Command gps, set GPS Power Mode
+//// ===============================================
+//// Paramters: Line1, Line2
+//// 
+//if (!strncmp(cmd, "gps", 3))
+//{
+//	Configuration.GPS_PowerMode = (GPS_PowerModeType)atoi(param1);
+//}
 
-		case 53:
-			//Configuration.DTB_Threshold = atoi(param2);
-			break;
+// ===============================================
+// 	prl, Parameter List   
+// ===============================================
+// Parameters: none.
+// this initiates listing all parameters
+static void CLI_prl(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::PRL);
+}
 
-		case 54:
-			//Configuration.GPS_Max_Sleep_Time = atoi(param2);
-			break;
+// ===============================================
+// 	prm, Max Parameter Number 
+// ===============================================
+// Parameters: none.
+// this initiates listing all parameters
+static void CLI_prm(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::PRM);
+}
 
-		case 55:
-			//Configuration.GPS_Min_Wake_Time = atoi(param2);
-			break;
+// ===============================================
+// 	prg, Parameter Get   
+// ===============================================
+// Parameters: Parameter Index Number
+// 
+static void CLI_prg(int CommandPort, char* Param[])
+{
+	LastParameterIndex = atoi(Param[1]); // set a global variable (sorry for that) with the single parameter number to be used next.
+	QueueMessage(TelMessageType::PRG);
+}
 
-		default:;
-		}
+// ===============================================
+// 	prs, Parameter Set   
+// ===============================================
+// Parameters: Parameter Index Number, Parameter Value
+// 
+static void CLI_prs(int CommandPort, char* Param[])
+{
+	LastParameterIndex = atoi(Param[1]);
+	QueueMessage(TelMessageType::PRG);
 
+	// the reply shows the value unchanged if the parameter number or value is not valid.
+	// only a change that was made is logged to the SD Card.
+	int index = ParameterIndex(LastParameterIndex);
+	if (index >= 0 && ParameterSet(ParameterAt(index), Param[2]))
+	{
+		SD_Logging_Event_ParameterChange(LastParameterIndex, Param[2]);
 	}
+}
 
-	// ********** Start - LoRa Polling Commands *****************************************************************************
-
-	// ===============================================
-	// Command: LAP - (LoRa) Nav - 	responses: CTE, DTW, BTW, CDA, LAT, LON, COG, SOG, HDG
-	// ===============================================
-	// No Parameters
+// ===============================================
+// 	css, CLI Session Statistics
+// ===============================================
+// Parameters: none.
+// returns: css,LoRa lines,LoRa overflows,LoRa framing errors,Bluetooth lines,Bluetooth overflows,Bluetooth framing errors,
+//			USB lines,USB overflows,USB framing errors
+static void CLI_css(int CommandPort, char* Param[])
+{
+	(*Serials[CommandPort]).print(F("css,"));
+	(*Serials[CommandPort]).print(LoRaCLI.Lines);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(LoRaCLI.Overflows);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(LoRaCLI.FramingErrors);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(BluetoothCLI.Lines);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(BluetoothCLI.Overflows);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(BluetoothCLI.FramingErrors);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(USBCLI.Lines);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(USBCLI.Overflows);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).println(USBCLI.FramingErrors);
+}
 
-	if (!strncmp(cmd, "lna", 3))
-	{
-		QueueMessage(TelMessageType::LNA);
-	}
+// ===============================================
+// 	wsl, WingSail Link statistics
+// ===============================================
+// Parameters: optional "c" to clear the statistics after listing them.
+// returns, for each of srv, gsv, pow and ver: wsl,command,sent,retries,acks,failures,coalesced,min RTT ms,mean RTT ms,max RTT ms
+static void CLI_wsl(int CommandPort, char* Param[])
+{
+	static const char* const Names[wlCommandCount] = { "srv", "gsv", "pow", "ver" };
 
-	// ===============================================
-	// Command: LAT - (LoRa) Attitude:	responses: HDG, Pitch, Roll, Roll_avg
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lat", 3))
+	for (int cmd = 0; cmd < wlCommandCount; cmd++)
 	{
-		QueueMessage(TelMessageType::LAT);
+		const WingSailLinkStatsType& stats = WingSailLinkStats((WingSailLinkCommandType)cmd);
+		(*Serials[CommandPort]).print(F("wsl,"));
+		(*Serials[CommandPort]).print(Names[cmd]);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Sent);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Retries);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Acks);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Failures);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Coalesced);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.MinRTT_ms);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.RTTCount ? stats.TotalRTT_ms / stats.RTTCount : 0);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).println(stats.MaxRTT_ms);
 	}
 
-	// ===============================================
-	// Command: LPO - (LoRa) Power:	responses: Voyager Power V,I, Wingsail Power V, I
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lpo", 3))
+	if (*Param[1] == 'c')
 	{
-		//Serial.println(Fullcmd);
-		QueueMessage(TelMessageType::LPO);
+		WingSailLinkResetStats();
 	}
+}
 
-	// ===============================================
-	// Command: LWP - (LoRa) Waypoint:	responses: Prev WP, Next WP, Max CTE
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lwp", 3))
+// ===============================================
+// 	i2c, I2C manager statistics
+// ===============================================
+// Parameters: optional "c" to clear the statistics after listing them.
+// returns, for each device: i2c,name,bus,address,transactions,errors,timeouts,missed deadlines,mean latency us,max latency us
+//	then for each bus: i2b,bus,resets,waits for the bus,max wait us,wait timeouts
+static void CLI_i2c(int CommandPort, char* Param[])
+{
+	for (int d = 0; d < I2CDeviceCount(); d++)
 	{
-		QueueMessage(TelMessageType::LWP);
+		const I2CDeviceStatsType& stats = I2CDeviceStats(d);
+		(*Serials[CommandPort]).print(F("i2c,"));
+		(*Serials[CommandPort]).print(stats.Name);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Bus);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Address, HEX);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Transactions);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Errors);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Timeouts);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Missed);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Transactions ? (unsigned long)(stats.TotalLatency_us / stats.Transactions) : 0);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).println(stats.MaxLatency_us);
 	}
 
-	// ===============================================
-	// Command: LMI - (LoRa) current Mission Step Responses: MI, Cmd, Duration, SteerAWA, TTA
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lmi", 3))
+	for (int b = 0; b < I2CManagerBuses; b++)
 	{
-		QueueMessage(TelMessageType::LMI);
+		const I2CBusStatsType& stats = I2CBusStats(b);
+		(*Serials[CommandPort]).print(F("i2b,"));
+		(*Serials[CommandPort]).print(b);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Resets);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.Waits);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(stats.MaxWait_us);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).println(stats.WaitTimeouts);
 	}
 
-	// ===============================================
-	// Command: LWI - (LoRa) Wind data: Responses AWA / TWD,  TWS, WA / TTA
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lwi", 3))
+	if (*Param[1] == 'c')
 	{
-		QueueMessage(TelMessageType::LWI);
+		I2CResetStats();
 	}
+}
 
-	// ===============================================
-	// Command: LVS - (LoRa) GetVessel State - Response: Vessel State
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lvs", 3))
-	{
-		QueueMessage(TelMessageType::LVS);
-	}
+// ===============================================
+// 	ims, IMU Statistics
+// ===============================================
+// Parameters: none.
+// returns: ims,oversampling,reads,bus errors,reads not finished in time,FIFO samples,FIFO overruns
+static void CLI_ims(int CommandPort, char* Param[])
+{
+	(*Serials[CommandPort]).print(F("ims,"));
+	(*Serials[CommandPort]).print(imu.compass.oversampling);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(imu.compass.burstReads);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(imu.compass.burstErrors);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(imu.compass.burstOverruns);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(imu.compass.fifoSamples);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).println(imu.compass.fifoOverruns);
+}
 
-	// ===============================================
-	// Command: LPF - (LoRa) Get Sailing Performance 
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lpf", 3))
-	{
-		QueueMessage(TelMessageType::LPF);
-	}
+// ===============================================
+// 	mgf, MaGnetometer ellipsoid Fit
+// ===============================================
+// Parameters: optional "s" to save the fit to the configuration and EEPROM and use it for the heading (parameter 59 on),
+//	or "c" to clear the fit and start again from the min/max calibration.
+// returns: mgf,valid,samples,quality % rms,field strength,axis ratio,hard iron x,y,z,soft iron 9 values row by row
+static void CLI_mgf(int CommandPort, char* Param[])
+{
+	imu.FitMagCalibration();
+	const MagCalibrationType& fit = imu.MagFitResult;
 
-	// ===============================================
-	// Command: LSV - (LoRa) Servo positions - Response: Rudder us, Trim Tab us
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lsv", 3))
+	(*Serials[CommandPort]).print(F("mgf,"));
+	(*Serials[CommandPort]).print(fit.Valid);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(fit.Samples);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(fit.Quality, 2);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(fit.FieldStrength, 1);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(fit.AxisRatio, 3);
+	for (int i = 0; i < 3; i++)
 	{
-		QueueMessage(TelMessageType::LSV);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(fit.HardIron[i], 1);
 	}
-
-	// ===============================================
-	// Command: lws - (LoRa) Wingsail Power Data
-	// ===============================================
-	// No Parameters
-	if (!strncmp(cmd, "lws", 3))
+	for (int i = 0; i < 9; i++)
 	{
-		QueueMessage(TelMessageType::LWS);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(fit.SoftIron[i], 6);
 	}
+	(*Serials[CommandPort]).println();
 
- // ********** Watchdog trgger command
-
-	// ===============================================
-	// Command: rbt - Reboot (Freeze) command - used for exercising the Watch Dog and rebooting
-	// ===============================================
-	// one Parameter // send the command "rbt,99" to force the procesor to freeze and exercise the watchdog.
-	if (!strncmp(cmd, "rbt", 3))
+	switch (*Param[1])
 	{
-		if (atoi(param1) == 99)
+	case 's':
+		if (fit.Valid)
+		{
+			for (int i = 0; i < 9; i++)
+			{
+				Configuration.CompassSoftIron[i] = fit.SoftIron[i];
+			}
+			for (int i = 0; i < 3; i++)
+			{
+				Configuration.CompassHardIron[i] = fit.HardIron[i];
+			}
+			Configuration.CompassFitQuality = fit.Quality;
+			Configuration.CompassEllipsoid = true;
+			Save_EEPROM_ConfigValues();
+			IMU_Calibration_Init();
+			(*Serials[CommandPort]).println(F("mgf,saved"));
+		}
+		else
 		{
-			SD_Logging_Event_Messsage("WatchDog Test commencing... " );
-			while (1) {}; // WARNING !!! Deliberate FREEZE occurs here !!! 
-			// then Watchdog should trigger and cause a reboot.
+			(*Serials[CommandPort]).println(F("mgf,not valid, not saved"));
 		}
+		break;
+
+	case 'c':
+		imu.ResetMagCalibration(imu.MagFit);
+		break;
 	}
 }
-	// ********** End - LoRa Polling Commands *****************************************************************************
 
-
-void ListParameter(int CommandPort,int ParameterIndex)
+// ===============================================
+// 	mgr, MaGnetometer Record
+// ===============================================
+// Record the raw compass samples to the SD card, for the bench comparison mgb.
+// Parameter 1: s - start recording, e - end recording, t - tag the next second of samples with a reference heading.
+// Parameter 2: for s, the file name without the .mag extension. For t, the reference magnetic heading in degrees.
+static void CLI_mgr(int CommandPort, char* Param[])
 {
-	// function to list the value of a single parameter specified by its parameter number
-	// V1.1 11/10/2016 added MaxFileSize.
-
-	Set_LoRa_Mode(LoRa_Mode_Type::TxShortRange);
-
-	(*Serials[CommandPort]).print(F("prg,"));
-	(*Serials[CommandPort]).print(ParameterIndex);
-	(*Serials[CommandPort]).print(",");
+	char RecordFileName[16];
 
-	switch (ParameterIndex)
+	switch (*Param[1])
 	{
-	case 1:
-		(*Serials[CommandPort]).print(F("Mag_Offset,"));
-		(*Serials[CommandPort]).print(Configuration.CompassOffsetAngle);
-		break;
-
-	case 2:
-		(*Serials[CommandPort]).print(F("TrimTabOffset,"));
-		(*Serials[CommandPort]).print(Configuration.TrimTabOffset);
-		break;
-
-	case 3:
-		(*Serials[CommandPort]).print(F("TrimTabScale,"));
-		(*Serials[CommandPort]).print(Configuration.TrimTabScale);
-		break;
-
-	case 4:
-		(*Serials[CommandPort]).print(F("TrimTab Default Angle,"));
-		(*Serials[CommandPort]).print(Configuration.TrimTabDefaultAngle);
+	case 's':
+		snprintf(RecordFileName, sizeof(RecordFileName), "%s.mag", Param[2]);
+		if (CompassBenchRecordStart(RecordFileName))
+		{
+			(*Serials[CommandPort]).println(F("mgr,recording"));
+		}
+		else
+		{
+			(*Serials[CommandPort]).println(F("mgr,file not opened"));
+		}
 		break;
 
-	case 5:
-		(*Serials[CommandPort]).print(F("Sailable Angle Margin,"));
-		(*Serials[CommandPort]).print(Configuration.SailableAngleMargin);
+	case 't':
+		CompassBenchRecordTag(wrap_360_Int(atoi(Param[2])));
+		(*Serials[CommandPort]).println(F("mgr,tagged"));
 		break;
 
-	case 6:
-		(*Serials[CommandPort]).print(F("LoiterRadius,"));
-		(*Serials[CommandPort]).print(Configuration.LoiterRadius);
+	case 'e':
+		CompassBenchRecordStop();
+		(*Serials[CommandPort]).println(F("mgr,stopped"));
 		break;
+	}
+}
 
-	case 7:
-		(*Serials[CommandPort]).print(F("timezone_offset,"));
-		(*Serials[CommandPort]).print(Configuration.timezone_offset);
-		break;
+// ===============================================
+// 	mgb, MaGnetometer Bench comparison
+// ===============================================
+// Fit the ellipsoid calibration to a recording made with mgr, and compare the heading errors of the tagged samples
+// with the min/max calibration and cardinal corrections, and with the ellipsoid calibration.
+// Parameter 1: file name without the .mag extension
+// returns: mgb,records,tagged,fit valid,fit quality %,
+//	cardinal mean error,cardinal rms error,cardinal max error,ellipsoid mean error,ellipsoid rms error,ellipsoid max error
+//	The rms and max errors are about the mean, in degrees.
+static void CLI_mgb(int CommandPort, char* Param[])
+{
+	CompassBenchResultType result;
+	char BenchFileName[16];
+	snprintf(BenchFileName, sizeof(BenchFileName), "%s.mag", Param[1]);
 
-	case 8:
-		(*Serials[CommandPort]).print(F("LCDScreenView,"));
-		(*Serials[CommandPort]).print(Configuration.DisplayScreenView);
-		break;
+	if (CompassBench(BenchFileName, result))
+	{
+		(*Serials[CommandPort]).print(F("mgb,"));
+		(*Serials[CommandPort]).print(result.Records);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Tagged);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Fit.Valid);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Fit.Quality, 2);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Cardinal.Mean, 1);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Cardinal.RMS, 1);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Cardinal.Max, 1);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Ellipsoid.Mean, 1);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(result.Ellipsoid.RMS, 1);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).println(result.Ellipsoid.Max, 1);
+	}
+	else
+	{
+		(*Serials[CommandPort]).println(F("mgb,file not found"));
+	}
+}
 
-	case 9:
-		// temporary test code to investigate init strings for the NEO-8M GPS.
-	//	(*Serials[CommandPort]).print(F("GPSInitMessageNumber,"));
-	//	(*Serials[CommandPort]).print(GPSInitMessageNumber);
-		break;
+// ===============================================
+// 	mem, heap MEMory statistics
+// ===============================================
+// Parameters: none.
+// returns: mem,bytes in use,arena bytes,peak bytes,bytes in use at the end of setup,rises of the peak since setup,
+//			allocator calls since setup,allocator calls since power on
+static void CLI_mem(int CommandPort, char* Param[])
+{
+	HeapMonitorUpdate();
+	const HeapStatsType& stats = HeapMonitorStats();
 
-	case 10:
-		(*Serials[CommandPort]).print(F("UseGPSInitString,"));
-		Configuration.UseGPSInitString ? (*Serials[CommandPort]).print("true") : (*Serials[CommandPort]).print("false");
-		break;
+	(*Serials[CommandPort]).print(F("mem,"));
+	(*Serials[CommandPort]).print(stats.InUse);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stats.Arena);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stats.Peak);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stats.Baseline);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stats.SteadyStateRises);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stats.SteadyStateCalls);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).println(stats.AllocatorCalls);
+}
 
-	case 11:
-		(*Serials[CommandPort]).print(F("SaveStateValues,"));
-		Configuration.SaveStateValues ? (*Serials[CommandPort]).print("true") : (*Serials[CommandPort]).print("false");
-		break;
+// ===============================================
+// 	prd, Parameter Dump
+// ===============================================
+// Parameters: none.
+// sends all the parameter values in a few messages: prd,<first parameter number>,<value>,<value>...
+static void CLI_prd(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::PRD);
+}
 
-	case 12:
-		(*Serials[CommandPort]).print(F("MinimumAngleUpWind,"));
-		(*Serials[CommandPort]).print(Configuration.MinimumAngleUpWind);
-		break;
+// ===============================================
+// 	prb, Parameter Bulk load
+// ===============================================
+// Parameters: first Parameter Index Number, then up to 6 values, for that parameter and the following parameters in the prd order.
+// returns: prb,first Parameter Index Number,number of values set
+static void CLI_prb(int CommandPort, char* Param[])
+{
+	int first = atoi(Param[1]);
+	int index = ParameterIndex(first);
+	int loaded = 0;
 
-	case 13:
-		(*Serials[CommandPort]).print(F("MinimumAngleDownWind,"));
-		(*Serials[CommandPort]).print(Configuration.MinimumAngleDownWind);
-		break;
+	for (int i = 2; index >= 0 && index < ParameterCount() && i < CommandMaxParams && *Param[i]; i++, index++)
+	{
+		const ParameterEntryType& p = ParameterAt(index);
+		if (ParameterSet(p, Param[i]))
+		{
+			SD_Logging_Event_ParameterChange(p.Id, Param[i]);
+			loaded++;
+		}
+	}
 
-	case 14:
-		(*Serials[CommandPort]).print(F("WindAngleCalibrationOffset,"));
-		(*Serials[CommandPort]).print(Configuration.WindAngleCalibrationOffset);
-		break;
+	(*Serials[CommandPort]).print(F("prb,"));
+	(*Serials[CommandPort]).print(first);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).println(loaded);
+}
 
-	case 15:
-		(*Serials[CommandPort]).print(F("WPCourseHoldRadius,"));
-		(*Serials[CommandPort]).print(Configuration.WPCourseHoldRadius);
-		break;
+// ********** Start - LoRa Polling Commands *****************************************************************************
 
-	case 16:
-		(*Serials[CommandPort]).print(F("SDCardDelimiter,"));
+// ===============================================
+// Command: LAP - (LoRa) Nav - 	responses: CTE, DTW, BTW, CDA, LAT, LON, COG, SOG, HDG
+// ===============================================
+// No Parameters
+static void CLI_lna(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LNA);
+}
 
-		if (Configuration.SDCardLogDelimiter == '\t') { (*Serials[CommandPort]).print(F("Tab")); }
-		if (Configuration.SDCardLogDelimiter == ',') { (*Serials[CommandPort]).print(","); }
-		break;
+// ===============================================
+// Command: LAT - (LoRa) Attitude:	responses: HDG, Pitch, Roll, Roll_avg
+// ===============================================
+// No Parameters
+static void CLI_lat(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LAT);
+}
 
-	case 17:
-		(*Serials[CommandPort]).print(F("RTHTimeManualControl,"));
-		(*Serials[CommandPort]).print(Configuration.RTHTimeManualControl);
-		break;
+// ===============================================
+// Command: LPO - (LoRa) Power:	responses: Voyager Power V,I, Wingsail Power V, I
+// ===============================================
+// No Parameters
+static void CLI_lpo(int CommandPort, char* Param[])
+{
+	//Serial.println(Fullcmd);
+	QueueMessage(TelMessageType::LPO);
+}
 
-	case 18:
-		(*Serials[CommandPort]).print(F("AWA to TWD_Offset Angle,"));
-		(*Serials[CommandPort]).print(Configuration.TWD_Offset);
-		break;
+// ===============================================
+// Command: LWP - (LoRa) Waypoint:	responses: Prev WP, Next WP, Max CTE
+// ===============================================
+// No Parameters
+static void CLI_lwp(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LWP);
+}
 
-	case 19:
-		(*Serials[CommandPort]).print(F("TargetHeadingFilterConstant,"));
-		(*Serials[CommandPort]).print(Configuration.TargetHeadingFilterConstant);
-		break;
+// ===============================================
+// Command: LMI - (LoRa) current Mission Step Responses: MI, Cmd, Duration, SteerAWA, TTA
+// ===============================================
+// No Parameters
+static void CLI_lmi(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LMI);
+}
 
-	case 20:
-		(*Serials[CommandPort]).print(F("MaxFileSize,"));
-		(*Serials[CommandPort]).print(Configuration.MaxFileSize);
-		break;
+// ===============================================
+// Command: LWI - (LoRa) Wind data: Responses AWA / TWD,  TWS, WA / TTA
+// ===============================================
+// No Parameters
+static void CLI_lwi(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LWI);
+}
 
-	case 21:
-		(*Serials[CommandPort]).print(F("MagneticVariation,"));
-		(*Serials[CommandPort]).print(Configuration.MagnetVariation);
-		break;
+// ===============================================
+// Command: LVS - (LoRa) GetVessel State - Response: Vessel State
+// ===============================================
+// No Parameters
+static void CLI_lvs(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LVS);
+}
 
-	case 22:
-		(*Serials[CommandPort]).print(F("LoRaPort,"));
-		(*Serials[CommandPort]).print(Configuration.LoRaPort);
-		break;
+// ===============================================
+// Command: LPF - (LoRa) Get Sailing Performance 
+// ===============================================
+// No Parameters
+static void CLI_lpf(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LPF);
+}
 
-	case 23:
-		(*Serials[CommandPort]).print(F("SatCommsPort,"));
-		(*Serials[CommandPort]).print(Configuration.SatCommsPort);
-		break;
+// ===============================================
+// Command: LSV - (LoRa) Servo positions - Response: Rudder us, Trim Tab us
+// ===============================================
+// No Parameters
+static void CLI_lsv(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LSV);
+}
 
-	case 24:
-		(*Serials[CommandPort]).print(F("LoRaPortBaudRate,"));
-		(*Serials[CommandPort]).print(Configuration.LoRaPortBaudRate);
-		break;
+// ===============================================
+// Command: lws - (LoRa) Wingsail Power Data
+// ===============================================
+// No Parameters
+static void CLI_lws(int CommandPort, char* Param[])
+{
+	QueueMessage(TelMessageType::LWS);
+}
 
-	case 25:
-		(*Serials[CommandPort]).print(F("SatCommsPortBaudRate,"));
-		(*Serials[CommandPort]).print(Configuration.SatCommsPortBaudRate);
-		break;
+// ********** End - LoRa Polling Commands *****************************************************************************
 
-	case 26:
-		break;
+// ********** Watchdog trgger command
 
-	case 27:
-		break;
+// ===============================================
+// Command: rbt - Reboot (Freeze) command - used for exercising the Watch Dog and rebooting
+// ===============================================
+// one Parameter // send the command "rbt,99" to force the procesor to freeze and exercise the watchdog.
+static void CLI_rbt(int CommandPort, char* Param[])
+{
+	if (atoi(Param[1]) == 99)
+	{
+		SD_Logging_Event_Messsage("WatchDog Test commencing... " );
+		while (1) {}; // WARNING !!! Deliberate FREEZE occurs here !!! 
+		// then Watchdog should trigger and cause a reboot.
+	}
+}
 
-	case 28:
-		break;
+// The commands, in order of command for the binary search in CommandDispatch.
+static constexpr CommandEntryType CLI_Commands[] = {
+	{ CommandKey("cal"), CLI_cal },
+	{ CommandKey("ccg"), CLI_ccg },
+	{ CommandKey("ccs"), CLI_ccs },
+	{ CommandKey("css"), CLI_css },
+	{ CommandKey("ech"), CLI_ech },
+	{ CommandKey("eqg"), CLI_eqg },
+	{ CommandKey("hlc"), CLI_hlc },
+	{ CommandKey("hlg"), CLI_hlg },
+	{ CommandKey("hls"), CLI_hls },
+	{ CommandKey("i2c"), CLI_i2c },
+	{ CommandKey("idl"), CLI_idl },
+	{ CommandKey("ims"), CLI_ims },
+	{ CommandKey("lat"), CLI_lat },
+	{ CommandKey("lbd"), CLI_lbd },
+	{ CommandKey("lcd"), CLI_lcd },
+	{ CommandKey("lcs"), CLI_lcs },
+	{ CommandKey("lmi"), CLI_lmi },
+	{ CommandKey("lna"), CLI_lna },
+	{ CommandKey("lpf"), CLI_lpf },
+	{ CommandKey("lpo"), CLI_lpo },
+	{ CommandKey("lrp"), CLI_lrp },
+	{ CommandKey("lsv"), CLI_lsv },
+	{ CommandKey("lvs"), CLI_lvs },
+	{ CommandKey("lwi"), CLI_lwi },
+	{ CommandKey("lwp"), CLI_lwp },
+	{ CommandKey("lws"), CLI_lws },
+	{ CommandKey("mcc"), CLI_mcc },
+	{ CommandKey("mcl"), CLI_mcl },
+	{ CommandKey("mcp"), CLI_mcp },
+	{ CommandKey("mcr"), CLI_mcr },
+	{ CommandKey("mcs"), CLI_mcs },
+	{ CommandKey("mem"), CLI_mem },
+	{ CommandKey("mgb"), CLI_mgb },
+	{ CommandKey("mgf"), CLI_mgf },
+	{ CommandKey("mgr"), CLI_mgr },
+	{ CommandKey("mig"), CLI_mig },
+	{ CommandKey("mis"), CLI_mis },
+	{ CommandKey("prb"), CLI_prb },
+	{ CommandKey("prd"), CLI_prd },
+	{ CommandKey("prg"), CLI_prg },
+	{ CommandKey("prl"), CLI_prl },
+	{ CommandKey("prm"), CLI_prm },
+	{ CommandKey("prs"), CLI_prs },
+	{ CommandKey("rbt"), CLI_rbt },
+	{ CommandKey("rst"), CLI_rst },
+	{ CommandKey("sav"), CLI_sav },
+	{ CommandKey("scg"), CLI_scg },
+	{ CommandKey("scs"), CLI_scs },
+	{ CommandKey("sms"), CLI_sms },
+	{ CommandKey("spb"), CLI_spb },
+	{ CommandKey("srs"), CLI_srs },
+	{ CommandKey("ssw"), CLI_ssw },
+	{ CommandKey("stm"), CLI_stm },
+	{ CommandKey("stv"), CLI_stv },
+	{ CommandKey("tmg"), CLI_tmg },
+	{ CommandKey("tpc"), CLI_tpc },
+	{ CommandKey("tpl"), CLI_tpl },
+	{ CommandKey("ver"), CLI_ver },
+	{ CommandKey("wc0"), CLI_wc0 },
+	{ CommandKey("wc1"), CLI_wc1 },
+	{ CommandKey("wsl"), CLI_wsl },
+};
+static_assert(CommandTableSorted(CLI_Commands), "CLI_Commands must be in order of command, with no command repeated.");
 
-	case 29:
-		(*Serials[CommandPort]).print(F("Servo_Channel_Steering,"));
-		(*Serials[CommandPort]).print(Configuration.Servo_Channel_Steering);
-		break;
+// Process the Command String.
+// Split into command and parameters separated by commas. 
+// V1.0 22/12/2015
+// V1.1 13/01/2018 added support for a Vessel Command Parameter. i.e. steer a magnetic heading
+// V1.2 1/12/2018 changed strcpy to strncpy to guard against corrupting memory with long strings
+// V1.3 17/10/2026 the command is found in the CLI_Commands table, and the parameters point into CLI_Msg rather than being copied.
+// V1.4 17/10/2026 the line is passed in by the port's CLISession. The parameters point into the line.
 
-	case 30:
-		(*Serials[CommandPort]).print(F("Servo_Channel_Steering_Stbd,"));
-		(*Serials[CommandPort]).print(Configuration.Servo_Channel_Steering_Stbd);
-		break;
+void CLI_Processor(int CommandPort, char* line)
+{
+	CommandDispatch(CLI_Commands, sizeof(CLI_Commands) / sizeof(CLI_Commands[0]), CommandPort, line);
+}
 
-	case 31:
-		(*Serials[CommandPort]).print(F("SteeringDeadBand,"));
-		(*Serials[CommandPort]).print(Configuration.SteeringDeadBand);
-		break;
+void CLI_Processor(int CommandPort, const char* Command)
+{
+	// process a command given as constant text. The line is split in place, so it is copied first.
+	char line[CLISessionLineSize];
+	FormatText(line, sizeof(line), "%s", Command);
+	CLI_Processor(CommandPort, line);
+}
 
-	case 32:
-		(*Serials[CommandPort]).print(F("Servo_Channel_Motor,"));
-		(*Serials[CommandPort]).print(Configuration.Servo_Channel_Motor);
-		break;
 
-	case 33:
-		(*Serials[CommandPort]).print(F("UseMotor,"));
-		Configuration.UseMotor ? (*Serials[CommandPort]).print("true") : (*Serials[CommandPort]).print("false");
-		break;
+void ListParameter(int CommandPort,int ParameterNumber)
+{
+	// function to list the value of a single parameter specified by its parameter number
+	// V1.1 11/10/2016 added MaxFileSize.
+	// V1.2 17/10/2026 name, value and units from the parameter registry.
 
-	case 34:
-		(*Serials[CommandPort]).print(F("DualRudder,"));
-		Configuration.DualRudder ? (*Serials[CommandPort]).print("true") : (*Serials[CommandPort]).print("false");
-		break;
+	Set_LoRa_Mode(LoRa_Mode_Type::TxShortRange);
 
-	case 35:
-		(*Serials[CommandPort]).print(F("SteeringFilter,"));
-		(*Serials[CommandPort]).print(Configuration.SteeringFilterConstant);
-		break;
+	(*Serials[CommandPort]).print(F("prg,"));
+	(*Serials[CommandPort]).print(ParameterNumber);
+	(*Serials[CommandPort]).print(",");
 
-	case 36:
-		(*Serials[CommandPort]).print(F("pidDirection,"));
-		if (Configuration.pidDirection == 0) {
-			(*Serials[CommandPort]).print("Direct");
-		} else{
-			(*Serials[CommandPort]).print("Reverse");
+	int index = ParameterIndex(ParameterNumber);
+	if (index >= 0)
+	{
+		const ParameterEntryType& p = ParameterAt(index);
+		(*Serials[CommandPort]).print(p.Name);
+		(*Serials[CommandPort]).print(",");
+		ParameterPrintValue(*Serials[CommandPort], p, false);
+		if (*p.Units)
+		{
+			(*Serials[CommandPort]).print(",");
+			(*Serials[CommandPort]).print(p.Units);
 		}
-		break;
-
-	case 37:
-		(*Serials[CommandPort]).print(F("pidKp,"));
-		(*Serials[CommandPort]).print(Configuration.pidKp);
-		break;
-
-	case 38:
-		(*Serials[CommandPort]).print(F("pidKi,"));
-		(*Serials[CommandPort]).print(Configuration.pidKi);
-		break;
-
-	case 39:
-		(*Serials[CommandPort]).print(F("pidKd,"));
-		(*Serials[CommandPort]).print(Configuration.pidKd);
-		break;
-
-	case 40:
-		(*Serials[CommandPort]).print(F("pidOutputmin,"));
-		(*Serials[CommandPort]).print(Configuration.pidOutputmin);
-		break;
-
-	case 41:
-		(*Serials[CommandPort]).print(F("pidOutputmax,"));
-		(*Serials[CommandPort]).print(Configuration.pidOutputmax);
-		break;
-
-	case 42:
-		(*Serials[CommandPort]).print(F("pidCentre,"));
-		(*Serials[CommandPort]).print(Configuration.pidCentre);
-		break;
-
-	case 43:
-		(*Serials[CommandPort]).print(F("WingAngleError000,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngleError000);
-		break;
-
-	case 44:
-		(*Serials[CommandPort]).print(F("WingAngleError090,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngleError090);
-		break;
-
-	case 45:
-		(*Serials[CommandPort]).print(F("WingAngleError180,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngleError180);
-		break;
-
-	case 46:
-		(*Serials[CommandPort]).print(F("WingAngleError270,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngleError270);
-		break;
-
-
-	case 47:
-		(*Serials[CommandPort]).print(F("WingAngle_mXScale,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngle_mXScale);
-		break;
-
-	case 48:
-		(*Serials[CommandPort]).print(F("WingAngle_mYScale,"));
-		(*Serials[CommandPort]).print(Configuration.WingAngle_mYScale);
-		break;
-
-	case 49:
-		(*Serials[CommandPort]).print(F("CompassError000,"));
-		(*Serials[CommandPort]).print(Configuration.CompassError000);
-		break;
-
-	case 50:
-		(*Serials[CommandPort]).print(F("CompassError090,"));
-		(*Serials[CommandPort]).print(Configuration.CompassError090);
-		break;
-
-	case 51:
-		(*Serials[CommandPort]).print(F("CompassError180,"));
-		(*Serials[CommandPort]).print(Configuration.CompassError180);
-		break;
-
-	case 52:
-		(*Serials[CommandPort]).print(F("CompassError270,"));
-		(*Serials[CommandPort]).print(Configuration.CompassError270);
-		break;
-
-	case 53: 
-		//(*Serials[CommandPort]).print(F("DTB_Threshold,"));
-		//(*Serials[CommandPort]).print(Configuration.DTB_Threshold);
-		break;
-
-	case 54:
-		//(*Serials[CommandPort]).print(F("GPS_Max_Sleep_Time,"));
-		//(*Serials[CommandPort]).print(Configuration.GPS_Max_Sleep_Time);
-		break;
-
-	case 55:
-		//(*Serials[CommandPort]).print(F("GPS_Min_Wake_Time,"));
-		//(*Serials[CommandPort]).print(Configuration.GPS_Min_Wake_Time);
-		break;
-
-	default:
+	}
+	else
+	{
 		(*Serials[CommandPort]).print(F("Unknown"));
 	}
 
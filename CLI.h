@@ -71,6 +71,10 @@
 		no paramters
 	prs, Parameter Set 
 		prs, parameter number, value
+	prd, Parameter Dump, all values in a few messages
+		prd,first parameter number,value,value...
+	prb, Parameter Bulk load, as sent by prd
+		prb,first parameter number,value,value...
 	
 	dcs,  Parameter Set
 
@@ -81,6 +85,10 @@
 
 	vmg, Get Voltage Measurements
 
+	wsl, WingSail Link statistics: sent, retries, acks, failures, coalesced and round trip times for each wingsail command
+		wsl,c clears the statistics after listing them
+	css, CLI Session Statistics: lines, overflows and framing errors for the LoRa and Bluetooth ports
+
     LoRa commands
 	LNA - Approach:	CTE, DTW, BTW, CDA, LAT, LON, SOG, COG, HDG
 	LAT - Attitude: HDG, Pitch, Roll, Roll_avg
@@ -110,11 +118,9 @@
 #include "CommandState_Processor.h"
 
 
-void CLI_Process_Message(int CommandPort);
-
-void CLI_Processor(int CommandPort, String Command);
-void CLI_Processor(int CommandPort);
-void ListParameter(int CommandPort, int ParameterIndex);
+void CLI_Processor(int CommandPort, const char* Command);
+void CLI_Processor(int CommandPort, char* line);
+void ListParameter(int CommandPort, int ParameterNumber);
 void ShowCommandState(int CommandPort, VesselCommandStateType cs);
 
 
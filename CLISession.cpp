@@ -0,0 +1,85 @@
+// Command line session for one serial port.
+// Replaces the single CLI_Msg and BT_CLI_Msg buffers, which were only filled once a second, from the 1 second loops,
+// so a burst of commands could overflow the serial port receive buffer between calls, and each reply waited up to a second.
+// A line ends with CR or LF, and blank lines are ignored. A line that is too long, or that has characters that
+// aren't printable, such as radio noise, is discarded rather than processed in part.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 port 0 is the USB serial port.
+
+#include "CLISession.h"
+
+extern Stream *Serials[];
+
+void CLISession::begin(void(*processor)(int CommandPort, char* line))
+{
+	Processor = processor;
+	Head = Tail = 0;
+	Length = 0;
+	Discarding = false;
+	Lines = Overflows = FramingErrors = 0;
+}
+
+void CLISession::receive(int CommandPort)
+{
+	// move the characters waiting at the serial port into the ring buffer.
+	// V1.0 17/10/2026 John Semmens
+	if (CommandPort < 0 || !Serials[CommandPort])
+	{
+		return;
+	}
+
+	while ((*Serials[CommandPort]).available())
+	{
+		char received = (*Serials[CommandPort]).read();
+		if ((uint16_t)(Head - Tail) < CLISessionRingSize)
+		{
+			Ring[Head & (CLISessionRingSize - 1)] = received;
+			Head++;
+		}
+		else
+		{
+			Overflows++;
+		}
+	}
+}
+
+void CLISession::poll(int CommandPort)
+{
+	// receive, then assemble the characters into a line. Processes at most one line per call.
+	// V1.0 17/10/2026 John Semmens
+	receive(CommandPort);
+
+	while (Tail != Head)
+	{
+		char c = Ring[Tail & (CLISessionRingSize - 1)];
+		Tail++;
+
+		if (c == '\r' || c == '\n')
+		{
+			bool complete = !Discarding && Length > 0;
+			if (Discarding)
+			{
+				FramingErrors++;
+			}
+
+			Line[Length] = '\0';
+			Length = 0;
+			Discarding = false;
+
+			if (complete)
+			{
+				Lines++;
+				Processor(CommandPort, Line);
+				return;
+			}
+		}
+		else if (c < ' ' || c > '~' || Length >= CLISessionLineSize - 1)
+		{
+			Discarding = true;
+		}
+		else if (!Discarding)
+		{
+			Line[Length++] = c;
+		}
+	}
+}
@@ -0,0 +1,45 @@
+// CLISession.h
+
+// Command line session for one serial port.
+// Received characters are moved from the serial port into the session's ring buffer by receive(),
+// which can be called from a serial event hook or from poll(). poll() assembles the characters into lines
+// and passes each complete line to the session's command processor.
+// Each port has its own session, so commands arriving on several ports at once don't share a line buffer.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _CLISESSION_h
+#define _CLISESSION_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+static const unsigned int CLISessionRingSize = 256;	// bytes. must be a power of 2.
+static const unsigned int CLISessionLineSize = 64;	// longest command line, including the terminating null.
+
+class CLISession
+{
+public:
+	void begin(void(*processor)(int CommandPort, char* line));
+	void receive(int CommandPort);
+	void poll(int CommandPort);
+
+	unsigned long Lines;			// command lines processed
+	unsigned long Overflows;		// characters lost because the ring buffer was full
+	unsigned long FramingErrors;	// lines discarded because they were too long or had characters that aren't printable
+
+private:
+	void(*Processor)(int CommandPort, char* line);
+
+	char Ring[CLISessionRingSize];
+	volatile uint16_t Head;			// total characters put into the ring
+	volatile uint16_t Tail;			// total characters taken from the ring
+
+	char Line[CLISessionLineSize];
+	unsigned int Length;
+	bool Discarding;				// the current line is bad. Ignore the rest of it.
+};
+
+#endif
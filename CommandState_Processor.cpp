@@ -11,6 +11,7 @@
 #include "HAL_SDCard.h"
 #include "Mission.h"
 #include "DisplayStrings.h"
+#include "HAL_Time.h"
 
 extern StateValuesStruct StateValues;
 extern NavigationDataType NavData;
@@ -120,7 +121,7 @@ void CommandState_Processor(void)
 	// when it times out, it will change to Return to home, provided Home is set.
 	if ((StateValues.CommandState == vcsSteerMagneticCourse) || (StateValues.CommandState == vcsSteerWindCourse))
 	{
-		if ((((millis() - MissionValues.MissionCommandStartTime) / 1000) >= Configuration.RTHTimeManualControl)
+		if ((((VirtualMillis() - MissionValues.MissionCommandStartTime) / 1000) >= Configuration.RTHTimeManualControl)
 			&& (StateValues.home_is_set))
 		{
 			// if home is set then go home AND if time exceeds 
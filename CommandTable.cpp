@@ -0,0 +1,82 @@
+// Command dispatch for the command line processors.
+// Replaces copying the command and each parameter into fixed size arrays with strtok and strncpy,
+// and then testing the command against every command with strncmp.
+// V1.0 17/10/2026 John Semmens
+
+#include "CommandTable.h"
+
+static char EmptyParam[] = "";
+
+int CommandSplit(char* line, char* Param[])
+{
+	// Split the line into the command and parameters, separated by commas, in place.
+	// As with strtok, repeated commas are treated as one. Returns the number of fields found.
+	// V1.0 17/10/2026 John Semmens
+	int count = 0;
+	char* p = line;
+
+	while (count < CommandMaxParams)
+	{
+		while (*p == ',')
+		{
+			p++;
+		}
+		if (*p == '\0')
+		{
+			break;
+		}
+
+		Param[count++] = p;
+		while (*p != '\0' && *p != ',')
+		{
+			p++;
+		}
+		if (*p == ',')
+		{
+			*p++ = '\0';
+		}
+	}
+
+	for (int i = count; i < CommandMaxParams; i++)
+	{
+		Param[i] = EmptyParam;
+	}
+	return count;
+}
+
+bool CommandDispatch(const CommandEntryType* table, int count, int CommandPort, char* line)
+{
+	// Split the line, find the command in the sorted table, and call its handler.
+	// Returns false if the command is not in the table.
+	// V1.0 17/10/2026 John Semmens
+	char* Param[CommandMaxParams];
+
+	if (CommandSplit(line, Param) == 0 || strlen(Param[0]) < 3)
+	{
+		return false;
+	}
+
+	uint32_t key = CommandKey(Param[0]);
+	int low = 0;
+	int high = count - 1;
+
+	while (low <= high)
+	{
+		int mid = (low + high) / 2;
+		if (table[mid].Key == key)
+		{
+			table[mid].Handler(CommandPort, Param);
+			return true;
+		}
+
+		if (table[mid].Key < key)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+	return false;
+}
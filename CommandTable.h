@@ -0,0 +1,44 @@
+// CommandTable.h
+
+// Command dispatch for the command line processors (CLI and Bluetooth).
+// Each processor has a table of its 3 character commands and their handler functions, sorted by command,
+// so that a command is found with a binary search rather than testing every command in turn.
+// The received line is split in place; the parameters passed to the handler point into the line.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _COMMANDTABLE_h
+#define _COMMANDTABLE_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+static const int CommandMaxParams = 8;	// the command, and up to 7 parameters
+
+// Param[0] is the command, Param[1] to Param[7] the parameters. Parameters not received are empty strings.
+typedef void(*CommandHandlerType)(int CommandPort, char* Param[]);
+
+struct CommandEntryType {
+	uint32_t Key;					// CommandKey() of the command
+	CommandHandlerType Handler;
+};
+
+constexpr uint32_t CommandKey(const char* cmd)
+{
+	// the first 3 characters of the command as a number, for sorting and searching.
+	return ((uint32_t)(uint8_t)cmd[0] << 16) | ((uint32_t)(uint8_t)cmd[1] << 8) | (uint8_t)cmd[2];
+}
+
+template <int N>
+constexpr bool CommandTableSorted(const CommandEntryType(&table)[N], int i = 1)
+{
+	// true if the table is in ascending order of command, with no command repeated. Used in a static_assert.
+	return i >= N || (table[i - 1].Key < table[i].Key && CommandTableSorted(table, i + 1));
+}
+
+int CommandSplit(char* line, char* Param[]);
+bool CommandDispatch(const CommandEntryType* table, int count, int CommandPort, char* line);
+
+#endif
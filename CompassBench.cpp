@@ -0,0 +1,232 @@
+// Recording of raw compass samples, and a bench comparison of the min/max and ellipsoid compass calibrations.
+// The samples are recorded from HALIMU::Read, one record for each new compass reading, through the buffered
+// SD card writer, so the FastLoop is not held up by the card.
+// The bench reads the recording twice: first to fit the ellipsoid, as the background fit in HALIMU does, then to
+// work out the heading of each tagged sample with each calibration. Both headings go through getNavigationAngle,
+// so they are tilt compensated the same way. The CompassOffsetAngle and any constant error are taken out as the mean,
+// leaving the error that changes with heading, which is what the calibrations differ in.
+// The mean is a circular mean, so errors either side of 180 degrees don't average to about 0.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 CompassOffsetAngle taken off the ellipsoid heading, as HALIMU::Read does. Circular mean error,
+//					and the rms and max about it from the second pass.
+
+#include "CompassBench.h"
+#include "HAL_IMU.h"
+#include "HAL_SDLogWriter.h"
+#include "HAL_Watchdog.h"
+#include "Navigation.h"
+#include "configValues.h"
+#include "SD.h"
+
+extern configValuesType Configuration;
+extern HALIMU imu;
+extern HALSDLogWriter CompassBenchFile;
+
+static bool Recording = false;
+static int TagReference = -1;
+static int TagSamples = 0;		// samples still to be tagged with TagReference
+
+bool CompassBenchRecordStart(const char* filename)
+{
+	// start recording to the file, appending if it exists. Returns false if it could not be opened.
+	// V1.0 17/10/2026 John Semmens
+	TagSamples = 0;
+	Recording = CompassBenchFile.open(filename);
+	return Recording;
+}
+
+void CompassBenchRecordTag(int reference)
+{
+	// tag the next CompassBenchTagSamples samples with the reference heading. Hold the heading steady meanwhile.
+	// V1.0 17/10/2026 John Semmens
+	TagReference = reference;
+	TagSamples = CompassBenchTagSamples;
+}
+
+void CompassBenchRecordStop(void)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (Recording)
+	{
+		CompassBenchFile.close();
+		Recording = false;
+	}
+}
+
+bool CompassBenchRecording(void)
+{
+	return Recording;
+}
+
+void CompassBenchSample(const int16_t mag[3], const int16_t acc[3])
+{
+	// record one compass reading, if recording.
+	// V1.0 17/10/2026 John Semmens
+	if (!Recording)
+	{
+		return;
+	}
+
+	CompassBenchRecordType record;
+	for (int i = 0; i < 3; i++)
+	{
+		record.Mag[i] = mag[i];
+		record.Acc[i] = acc[i];
+	}
+	record.Reference = -1;
+	if (TagSamples > 0)
+	{
+		record.Reference = TagReference;
+		TagSamples--;
+	}
+	CompassBenchFile.write((const uint8_t*)&record, sizeof(record));
+}
+
+static float HeadingError(float heading, float reference)
+{
+	// -180 to +180 degrees
+	float error = fmod(heading - reference, 360);
+	if (error > 180)
+	{
+		error -= 360;
+	}
+	if (error < -180)
+	{
+		error += 360;
+	}
+	return error;
+}
+
+static bool ReadRecord(File& file, CompassBenchRecordType& record, MagneticSensorLsm303::vector<int16_t>& mag, MagneticSensorLsm303::vector<int16_t>& acc)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (file.read(&record, sizeof(record)) != sizeof(record))
+	{
+		return false;
+	}
+	mag = (MagneticSensorLsm303::vector<int16_t>){ record.Mag[0], record.Mag[1], record.Mag[2] };
+	acc = (MagneticSensorLsm303::vector<int16_t>){ record.Acc[0], record.Acc[1], record.Acc[2] };
+	return true;
+}
+
+struct CompassBenchSumsType {
+	float Sin;				// of the errors, for the circular mean
+	float Cos;
+	float Squares;			// of the errors about the mean
+};
+
+static void AddMeanError(CompassBenchSumsType& sums, float error)
+{
+	// first pass. The errors are added as unit vectors.
+	// V1.0 17/10/2026 John Semmens
+	sums.Sin += sin(error * DEG_TO_RAD);
+	sums.Cos += cos(error * DEG_TO_RAD);
+}
+
+static void FinishMeanError(CompassBenchErrorType& stats, const CompassBenchSumsType& sums)
+{
+	// V1.0 17/10/2026 John Semmens
+	stats.Mean = atan2(sums.Sin, sums.Cos) * RAD_TO_DEG;
+}
+
+static void AddSpreadError(CompassBenchErrorType& stats, CompassBenchSumsType& sums, float error)
+{
+	// second pass. The error about the mean, -180 to +180 degrees.
+	// V1.0 17/10/2026 John Semmens
+	float spread = HeadingError(error, stats.Mean);
+	sums.Squares += spread * spread;
+	stats.Max = max(stats.Max, (float)fabs(spread));
+}
+
+static void FinishSpreadError(CompassBenchErrorType& stats, const CompassBenchSumsType& sums, unsigned long count)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (count == 0)
+	{
+		return;
+	}
+	stats.RMS = sqrt(sums.Squares / count);
+}
+
+bool CompassBench(const char* filename, CompassBenchResultType& result)
+{
+	// compare the calibrations on a recording. Returns false if the file could not be opened.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 CompassOffsetAngle taken off the ellipsoid heading. Circular mean error.
+	File BenchFile = SD.open(filename);
+	if (!BenchFile)
+	{
+		return false;
+	}
+
+	memset(&result, 0, sizeof(result));
+
+	CompassBenchRecordType record;
+	MagneticSensorLsm303::vector<int16_t> mag;
+	MagneticSensorLsm303::vector<int16_t> acc;
+
+	// fit the ellipsoid to all the samples, starting from the min/max calibration.
+	EllipsoidFit fit;
+	imu.ResetMagCalibration(fit);
+	while (ReadRecord(BenchFile, record, mag, acc))
+	{
+		fit.AddSample(mag.x, mag.y, mag.z);
+		result.Records++;
+		if ((result.Records % 1000) == 0)
+		{
+			Watchdog_Pat();
+		}
+	}
+	fit.Fit(result.Fit);
+
+	// the heading errors of the tagged samples. The min/max heading is corrected as NavigationUpdate_FastData does.
+	CompassBenchSumsType cardinalSums = {};
+	CompassBenchSumsType ellipsoidSums = {};
+	for (int pass = 0; pass < 2; pass++)
+	{
+		BenchFile.seek(0);
+		while (ReadRecord(BenchFile, record, mag, acc))
+		{
+			if (record.Reference < 0)
+			{
+				continue;
+			}
+
+			int raw = wrap_360_Int((int)imu.compass.getNavigationAngle(mag, acc, NULL, NULL) - Configuration.CompassOffsetAngle);
+			float cardinal = HeadingError(raw - CompassCardinalDeviation(raw), record.Reference);
+			float ellipsoid = 0;
+			if (result.Fit.Valid)
+			{
+				int fitted = wrap_360_Int((int)imu.compass.getNavigationAngle(mag, acc, result.Fit.SoftIron, result.Fit.HardIron) - Configuration.CompassOffsetAngle);
+				ellipsoid = HeadingError(fitted, record.Reference);
+			}
+
+			if (pass == 0)
+			{
+				AddMeanError(cardinalSums, cardinal);
+				AddMeanError(ellipsoidSums, ellipsoid);
+				result.Tagged++;
+			}
+			else
+			{
+				AddSpreadError(result.Cardinal, cardinalSums, cardinal);
+				AddSpreadError(result.Ellipsoid, ellipsoidSums, ellipsoid);
+			}
+		}
+
+		if (pass == 0)
+		{
+			FinishMeanError(result.Cardinal, cardinalSums);
+			FinishMeanError(result.Ellipsoid, ellipsoidSums);
+		}
+		else
+		{
+			FinishSpreadError(result.Cardinal, cardinalSums, result.Tagged);
+			FinishSpreadError(result.Ellipsoid, ellipsoidSums, result.Tagged);
+		}
+		Watchdog_Pat();
+	}
+	BenchFile.close();
+
+	return true;
+}
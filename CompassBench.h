@@ -0,0 +1,51 @@
+// CompassBench.h
+
+// Recording of raw compass samples to the SD card, and a bench comparison of the compass calibrations on a recording.
+// A recording is a swing of the boat, or of the compass on the bench, through as many headings and heel angles as possible,
+// with bursts of samples tagged with a reference heading, e.g. from a bearing compass or the GPS course.
+// The bench fits an ellipsoid calibration to all the samples, then compares the heading error on the tagged samples
+// of the min/max calibration with cardinal corrections, as NavigationUpdate_FastData uses, against the ellipsoid calibration.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _COMPASSBENCH_h
+#define _COMPASSBENCH_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "MagCalibration.h"
+
+static const int CompassBenchTagSamples = 40;	// samples tagged with each reference heading. 1 second at 25 ms.
+
+struct CompassBenchRecordType {
+	int16_t Mag[3];			// raw magnetometer
+	int16_t Acc[3];			// accelerometer
+	int16_t Reference;		// reference magnetic heading, degrees. -1 for an untagged sample.
+};
+
+struct CompassBenchErrorType {
+	float Mean;				// degrees, circular mean. a constant error is taken out by CompassOffsetAngle.
+	float RMS;				// degrees, about the mean
+	float Max;				// degrees, about the mean
+};
+
+struct CompassBenchResultType {
+	unsigned long Records;
+	unsigned long Tagged;
+	MagCalibrationType Fit;				// the ellipsoid fitted to the recording
+	CompassBenchErrorType Cardinal;		// min/max calibration with the cardinal corrections
+	CompassBenchErrorType Ellipsoid;
+};
+
+bool CompassBenchRecordStart(const char* filename);
+void CompassBenchRecordTag(int reference);
+void CompassBenchRecordStop(void);
+bool CompassBenchRecording(void);
+void CompassBenchSample(const int16_t mag[3], const int16_t acc[3]);
+
+bool CompassBench(const char* filename, CompassBenchResultType& result);
+
+#endif
@@ -3,371 +3,171 @@
 // 
 
 #include "DisplayStrings.h"
-
-String CommandStateToString(VesselCommandStateType CommandState)
+#include "TextFormat.h"
+
+// V1.2 17/10/2026 John Semmens
+// The conversions return text from constant tables, indexed by the enumerated value, rather than building a String on the heap.
+// Each table must list the names in the order of its enumerated type. The static_asserts check the tables are complete.
+
+static constexpr const char* CommandStateText[] = {
+	"Idle",				// vcsIdle
+	"FollowMission",	// vcsFollowMission
+	"SteerMag",			// vcsSteerMagneticCourse
+	"SteerWind",		// vcsSteerWindCourse
+	"ReturnHome",		// vcsReturnToHome
+	"SetHome",			// vcsSetHome
+	"ResetIndex",		// vcsResetMissionIndex
+	"Loiter"			// vcsLoiter
+};
+static_assert(sizeof(CommandStateText) / sizeof(CommandStateText[0]) == vcsLoiter + 1, "CommandStateText doesn't match VesselCommandStateType");
+
+static constexpr const char* DecisionEventText[] = {
+	"IncMssnIdx",		// deIncrementMissionIndex
+	"PastWP",			// dePastWaypoint
+	"EndOfMission",		// deEndOfMission
+	"toPortTack",		// deTackToPort
+	"toStbdTack",		// deTackToStarboard
+	"toPortTkRunning",	// deTackToPortRunning
+	"toStbdTkRunning",	// deTackToStarboardRunning
+	"ChangeCmdState",	// deChangeCommandState
+	"HoldCourse",		// deHoldCourse
+	"RecoverToPort",	// deRecoverInIronsToPort
+	"RecoverToStbd"		// deRecoverInIronsToStbd
+};
+static_assert(sizeof(DecisionEventText) / sizeof(DecisionEventText[0]) == deRecoverInIronsToStbd + 1, "DecisionEventText doesn't match DecisionEventType");
+
+static constexpr const char* DecisionEventReasonText[] = {
+	"PastWP",			// rPastWaypoint
+	"PastTime",			// rPastTime
+	"PastDurn",			// rPastDuration
+	"PastBndry",		// rPastBoundary
+	"FavTack",			// rFavouredTack
+	"NoChange",			// rNoChange
+	"LimitToSailCrs",	// rLimitToSailingCourse
+	"PastLoitBndry",	// rPastLoiterBoundary
+	"Unkown",			// rUnkown
+	"None",				// rNone
+	"Manual",			// rManualIntervention
+	"ApproachWP",		// rApproachingWP
+	"InIronsRec"		// rInIronsRecover
+};
+static_assert(sizeof(DecisionEventReasonText) / sizeof(DecisionEventReasonText[0]) == rInIronsRecover + 1, "DecisionEventReasonText doesn't match DecisionEventReasonType");
+
+static constexpr const char* CourseTypeText[] = {
+	"NotEstablished",	// ctNotEstablished
+	"DirectToWP",		// ctDirectToWayPoint
+	"PortTack",			// ctPortTack
+	"StbdTack",			// ctStarboardTack
+	"PortTkRun",		// ctPortTackRunning
+	"StbdTkRun"			// ctStarboardTackRunning
+};
+static_assert(sizeof(CourseTypeText) / sizeof(CourseTypeText[0]) == ctStarboardTackRunning + 1, "CourseTypeText doesn't match SteeringCourseType");
+
+static constexpr const char* ManoeuvreStateText[] = {
+	"None",				// mstNone
+	"ToPort",			// mstCommenceToPort
+	"ToStbd",			// mstCommenceToStbd
+	"RunToPort",		// mstRunningToPort
+	"RunToStbd",		// mstRunningToStbd
+	"ApprchPort",		// mstApproachPort
+	"ApprchStbd",		// mstApproachStbd
+	"Complete"			// mstComplete
+};
+static_assert(sizeof(ManoeuvreStateText) / sizeof(ManoeuvreStateText[0]) == mstComplete + 1, "ManoeuvreStateText doesn't match ManoeuvreStateType");
+
+static constexpr const char* MissionCommandText[] = {
+	"Waypoint",			// ctGotoWaypoint
+	"Loiter",			// ctLoiter
+	"Loiter'til",		// ctLoiterUntil
+	"Home",				// ctReturnToHome
+	"SteerWind"			// ctSteerWindCourse
+};
+static_assert(sizeof(MissionCommandText) / sizeof(MissionCommandText[0]) == ctSteerWindCourse + 1, "MissionCommandText doesn't match MissionCommandType");
+
+static constexpr const char* EquipmentStatusText[] = {
+	"Unknown",			// Unknown
+	"NotFound",			// NotFound
+	"DataBad",			// DataBad
+	"Found",			// Found
+	"DataGood"			// DataGood
+};
+static_assert(sizeof(EquipmentStatusText) / sizeof(EquipmentStatusText[0]) == DataGood + 1, "EquipmentStatusText doesn't match EquipmentStatusType");
+
+static constexpr const char* InIronsStateText[] = {
+	"iiNo",				// iistNo
+	"iiPortTk",			// iistPortTack
+	"iiStbdTk"			// iistStarboardTack
+};
+static_assert(sizeof(InIronsStateText) / sizeof(InIronsStateText[0]) == iistStarboardTack + 1, "InIronsStateText doesn't match InIronsStateType");
+
+#define TEXT_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+const char* CommandStateToString(VesselCommandStateType CommandState)
 {
 	// function to return a string version of the CommandState enumnerated type
 	// V1.0 21/4/2019 John Semmens
-
-	String CommandStateAsString;
-	switch (CommandState)
-	{
-	case VesselCommandStateType::vcsFollowMission:
-		CommandStateAsString = F("FollowMission");
-		break;
-
-	//case VesselCommandStateType::vcsFullManual:
-	//	CommandStateAsString = F("FullManual");
-	//	break;
-
-	case VesselCommandStateType::vcsIdle:
-		CommandStateAsString = F("Idle");
-		break;
-
-	case VesselCommandStateType::vcsLoiter:
-		CommandStateAsString = F("Loiter");
-		break;
-
-	//case VesselCommandStateType::vcsPartialManual:
-	//	CommandStateAsString = F("PartialManual");
-	//	break;
-
-	case VesselCommandStateType::vcsResetMissionIndex:
-		CommandStateAsString = F("ResetIndex");
-		break;
-
-	case VesselCommandStateType::vcsReturnToHome:
-		CommandStateAsString = F("ReturnHome");
-		break;
-
-	case VesselCommandStateType::vcsSetHome:
-		CommandStateAsString = F("SetHome");
-		break;
-
-	case VesselCommandStateType::vcsSteerMagneticCourse:
-		CommandStateAsString = F("SteerMag");
-		break;
-
-	case VesselCommandStateType::vcsSteerWindCourse:
-		CommandStateAsString = F("SteerWind");
-		break;
-
-	default:
-		CommandStateAsString = F("Invalid");
-	}
-	return  CommandStateAsString;
+	// V1.1 17/10/2026 looked up in CommandStateText
+	return EnumText(CommandStateText, TEXT_COUNT(CommandStateText), CommandState);
 }
 
 
-String DecisionEventToString(DecisionEventType DecisionEvent)
+const char* DecisionEventToString(DecisionEventType DecisionEvent)
 {
 	// function to return a string version of the DecisionEvent enumnerated type
 	// V1.0 21/4/2019 John Semmens
 	// V1.1 13/6/2019 added deHoldCourse
-
-	String DecisionEventAsString;
-	switch (DecisionEvent)
-	{
-	case DecisionEventType::deEndOfMission:
-		DecisionEventAsString = F("EndOfMission");
-		break;
-
-	case DecisionEventType::deIncrementMissionIndex:
-		DecisionEventAsString = F("IncMssnIdx");
-		break;
-
-	case DecisionEventType::dePastWaypoint:
-		DecisionEventAsString = F("PastWP");
-		break;
-
-	case DecisionEventType::deTackToPort:
-		DecisionEventAsString = F("toPortTack");
-		break;
-
-	case DecisionEventType::deTackToStarboard:
-		DecisionEventAsString = F("toStbdTack");
-		break;
-
-	case DecisionEventType::deTackToPortRunning:
-		DecisionEventAsString = F("toPortTkRunning");
-		break;
-
-	case DecisionEventType::deTackToStarboardRunning:
-		DecisionEventAsString = F("toStbdTkRunning");
-		break;
-
-	case DecisionEventType::deChangeCommandState:
-		DecisionEventAsString = F("ChangeCmdState");
-		break;
-
-	case DecisionEventType::deHoldCourse:
-		DecisionEventAsString = F("HoldCourse");
-		break;
-
-	case	DecisionEventType::deRecoverInIronsToPort:
-		DecisionEventAsString = F("RecoverToPort");
-		break;
-
-	case	DecisionEventType::deRecoverInIronsToStbd:
-		DecisionEventAsString = F("RecoverToStbd");
-		break;
-
-	default:
-		DecisionEventAsString = F("Invalid");
-	}
-	return DecisionEventAsString;
+	// V1.2 17/10/2026 looked up in DecisionEventText
+	return EnumText(DecisionEventText, TEXT_COUNT(DecisionEventText), DecisionEvent);
 }
 
-String DecisionEventReasonToString(DecisionEventReasonType DecisionEventReason)
+const char* DecisionEventReasonToString(DecisionEventReasonType DecisionEventReason)
 {
 	// function to return a string version of the DecisionEvent enumnerated type
 	// V1.0 21/4/2019 John Semmens
 	// V1.1 13/6/2019 added rApproachingWP
-
-	String DecisionEventReasonAsString;
-	switch (DecisionEventReason)
-	{
-	case DecisionEventReasonType::rFavouredTack:
-		DecisionEventReasonAsString = F("FavTack");
-		break;
-
-	case DecisionEventReasonType::rNoChange:
-		DecisionEventReasonAsString = F("NoChange");
-		break;
-
-	case DecisionEventReasonType::rPastBoundary:
-		DecisionEventReasonAsString = F("PastBndry");
-		break;
-
-	case DecisionEventReasonType::rPastDuration:
-		DecisionEventReasonAsString = F("PastDurn");
-		break;
-
-	case DecisionEventReasonType::rPastTime:
-		DecisionEventReasonAsString = F("PastTime");
-		break;
-
-	case DecisionEventReasonType::rPastWaypoint:
-		DecisionEventReasonAsString = F("PastWP");
-		break;
-
-	case DecisionEventReasonType::rUnkown:
-		DecisionEventReasonAsString = F("Unkown");
-		break;
-
-	case DecisionEventReasonType::rLimitToSailingCourse:
-		DecisionEventReasonAsString = F("LimitToSailCrs");
-		break;
-
-	case DecisionEventReasonType::rPastLoiterBoundary:
-		DecisionEventReasonAsString = F("PastLoitBndry");
-		break;
-
-	case DecisionEventReasonType::rNone:
-		DecisionEventReasonAsString = F("None");
-		break;
-
-	case DecisionEventReasonType::rManualIntervention:
-		DecisionEventReasonAsString = F("Manual");
-		break;
-
-	case DecisionEventReasonType::rApproachingWP:
-		DecisionEventReasonAsString = F("ApproachWP");
-		break;
-
-		case DecisionEventReasonType::rInIronsRecover:
-		DecisionEventReasonAsString = F("InIronsRec");
-		break;
-
-	default:
-		DecisionEventReasonAsString = F("Invalid");
-	}
-	return DecisionEventReasonAsString;
+	// V1.2 17/10/2026 looked up in DecisionEventReasonText
+	return EnumText(DecisionEventReasonText, TEXT_COUNT(DecisionEventReasonText), DecisionEventReason);
 }
 
-String CourseTypeToString(SteeringCourseType CourseType)
+const char* CourseTypeToString(SteeringCourseType CourseType)
 {
 	// function to return a string version of the CourseType enumnerated type
 	// V1.0 5/5/2019 John Semmens
 	// V1.1 10/1/2021 filled out additional new running values.
-
-	String CourseTypeAsString;
-
-	switch (CourseType)
-	{
-	case SteeringCourseType::ctNotEstablished:
-		CourseTypeAsString = F("NotEstablished");
-		break;
-
-	case SteeringCourseType::ctDirectToWayPoint:
-		CourseTypeAsString = F("DirectToWP");
-		break;
-
-	case SteeringCourseType::ctPortTack:
-		CourseTypeAsString = F("PortTack");
-		break;
-
-	case SteeringCourseType::ctStarboardTack:
-		CourseTypeAsString = F("StbdTack");
-		break;
-
-	case SteeringCourseType::ctPortTackRunning:
-		CourseTypeAsString = F("PortTkRun");
-		break;
-
-	case SteeringCourseType::ctStarboardTackRunning:
-		CourseTypeAsString = F("StbdTkRun");
-		break;
-
-	default:
-		CourseTypeAsString = F("Invalid");
-	}
-
-	return CourseTypeAsString;
+	// V1.2 17/10/2026 looked up in CourseTypeText
+	return EnumText(CourseTypeText, TEXT_COUNT(CourseTypeText), CourseType);
 }
 
 
-String CourseTypeToString(ManoeuvreStateType ManoeuvreState)
+const char* CourseTypeToString(ManoeuvreStateType ManoeuvreState)
 {
 	// function to return a string version of the ManoeuvreState enumnerated type
 	// V1.0 29/5/2019 John Semmens
 	// V1.1 29/6/2022 added mstCommenceToPort and mstCommenceToStbd for Asymetric Gybe
-	String ManoeuvreStateAsString;
-
-	switch (ManoeuvreState)
-	{
-	case ManoeuvreStateType::mstCommenceToPort:
-		ManoeuvreStateAsString = F("ToPort");
-		break;
-
-	case ManoeuvreStateType::mstCommenceToStbd:
-		ManoeuvreStateAsString = F("ToStbd");
-		break;
-
-	case ManoeuvreStateType::mstComplete:
-		ManoeuvreStateAsString = F("Complete");
-		break;
-
-	case ManoeuvreStateType::mstNone:
-		ManoeuvreStateAsString = F("None");
-		break;
-
-	case ManoeuvreStateType::mstRunningToPort:
-		ManoeuvreStateAsString = F("RunToPort");
-		break;
-
-	case ManoeuvreStateType::mstRunningToStbd:
-		ManoeuvreStateAsString = F("RunToStbd");
-		break;
-
-	case ManoeuvreStateType::mstApproachPort:
-		ManoeuvreStateAsString = F("ApprchPort");
-		break;
-
-	case ManoeuvreStateType::mstApproachStbd:
-		ManoeuvreStateAsString = F("ApprchStbd");
-		break;
-
-	default:
-		ManoeuvreStateAsString = F("Invalid");
-	}
-
-	return ManoeuvreStateAsString;
+	// V1.2 17/10/2026 looked up in ManoeuvreStateText
+	return EnumText(ManoeuvreStateText, TEXT_COUNT(ManoeuvreStateText), ManoeuvreState);
 }
 
 
-
-
-
-String GetMissionCommandString(MissionCommandType cmd)
+const char* GetMissionCommandString(MissionCommandType cmd)
 {
 	// function to return a string version of the MissionCommandType enumnerated type
 	// V1.0 29/5/2019 John Semmens
-	String MissionCommandString;
-
-	switch (cmd)
-	{
-	case MissionCommandType::ctGotoWaypoint:
-		MissionCommandString = F("Waypoint");
-		break;
-
-	case MissionCommandType::ctLoiter:
-		MissionCommandString = F("Loiter");
-		break;
-
-	case MissionCommandType::ctLoiterUntil:
-		MissionCommandString = F("Loiter'til");
-		break;
-
-	case MissionCommandType::ctReturnToHome:
-		MissionCommandString = F("Home");
-		break;
-
-	case MissionCommandType::ctSteerWindCourse:
-		MissionCommandString = F("SteerWind");
-		break;
-
-	default:
-		MissionCommandString = F("unknown");
-	}
-
-	return MissionCommandString;
+	// V1.1 17/10/2026 looked up in MissionCommandText
+	return EnumText(MissionCommandText, TEXT_COUNT(MissionCommandText), cmd, "unknown");
 }
 
 
-String GetEquipmentStatusString(EquipmentStatusType status)
+const char* GetEquipmentStatusString(EquipmentStatusType status)
 {
-	String ResultString;
-
-	switch (status) {
-	case EquipmentStatusType::Unknown:
-		ResultString = "Unknown";
-		break;
-
-	case EquipmentStatusType::NotFound:
-		ResultString = "NotFound";
-		break;
-
-	case EquipmentStatusType::Found:
-		ResultString = "Found";
-		break;
-
-	case EquipmentStatusType::DataBad:
-		ResultString = "DataBad";
-		break;
-
-		case EquipmentStatusType::DataGood:
-		ResultString = "DataGood";
-		break;
-
-	default:
-		ResultString = "StatusUnknown";
-	}
-
-	return ResultString;
+	// V1.1 17/10/2026 looked up in EquipmentStatusText
+	return EnumText(EquipmentStatusText, TEXT_COUNT(EquipmentStatusText), status, "StatusUnknown");
 }
 
-String GetInIronsStatusString(InIronsStateType state)
+const char* GetInIronsStatusString(InIronsStateType state)
 {
-	String ResultString;
-
-	switch (state) {
-	case InIronsStateType::iistNo:
-		ResultString = "iiNo";
-		break;
-
-	case InIronsStateType::iistPortTack:
-		ResultString = "iiPortTk";
-		break;
-
-	case InIronsStateType::iistStarboardTack:
-		ResultString = "iiStbdTk";
-		break;
-
-	default:
-		ResultString = "StatusUnknown";
-	}
-	return ResultString;
+	// V1.1 17/10/2026 looked up in InIronsStateText
+	return EnumText(InIronsStateText, TEXT_COUNT(InIronsStateText), state, "StatusUnknown");
 }
 
 
@@ -46,15 +46,15 @@ enum DecisionEventReasonType {
 };
 
 
-	String CommandStateToString(VesselCommandStateType CommandState);
-	String DecisionEventToString(DecisionEventType DecisionEvent);
-	String DecisionEventReasonToString(DecisionEventReasonType DecisionEventReason);
-	String CourseTypeToString(SteeringCourseType CourseType);
-	String CourseTypeToString(ManoeuvreStateType ManoeuvreState);
-
-	String GetMissionCommandString(MissionCommandType cmd);
-	String GetEquipmentStatusString(EquipmentStatusType status);
-	String GetInIronsStatusString(InIronsStateType state);
+	const char* CommandStateToString(VesselCommandStateType CommandState);
+	const char* DecisionEventToString(DecisionEventType DecisionEvent);
+	const char* DecisionEventReasonToString(DecisionEventReasonType DecisionEventReason);
+	const char* CourseTypeToString(SteeringCourseType CourseType);
+	const char* CourseTypeToString(ManoeuvreStateType ManoeuvreState);
+
+	const char* GetMissionCommandString(MissionCommandType cmd);
+	const char* GetEquipmentStatusString(EquipmentStatusType status);
+	const char* GetInIronsStatusString(InIronsStateType state);
 
 	char* strtrim(char* str);
 	void strtrim2(char* str);
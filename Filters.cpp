@@ -13,6 +13,11 @@ float LowPassFilter::Filter(float Input)
 	return filtered_value;
 };
 
+void LowPassFilter::Init(float InitValue)
+{
+	last_filtered_value = InitValue;
+};
+
 float HighPassFilter::Filter(float Input)
 {
 	float filtered_value;
@@ -58,6 +63,12 @@ float LowPassAngleFilter::Filter(float InputAngle)
 	return filtered_angle_value;
 };
 
+void LowPassAngleFilter::Init(float InitAngle)
+{
+	last_filtered_value_X = sin(radians(InitAngle));
+	last_filtered_value_Y = cos(radians(InitAngle));
+};
+
 
 
 
@@ -17,6 +17,7 @@ class LowPassFilter
 	public:
 		float FilterConstant = 0.05; // default value only
 		float Filter(float Input);
+		void Init(float InitValue);
 
 };  // class LowPassFilter
 
@@ -43,6 +44,7 @@ protected:
 public:
 	float FilterConstant = 0.05; // default value only
 	float Filter(float Input);
+	void Init(float InitAngle);
 
 };  // class LowPassAngleFilter
 
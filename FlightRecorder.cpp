@@ -0,0 +1,148 @@
+// Flight recorder for manoeuvres.
+// The 1 second log records are too coarse to show how a tack, gybe or in-irons recovery was steered.
+// This keeps the last 15 seconds of the FastLoop steering state in RAM, and on an event writes the 10 seconds before
+// and 5 seconds after it to the SD card. This gives 40 Hz data around each manoeuvre without logging at 40 Hz all the time.
+//
+// Sampling stops while a block is written, and events during the 5 seconds after an event, or while writing,
+// are part of the block already being recorded, so they don't start another.
+// The block is passed to the log writer in sector sized parts from the SD writer task.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 the file name is made in a fixed buffer, rather than a String.
+// V1.2 17/10/2026 waits for space in the log writer's own buffer, which is smaller than the log file's.
+
+#include "FlightRecorder.h"
+#include "HAL_SDLogWriter.h"
+#include "HAL_SDCard.h"
+#include "Navigation.h"
+#include "Wingsail.h"
+#include "HAL_IMU.h"
+#include "DisplayStrings.h"
+#include "TimeLib.h"
+
+extern NavigationDataType NavData;
+extern WingSailType WingSail;
+extern HALIMU imu;
+extern double pidActualHdgError;
+extern double SteeringServoOutput_LPF;
+extern DecisionEventType DecisionEvent;
+extern DecisionEventReasonType DecisionEventReason;
+extern HALSDLogWriter FlightRecorderFile;
+extern char LogFileName[];
+
+enum FlightRecorderStateType {
+	frsRecording,	// sampling, waiting for an event
+	frsPostEvent,	// sampling the samples after the event
+	frsWriting		// sampling stopped, writing the block
+};
+
+static FlightRecorderSampleType Samples[FlightRecorderSamples];
+static uint32_t SampleTotal;		// number of samples taken. The next sample goes in Samples[SampleTotal % FlightRecorderSamples].
+static FlightRecorderStateType State = frsRecording;
+static int PostRemaining;
+static FlightRecorderHeaderType Header;
+static bool HeaderWritten;
+static int WriteIndex;				// next sample of the block to write.
+
+void FlightRecorder_Sample(void)
+{
+	// record the steering state. Called from the FastLoop.
+	// V1.0 17/10/2026 John Semmens
+	if (State == frsWriting)
+	{
+		return;
+	}
+
+	FlightRecorderSampleType& s = Samples[SampleTotal % FlightRecorderSamples];
+	s.Time_ms = millis();
+	s.HDG = NavData.HDG;
+	s.TargetHDG = NavData.TargetHDG;
+	s.HdgError = (int16_t)pidActualHdgError;
+	s.Servo = (int16_t)SteeringServoOutput_LPF;
+	s.AWA = NavData.AWA;
+	s.WingAngle = WingSail.Angle;
+	s.Roll = imu.Roll;
+	SampleTotal++;
+
+	if (State == frsPostEvent && --PostRemaining <= 0)
+	{
+		int available = min(SampleTotal, (uint32_t)FlightRecorderSamples);
+		Header.SampleCount = available;
+		Header.TriggerSample = available - FlightRecorderPostSamples;
+		HeaderWritten = false;
+		WriteIndex = 0;
+		State = frsWriting;
+	}
+}
+
+void FlightRecorder_Trigger(FlightRecorderTriggerType trigger)
+{
+	// an event has occurred. Record the following samples, then write the block.
+	// V1.0 17/10/2026 John Semmens
+	if (State != frsRecording)
+	{
+		return;
+	}
+
+	Header.Sync = FlightRecorderSync;
+	Header.Version = FlightRecorderVersion;
+	Header.SampleSize = sizeof(FlightRecorderSampleType);
+	Header.Time = now();
+	Header.Trigger = trigger;
+	Header.DecisionEvent = DecisionEvent;
+	Header.DecisionEventReason = DecisionEventReason;
+	Header.InIronsState = NavData.InIronsState;
+
+	PostRemaining = FlightRecorderPostSamples;
+	State = frsPostEvent;
+}
+
+void FlightRecorder_Write(void)
+{
+	// pass the next sector of the block to the log writer. Called from the SD writer task.
+	// V1.0 17/10/2026 John Semmens
+	if (State != frsWriting)
+	{
+		return;
+	}
+
+	if (!FlightRecorderFile)
+	{
+		// the log file name, with .frc in place of .log
+		char FileName[LogFileNameSize];
+		strcpy(FileName, LogFileName);
+		strcpy(FileName + 8, ".frc");
+		if (!FlightRecorderFile.open(FileName))
+		{
+			// no SD card. Discard the block.
+			State = frsRecording;
+			return;
+		}
+	}
+
+	// wait for space in the log writer buffer.
+	if (FlightRecorderFile.QueueDepth() > FlightRecorderFile.Capacity() - LogWriterSectorSize - sizeof(Header))
+	{
+		return;
+	}
+
+	if (!HeaderWritten)
+	{
+		FlightRecorderFile.write((const uint8_t*)&Header, sizeof(Header));
+		HeaderWritten = true;
+	}
+
+	// samples, oldest first.
+	uint32_t first = SampleTotal - Header.SampleCount;
+	int count = LogWriterSectorSize / sizeof(FlightRecorderSampleType);
+	while (count-- > 0 && WriteIndex < Header.SampleCount)
+	{
+		FlightRecorderFile.write((const uint8_t*)&Samples[(first + WriteIndex) % FlightRecorderSamples], sizeof(FlightRecorderSampleType));
+		WriteIndex++;
+	}
+
+	if (WriteIndex >= Header.SampleCount)
+	{
+		FlightRecorderFile.flush();
+		State = frsRecording;
+	}
+}
@@ -0,0 +1,59 @@
+// FlightRecorder.h
+
+// Flight recorder for manoeuvres.
+// The steering state is sampled into a RAM ring buffer each FastLoop (40 Hz).
+// When a decision event is logged, or the in-irons state changes, the samples from before and after the event
+// are written to the SD card as one binary block, in a .frc file with the same name as the current .log file.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _FLIGHTRECORDER_h
+#define _FLIGHTRECORDER_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+static const int FlightRecorderPreSamples = 400;	// 10 seconds before the event at 40 Hz
+static const int FlightRecorderPostSamples = 200;	// 5 seconds after the event
+static const int FlightRecorderSamples = FlightRecorderPreSamples + FlightRecorderPostSamples;
+
+static const byte FlightRecorderVersion = 1;
+static const byte FlightRecorderSync = 0x5A;
+
+enum FlightRecorderTriggerType {
+	frtDecision,	// a DEC event
+	frtInIrons		// a change of the in-irons state
+};
+
+struct __attribute__((packed)) FlightRecorderSampleType {
+	uint32_t Time_ms;		// millis
+	int16_t HDG;
+	int16_t TargetHDG;
+	int16_t HdgError;		// pidActualHdgError, degrees
+	int16_t Servo;			// SteeringServoOutput_LPF, microseconds
+	int16_t AWA;
+	int16_t WingAngle;
+	int16_t Roll;
+};
+
+// written at the start of each block, followed by SampleCount samples, oldest first.
+struct __attribute__((packed)) FlightRecorderHeaderType {
+	byte Sync;				// FlightRecorderSync
+	byte Version;			// FlightRecorderVersion
+	uint16_t SampleCount;
+	uint16_t SampleSize;	// bytes per sample
+	uint16_t TriggerSample;	// index of the first sample after the event
+	uint32_t Time;			// seconds since 1970 (TimeLib now()) at the event
+	byte Trigger;			// FlightRecorderTriggerType
+	byte DecisionEvent;
+	byte DecisionEventReason;
+	byte InIronsState;
+};
+
+void FlightRecorder_Sample(void);
+void FlightRecorder_Trigger(FlightRecorderTriggerType trigger);
+void FlightRecorder_Write(void);
+
+#endif
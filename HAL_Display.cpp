@@ -1,15 +1,20 @@
 // 
 // 
 //  V1.1 22/7/2023 removed GPS power controls.
+//  V1.2 17/10/2026 page t changed to show the loop period and the scheduler tasks with the longest run times.
+//  V1.3 17/10/2026 status text is formatted into fixed buffers rather than Strings.
+//  V1.4 17/10/2026 the I2C bus is held with the I2C manager while a page is sent.
 
 #include "HAL_Display.h"
 #include "HAL.h"
 #include "HAL_Time.h"
+#include "TextFormat.h"
 
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1306.h"
 #include <SPI.h>
 #include "i2c_t3.h"
+#include "I2CManager.h"
 
 #include "DisplayStrings.h"
 #include "Navigation.h"
@@ -26,6 +31,7 @@
 #include "TimeLib.h"
 #include "BluetoothConnection.h"
 #include "InternalTemperature.h"
+#include "SchedulerCooperative.h"
 
 extern NavigationDataType NavData;
 extern StateValuesStruct StateValues;
@@ -35,7 +41,7 @@ extern char Version[];
 extern char VersionDate[];
 extern time_t GPSTime;
 
-extern HardwareSerial* Serials[];
+extern Stream* Serials[];
 extern bool SD_Card_Present; // Flag for SD Card Presence
 extern configValuesType Configuration;
 extern MissionValuesStruct MissionValues;
@@ -58,9 +64,10 @@ extern VesselUsageCountersStruct VesselUsageCounters;
 
 extern sim_vessel simulated_vessel;
 extern int SteeringServoOutput;
+extern long loop_period_us; // microseconds between successive main loop executions
 extern sim_weather simulated_weather;
 
-extern String LogFileName;
+extern char LogFileName[];
 extern uint32_t Minute;
 extern int HWConfigNumber;
 
@@ -72,12 +79,14 @@ extern HALServo servo;
 Adafruit_SSD1306 display(OLED_RESET);
 
 static const byte OLED_Address = 0x3C;
+static int OLED_Device = -1;	// I2C manager device
 
 void HALDisplay::Init()
 {
 	Serial.println(F("*** Initialising OLED Display."));
 
 	// by default, we'll generate the high voltage from the 3.3v line internally! (neat!)
+	OLED_Device = I2CAddDevice(0, OLED_Address, "OLED");
 	display.begin(SSD1306_SWITCHCAPVCC, OLED_Address);  // initialize with the I2C addr 0x3C (for the 128x32)
 												// init done
 
@@ -114,6 +123,7 @@ void HALDisplay::Page(char page)
 	// V1.0 10/12/2017 John Semmens
 	// V1.1 20/1/2019 added Mag Accuracy to the Attitude page.
 	// V1.2 18/2/2019 added Wear Statistics
+	// V1.3 17/10/2026 the I2C bus is held with the I2C manager while the page is sent.
 
 	// values for LCD Logging:
 
@@ -169,6 +179,8 @@ void HALDisplay::Page(char page)
 
 	if (EquipmentStatus == EquipmentStatusType::Found)
 	{
+		I2CBusBegin(OLED_Device);
+
 		// assume the Display may have been disabled, so enable on each command
 		display.ssd1306_command(SSD1306_DISPLAYON);
 
@@ -721,7 +733,7 @@ void HALDisplay::Page(char page)
 			display.print(MissionValues.MissionList[StateValues.mission_index].duration);
 
 			display.print(" MT:  "); // in seconds
-			display.print((millis() - MissionValues.MissionCommandStartTime) / 1000);
+			display.print((VirtualMillis() - MissionValues.MissionCommandStartTime) / 1000);
 			display.println();
 
 			// Row 3 -- line 3
@@ -964,25 +976,44 @@ void HALDisplay::Page(char page)
 		case 't':
 			// Display Timing information  **********************************
 			// t = timing
-			// Row 1 -- line 1 
+			// Row 1 -- up time and main loop period
 			display.clearDisplay();
 			display.setCursor(0, 0);
 			display.setTextSize(1);
 
-			display.print("millis(): ");  // in seconds
-			display.println(millis() / 1000);
-
-			// Row 2 -- line 2
-			display.print("MC Start: "); // in seconds
-			display.println(MissionValues.MissionCommandStartTime / 1000);
-
-			// Row 3 -- line 3
-			display.print("Elapsed:  "); // in seconds
-			display.println((millis() - MissionValues.MissionCommandStartTime) / 1000);
+			display.print("Up:");  // in seconds
+			display.print(millis() / 1000);
+			display.print(" Loop:"); // in microseconds
+			display.println(loop_period_us);
 
-			// Row 4 -- 
-			display.print("Duration m: "); // in minutes
-			display.println(MissionValues.MissionList[StateValues.mission_index].duration);
+			// Rows 2 to 4 -- the three tasks with the longest run times. name max/mean us, overruns
+			{
+				bool shown[MaxNumberOfTasks] = {};
+				for (int row = 0; row < 3; row++)
+				{
+					int worst = -1;
+					for (int t = 0; t < SchedulerTaskCount(); t++)
+					{
+						const SchedulerTaskType* task = SchedulerGetTask(t);
+						if (task->action == NULL || shown[t])
+							continue;
+						if (worst < 0 || task->MaxRun_us > SchedulerGetTask(worst)->MaxRun_us)
+							worst = t;
+					}
+					if (worst < 0)
+						break;
+					shown[worst] = true;
+
+					const SchedulerTaskType* task = SchedulerGetTask(worst);
+					display.print(task->Name);
+					display.print(" ");
+					display.print(task->MaxRun_us);
+					display.print("/");
+					display.print(SchedulerMeanRun_us(task));
+					display.print(" o");
+					display.println(task->Overruns);
+				}
+			}
 			display.display();
 			break;
 
@@ -1780,7 +1811,8 @@ void HALDisplay::Page(char page)
 
 			// Row 2 -- Manoeuvre and Turn Heading 
 			display.print("Mv:");
-			display.print(CourseTypeToString(NavData.ManoeuvreState).substring(0,4));
+			FormatText(MsgString, sizeof(MsgString), "%.4s", CourseTypeToString(NavData.ManoeuvreState));
+			display.print(MsgString);
 
 			display.print(" TnHDG:");
 			display.print(NavData.TurnHDG);
@@ -1942,6 +1974,8 @@ void HALDisplay::Page(char page)
 	default:;
 
 	} //switch
+
+		I2CBusEnd(OLED_Device);
 	};// if (EquipmentStatus == EquipmentStatusType::Found) - real
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 // V1.0 16/6/2021
 // V1.1 14/11/2021 added Simulated GPS
 // V1.2 22/7/2023 removed GPS power controls.
+// V1.3 17/10/2026 simulated COG includes leeway.
 
 #include "HAL_GPS.h"
 
@@ -18,7 +19,8 @@
 
 extern HALGPS gps;
 extern NavigationDataType NavData;
-extern HardwareSerial* Serials[];
+extern Stream* Serials[];
+extern HardwareSerial* UARTs[];
 extern configValuesType Configuration;
 
 extern bool UseSimulatedVessel;			// flag to disable the GPS and indicate that the current location is simulated 
@@ -38,7 +40,7 @@ void HALGPS::Init() {
 	// V1.3 6/4/2019 added delay at the end, because it seems solve a lock up problem.
 	// V1.4 13/2/2022 added receive memory buffer as per pjrc.com tiny gps blog article
 
-	(*Serials[Configuration.GPSPort]).begin(9600);
+	(*UARTs[Configuration.GPSPort]).begin(9600);
 
 	// Enable the GPS - set the control pin to output and set high initially.
 	//pinMode(GPSEnablePin, OUTPUT);
@@ -48,7 +50,7 @@ void HALGPS::Init() {
 
 	// setup buffer as 100 bytes
 	static char SerialReadBuffer[100];
-	(*Serials[Configuration.GPSPort]).addMemoryForRead(SerialReadBuffer, 100);
+	(*UARTs[Configuration.GPSPort]).addMemoryForRead(SerialReadBuffer, 100);
 
 	Serial.println(F("*** Initialising GPS.."));
 	EquipmentStatus = EquipmentStatusType::Unknown;
@@ -155,7 +157,7 @@ void HALGPS::Read() {
 		NavData.Currentloc.lng = simulated_vessel.Currentloc.lng;
 		NavData.CurrentLocTimeStamp = millis();
 
-		NavData.COG = simulated_vessel.Heading;
+		NavData.COG = simulated_vessel.COG;
 		NavData.SOG_mps = simulated_vessel.SOG_mps;
 		NavData.SOG_knt = simulated_vessel.SOG_mps * 1.94384449; // knot/mps;
 	}
@@ -7,12 +7,15 @@
 #include "HAL_IMU.h"
 //#include "i2c_driver_wire.h"  // Teensy 4.1 I2C driver
 #include "i2c_t3.h"
+#include "I2CManager.h"
+#include "CompassBench.h"
 
 
 #include "DisplayStrings.h"
 #include "configValues.h"
 
 extern configValuesType Configuration;
+extern HALIMU imu;
 //extern I2CDriverWire* Wires[3]; // array for I2C wire 
 
 void HALIMU::Init()
@@ -32,7 +35,11 @@ void HALIMU::Init()
     { Configuration.CompassMaxX, Configuration.CompassMaxY, Configuration.CompassMaxZ };
 
     compass.enable();
+    compass.setOversampling(Configuration.CompassOversampling);
     compass.EnableCalibration(false);
+    IMU_Calibration_Init();
+    ResetMagCalibration(MagFit);
+    MagFitResult.Valid = false;
     if (compass.DeviceOk)
         EquipmentStatus = EquipmentStatusType::Found;
     else
@@ -47,13 +54,88 @@ void HALIMU::Init()
 
 void HALIMU::Read()
 {
-    compass.read();
+    // V1.1 17/10/2026 take the results of the read started by StartRead at the end of the previous FastLoop.
+    // Before the first StartRead, e.g. in setup, read while waiting.
+    // V1.2 17/10/2026 each new reading is added to the background ellipsoid fit, and to any bench recording.
+    // V1.3 17/10/2026 not read if the compass wasn't found. The driver waits for the data with no timeout.
+    if (!compass.DeviceOk)
+    {
+        return;
+    }
+    if (!ReadStarted)
+    {
+        I2CBusBegin(compass.accDevice);
+        compass.read();
+        TemperatureC = compass.readTempC();
+        I2CBusEnd(compass.accDevice);
+    }
+    else if (compass.collect())
+    {
+        TemperatureC = compass.temperatureC;
+    }
+    else
+    {
+        // no new results. Keep the last values.
+        return;
+    }
 
     Heading = wrap_360_Int(compass.getNavigationAngle() - Configuration.CompassOffsetAngle);
     Pitch = -1 * compass.pitch;
     Roll = compass.roll - Configuration.RollEror;
 
-    TemperatureC = compass.readTempC();
+    // add the reading to the background ellipsoid fit, and to any bench recording.
+    MagFit.AddSample(compass.magnetometer.x, compass.magnetometer.y, compass.magnetometer.z);
+
+    const int16_t mag[3] = { compass.magnetometer.x, compass.magnetometer.y, compass.magnetometer.z };
+    const int16_t acc[3] = { compass.accelerometer.x, compass.accelerometer.y, compass.accelerometer.z };
+    CompassBenchSample(mag, acc);
+}
+
+void HALIMU::FitMagCalibration()
+{
+    // solve the background fit. A 9 term Cholesky solve and a 3x3 eigen decomposition, well under a millisecond.
+    // V1.0 17/10/2026 John Semmens
+    MagFit.Fit(MagFitResult);
+}
+
+void HALIMU::ResetMagCalibration(EllipsoidFit& fit)
+{
+    // start the fit from the min/max calibration in the configuration.
+    // V1.0 17/10/2026 John Semmens
+    float centre[3] = {
+        ((float)Configuration.CompassMinX + Configuration.CompassMaxX) / 2,
+        ((float)Configuration.CompassMinY + Configuration.CompassMaxY) / 2,
+        ((float)Configuration.CompassMinZ + Configuration.CompassMaxZ) / 2 };
+    float radius[3] = {
+        ((float)Configuration.CompassMaxX - Configuration.CompassMinX) / 2,
+        ((float)Configuration.CompassMaxY - Configuration.CompassMinY) / 2,
+        ((float)Configuration.CompassMaxZ - Configuration.CompassMinZ) / 2 };
+    fit.Reset(centre, radius);
+}
+
+void HALIMU::StartRead()
+{
+    // start reading the compass in the background, ready for the next Read.
+    // V1.0 17/10/2026 John Semmens
+    compass.startRead();
+    ReadStarted = compass.DeviceOk;
+}
+
+void IMU_Oversampling_Init(void)
+{
+    // apply the CompassOversampling parameter.
+    // V1.0 17/10/2026 John Semmens
+    // V1.1 17/10/2026 the bus is held with the I2C manager while the registers are written.
+    I2CBusBegin(imu.compass.accDevice);
+    imu.compass.setOversampling(Configuration.CompassOversampling);
+    I2CBusEnd(imu.compass.accDevice);
+}
+
+void IMU_Calibration_Init(void)
+{
+    // apply the CompassEllipsoid parameter, with the saved ellipsoid calibration.
+    // V1.0 17/10/2026 John Semmens
+    imu.compass.setEllipsoidCalibration(Configuration.CompassEllipsoid, Configuration.CompassSoftIron, Configuration.CompassHardIron);
 }
 
 
@@ -11,6 +11,7 @@
 
 #include "HAL.h"
 #include "MagneticSensorLsm303.h"
+#include "MagCalibration.h"
 
 class HALIMU
 {
@@ -25,10 +26,23 @@ public:
 
 	void Init();
 	void Read();
+	void StartRead();	// start a background read of the compass, for the next Read.
 	MagneticSensorLsm303 compass;
 	EquipmentStatusType EquipmentStatus;
+
+	// ellipsoid calibration, fitted in the background to the compass readings. See MagCalibration.h.
+	EllipsoidFit MagFit;
+	MagCalibrationType MagFitResult;
+	void FitMagCalibration();	// solve the fit into MagFitResult
+	void ResetMagCalibration(EllipsoidFit& fit);	// start a fit from the min/max calibration
+
+private:
+	bool ReadStarted = false;
 };
 
+void IMU_Oversampling_Init(void);
+void IMU_Calibration_Init(void);
+
 
 
 #endif
@@ -1,18 +1,23 @@
 // 
 // 
-// 
+// V1.1 17/10/2026 added accumulation of Battery Out current with the scheduler idle mode on and off.
+// V1.2 17/10/2026 the I2C bus is held with the I2C manager while the INA3221 is read.
 
 #include "HAL_PowerMeasurement.h"
 #include "i2c_t3.h"
 #include "SDL_Arduino_INA3221.h"
+#include "I2CManager.h"
 
 SDL_Arduino_INA3221 ina3221;
+static int INA3221_Device = -1;	// I2C manager device
 
 void HALPowerMeasure::init()
 {
 	Serial.println(F("*** Initialising V/I Measurement..."));
     EquipmentStatus = EquipmentStatusType::Unknown;
+    ResetIdleCurrent();
 
+    INA3221_Device = I2CAddDevice(0, INA3221_ADDRESS, "INA3221");
     ina3221.begin();
 
     Serial.print("Manufacturer's ID=0x");
@@ -37,6 +42,8 @@ void HALPowerMeasure::init()
 
 void HALPowerMeasure::read()
 {
+    I2CBusBegin(INA3221_Device);
+
     Solar_V = ina3221.getBusVoltage_V(Solar);
     Solar_I = ina3221.getCurrent_mA(Solar);
 
@@ -45,5 +52,43 @@ void HALPowerMeasure::read()
 
     BatteryOut_V = ina3221.getBusVoltage_V(BatteryOut);
     BatteryOut_I =  -1 * ina3221.getCurrent_mA(BatteryOut);
+
+    I2CBusEnd(INA3221_Device);
+}
+
+void HALPowerMeasure::AccumulateIdleCurrent(bool IdleEnabled)
+{
+    // add the latest Battery Out current to the total for the current idle mode.
+    // V1.0 17/10/2026 John Semmens
+    if (EquipmentStatus != EquipmentStatusType::Found)
+        return;
+
+    if (IdleEnabled)
+    {
+        IdleOn_I_Sum += BatteryOut_I;
+        IdleOn_Count++;
+    }
+    else
+    {
+        IdleOff_I_Sum += BatteryOut_I;
+        IdleOff_Count++;
+    }
 }
 
+float HALPowerMeasure::IdleCurrent_mA(bool IdleEnabled)
+{
+    // return the mean Battery Out current for the given idle mode.
+    // V1.0 17/10/2026 John Semmens
+    if (IdleEnabled)
+        return IdleOn_Count ? IdleOn_I_Sum / IdleOn_Count : 0;
+    else
+        return IdleOff_Count ? IdleOff_I_Sum / IdleOff_Count : 0;
+}
+
+void HALPowerMeasure::ResetIdleCurrent(void)
+{
+    IdleOn_I_Sum = 0;
+    IdleOn_Count = 0;
+    IdleOff_I_Sum = 0;
+    IdleOff_Count = 0;
+}
@@ -25,10 +25,20 @@ public:
 	float BatteryOut_V;
 	float BatteryOut_I;
 
+	// Battery Out current accumulated separately with the scheduler idle mode on and off,
+	// to compare the controller current draw of each mode.
+	float IdleOn_I_Sum;
+	unsigned long IdleOn_Count;
+	float IdleOff_I_Sum;
+	unsigned long IdleOff_Count;
 
 	void read(void);
 	void init(void);
 
+	void AccumulateIdleCurrent(bool IdleEnabled);
+	float IdleCurrent_mA(bool IdleEnabled);
+	void ResetIdleCurrent(void);
+
 	EquipmentStatusType EquipmentStatus;
 };
 
@@ -14,6 +14,19 @@
 // V1.17 8/1/2022 updated WSP to record voltages with 3 digits to observe discharge rates.
 // V1.18 19/6/2022 added GPSPwr sentence as Event.
 // V1.19 22/7/2023 removed GPS power controls. 
+// V1.20 17/10/2026 added Task sentence, the scheduler task execution time profile, logged each minute.
+// V1.21 17/10/2026 added IdlePct and Idle to SYS sentence.
+// V1.22 17/10/2026 added SimRun sentence, the results of each simulated batch run. Decision events are passed to the batch runner.
+// V1.23 17/10/2026 added the run seed to the SimRun sentence.
+// V1.24 17/10/2026 decision events are counted, not logged, during a log replay.
+// V1.25 17/10/2026 added optional binary 1 second records, written to a .bin file. Decoded with lbd.
+// V1.26 17/10/2026 log files are written through the buffered log writer. Added LogQ, LogWr_us and LogOvf to SYS.
+// V1.27 17/10/2026 decision events trigger the flight recorder. The flight recorder file is rolled with the log file.
+// V1.28 17/10/2026 file names and messages are formatted into fixed buffers rather than Strings. Added HeapPeak and HeapRises to SYS.
+// V1.29 17/10/2026 binary log decode is done in ranges of records, patting the watchdog.
+// V1.30 17/10/2026 the simulation seed is written as a header line of each log file, and again when it is set.
+// V1.31 17/10/2026 added HeapCalls to SYS, the heap allocator calls since setup.
+// V1.32 17/10/2026 messages and mission steps raised by the navigation during a log replay are not logged.
 
 #include "HAL.h"
 #include "Sd.h"
@@ -31,8 +44,19 @@
 #include "HAL_Time.h"
 #include "TimeLib.h"
 #include "InternalTemperature.h"
-
-extern File LogFile;
+#include "SchedulerCooperative.h"
+#include "sim_batch.h"
+#include "sim_weather.h"
+#include "LogReplay.h"
+#include "HAL_SDLogWriter.h"
+#include "FlightRecorder.h"
+#include "TextFormat.h"
+#include "HeapMonitor.h"
+#include "HAL_Watchdog.h"
+
+extern HALSDLogWriter LogFile;
+extern HALSDLogWriter LogBinaryFile;
+extern HALSDLogWriter FlightRecorderFile;
 
 #define  SD_Card_CS_PIN BUILTIN_SDCARD // 10 on Nano, 53 on Mega, E3 on Teensy 3.6   
 
@@ -43,11 +67,12 @@ extern long loop_period_us; // microseconds between successive main loop executi
 
 extern bool UseSimulatedVessel; 	// flag to disable the GPS and indicate that the current location is simulated 
 extern configValuesType Configuration;
-extern HardwareSerial* Serials[];
+extern Stream* Serials[];
 extern bool SD_Card_Present;
 extern uint32_t SSSS;
 extern uint32_t Minute;
-extern String LogFileName;
+extern uint32_t SimulationSeed;
+extern char LogFileName[];
 
 extern HALIMU imu;
 
@@ -66,6 +91,21 @@ extern char Version[];
 //extern WaveClass Wave;
 extern HALServo servo;
 
+// text schema of LogBinaryRecordType, written as the first line of each .bin file.
+// name:type, where the type is u8, i16, i32, u32 or f32.
+// keep this in step with LogBinaryRecordType.
+static const char LogBinarySchema[] =
+	"Sync:u8,Version:u8,Length:u16,Time:u32,SSSS:u32,"
+	"LAT:i32,LON:i32,COG:i16,SOG:f32,"
+	"HDG_T:i16,Pitch:i16,Roll:i16,ROLL_Avg:i16,HDG_Mag:i16,HDG_Err:i16,"
+	"CTS:i16,BTW:i16,AWA:i16,CTE:i16,MaxCTE:i16,TackDurn:i32,TurnHDG:i16,TargetHDG:i16,CourseType:u8,InIrons:u8,"
+	"DTW:i32,RLB:i16,Sailable:u8,WingAngle:i16,AWD:i16,TWD:i16,CDA:i16,MaxCTEHold:u8,"
+	"LocationAge:i32,SimulatedGPS:u8,Loc_Valid:u8,"
+	"Steer:i16,TTA:i16,ServoPwr:u8,"
+	"VMG:f32,VMC:f32,AWA_Avg:f32,SOG_Avg:f32";
+extern sim_batch simulated_batch;
+extern sim_weather simulated_weather;
+
 void dateTime(uint16_t* date, uint16_t* time)
 {
 	// V1.0 1/10/2016 John Semmens
@@ -102,6 +142,15 @@ void LogTimeHeader(void)
 	LogFile.print(Configuration.SDCardLogDelimiter);
 }
 
+void LogSeedHeader(void)
+{
+	// header line with the seed of the simulated weather and vessel, so a simulated log can be repeated from its seed.
+	// V1.0 17/10/2026 John Semmens
+	LogFile.print(F("Seed"));
+	LogTimeHeader();
+	LogFile.println(SimulationSeed);
+}
+
 void SD_Logging_Init() {
 	// V1.0 1/10/2016 John Semmens
 	// V1.1 22/10/2016 updated to support parameterised serial port
@@ -132,14 +181,10 @@ void SD_Logging_OpenFile() {
 	// V1.1 22/10/2016 updated to support parameterised serial port
 	// V1.2 30/10/2017 added IMU status to Attitude
 	// V1.3 9/1/2022 changed filename to be <boot number>-<minute number>.log
+	// V1.5 17/10/2026 formatted into LogFileName, rather than built from Strings.
 
-	// set up 8.3 filename
-	int BL = String(VesselUsageCounters.BootCounter).length();
-	int ML = String(Minute).length();
-
-	String BootString = ("000" + String(VesselUsageCounters.BootCounter)).substring(BL, BL + 3);
-	String MinuteString = ("00000" + String(Minute)).substring( ML,  ML + 5);
-	LogFileName = BootString + MinuteString + ".log";
+	// set up 8.3 filename, from the last 3 digits of the boot number and the last 5 digits of the minute number.
+	FormatText(LogFileName, LogFileNameSize, "%03lu%05lu.log", (unsigned long)(VesselUsageCounters.BootCounter % 1000), (unsigned long)(Minute % 100000));
 
 
 	Serial.print(F("Open SD Card Logfile:"));
@@ -147,6 +192,22 @@ void SD_Logging_OpenFile() {
 	OpenSDLogFile(LogFileName);
 	delay(30);
 
+	// V1.4 17/10/2026 open the binary log file, and write the record schema as its first line.
+	if (Configuration.SDCardLogBinary)
+	{
+		char BinaryFileName[LogFileNameSize];
+		strcpy(BinaryFileName, LogFileName);
+		strcpy(BinaryFileName + 8, ".bin");
+		LogBinaryFile.open(BinaryFileName);
+		LogBinaryFile.print(F("VBL,"));
+		LogBinaryFile.print(LogBinaryVersion);
+		LogBinaryFile.print(',');
+		LogBinaryFile.print(sizeof(LogBinaryRecordType));
+		LogBinaryFile.print(',');
+		LogBinaryFile.println(LogBinarySchema);
+		LogBinaryFile.flush();
+	}
+
 	// Log_Location  loc - Time, Lat, Lon
 	LogFile.print(F("Data"));
 	LogTimeHeader();
@@ -175,6 +236,8 @@ void SD_Logging_OpenFile() {
 	LogFile.print(F("Field12"));
 	LogFile.println();
 
+	LogSeedHeader();
+
 
 	// Log_Location  loc - Time, Lat, Lon
 	LogFile.print(F("LOC"));
@@ -283,6 +346,22 @@ void SD_Logging_OpenFile() {
 	LogFile.print(F("Press"));
 	LogFile.print(Configuration.SDCardLogDelimiter);
 	LogFile.print(F("CPUTemp"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("IdlePct"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Idle"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("LogQ"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("LogWr_us"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("LogOvf"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("HeapPeak"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("HeapRises"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("HeapCalls"));
 	LogFile.println();
 
 	LogFile.print(F("GPS"));
@@ -451,12 +530,64 @@ void SD_Logging_OpenFile() {
 	LogFile.print(F("SOG_Avg"));
 	LogFile.println();
 
+	// Simulated batch run results
+	LogFile.print(F("SimRun"));
+	LogTimeHeader();
+	LogFile.print(F("Run"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Seed"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("TimedOut"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("WindDir"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Distance_m"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Tacks"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("InIrons"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("MaxCTE"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("MissionTime_s"));
+	LogFile.println();
+
+	// Task execution time profile
+	LogFile.print(F("Task"));
+	LogTimeHeader();
+	LogFile.print(F("Index"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Name"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Runs"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Min_us"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Mean_us"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Max_us"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("Overruns"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("MissedDeadlines"));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(F("MaxLateness_ms"));
+	for (int i = 0; i < SchedulerHistogramBuckets; i++)
+	{
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(F("Hist"));
+		LogFile.print(i);
+	}
+	LogFile.println();
+
 	// log software version and other userful data at the start of each log file
 	// log the OS version to the SD Card
 	SD_Logging_Event_Messsage(Version);
 
 	// log the boot count to the SD Card
-	SD_Logging_Event_Messsage("Boot: " + String(VesselUsageCounters.BootCounter));
+	char message[24];
+	FormatText(message, sizeof(message), "Boot: %lu", (unsigned long)VesselUsageCounters.BootCounter);
+	SD_Logging_Event_Messsage(message);
 
 	// log the usage values at start up.
 	SD_Logging_Event_Usage();
@@ -464,11 +595,12 @@ void SD_Logging_OpenFile() {
 	LogFile.flush();
 }
 
-void OpenSDLogFile(String LogFileName) {
+void OpenSDLogFile(const char* LogFileName) {
 	// open the file. note that only one file can be open at a time,
 	// so you have to close this one before opening another.
 
-	LogFile = SD.open(LogFileName.c_str(), FILE_WRITE);
+	// V1.1 17/10/2026 opened through the log writer. Any current file is closed once its buffered data is written.
+	LogFile.open(LogFileName);
 };
 
 void LogTime(void)
@@ -502,6 +634,15 @@ void SD_Logging_1s()
 	// V1.4 10/12/2017 added Check_LogFileSize to this logging procedure, rather than calling separately.
 	// V1.5 1/11/2021 removed mask because it wasn't used.
 	// V1.6 30/10/2022 added AWD to NAV
+	// V1.7 17/10/2026 write a binary record instead, if configured.
+	// The binary file is opened with the next log file, so a change to the setting takes effect from then.
+
+	if (Configuration.SDCardLogBinary && LogBinaryFile)
+	{
+		SD_Logging_1s_Binary();
+		Check_LogFileSize();
+		return;
+	}
 
 	char FloatString[16];
 
@@ -631,6 +772,191 @@ void SD_Logging_1s()
 }
 
 
+void SD_Logging_1s_Binary(void)
+{
+	// write the 1 second records as one binary record, in a single write to the file buffer.
+	// The values are the same as those of the LOC, ATT, SAI, NAV, GPS, SVO and Perf text records.
+	// V1.0 17/10/2026 John Semmens
+	LogBinaryRecordType r;
+
+	r.Sync = LogBinarySync;
+	r.Version = LogBinaryVersion;
+	r.Length = sizeof(r);
+	r.Time = now();
+	r.SSSS = SSSS;
+
+	r.Lat = NavData.Currentloc.lat;
+	r.Lon = NavData.Currentloc.lng;
+	r.COG = NavData.COG;
+	r.SOG_mps = NavData.SOG_mps;
+
+	r.HDG = NavData.HDG;
+	r.Pitch = (int)imu.Pitch;
+	r.Roll = (int)imu.Roll;
+	r.ROLL_Avg = NavData.ROLL_Avg;
+	r.HDG_Mag = NavData.HDG_Mag;
+	r.HDG_Err = NavData.HDG_Err;
+
+	r.CTS = NavData.CTS;
+	r.BTW = NavData.BTW;
+	r.AWA = NavData.AWA;
+	r.CTE = NavData.CTE;
+	r.MaxCTE = NavData.MaxCTE;
+	r.TackDuration = NavData.TackDuration;
+	r.TurnHDG = NavData.TurnHDG;
+	r.TargetHDG = NavData.TargetHDG;
+	r.CourseType = NavData.CourseType;
+	r.InIronsState = NavData.InIronsState;
+
+	r.DTW = NavData.DTW;
+	r.RLB = NavData.RLB;
+	r.Sailable = NavData.IsBTWSailable;
+	r.WingAngle = WingSail.Angle;
+	r.AWD = NavData.AWD;
+	r.TWD = NavData.TWD;
+	r.CDA = NavData.CDA;
+	r.PastBoundaryHold = NavData.PastBoundaryHold;
+
+	r.LocationAge = gps.Location_Age;
+	r.SimulatedGPS = UseSimulatedVessel;
+	r.LocValid = gps.GPS_LocationIs_Valid(NavData.Currentloc);
+
+	r.Steer = servo.ServoPulseWidth;
+	r.TTA = WingSail.TrimTabAngle;
+	r.ServoPwr = servo.PoweredOn;
+
+	r.VMG = NavData.VMG;
+	r.VMC = NavData.VMC;
+	r.AWA_Avg = NavData.AWA_Avg;
+	r.SOG_Avg = NavData.SOG_Avg;
+
+	LogBinaryFile.write((const uint8_t*)&r, sizeof(r));
+	LogBinaryFile.flush();
+}
+
+bool SD_Logging_DecodeBinary(const char* filename, Print& out, unsigned long first, unsigned long count, unsigned long& next)
+{
+	// decode count records of a binary log file, from record number first, to delimited text, one line per record.
+	// The first range, from record 0, starts with a header line of the column names.
+	// A whole file takes many minutes to send over a slow port, so it is decoded a range at a time, 
+	// and the watchdog is patted as the records are sent.
+	// Records of another version or length are skipped, by searching for the next sync byte.
+	// The range starts at the position of the first record in a file of whole records, then at the next sync byte.
+	// next is set to the record number after the range, or 0 if the end of the file was reached.
+	// Returns false if the file could not be opened.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 decode a range of records, patting the watchdog.
+	File BinaryFile = SD.open(filename);
+	if (!BinaryFile)
+	{
+		return false;
+	}
+
+	// skip the schema line
+	while (BinaryFile.available() && BinaryFile.read() != '\n');
+
+	LogBinaryRecordType r;
+	char d = Configuration.SDCardLogDelimiter;
+
+	if (first == 0)
+	{
+		// column names from the schema, leaving out Sync, Version and Length.
+		const char* c = strstr(LogBinarySchema, "Time:");
+		while (*c)
+		{
+			if (*c == ':')
+			{
+				while (*c && *c != ',') c++;
+				if (*c) out.print(d);
+			}
+			else
+			{
+				out.print(*c);
+			}
+			if (*c) c++;
+		}
+		out.println();
+	}
+	else
+	{
+		BinaryFile.seek(BinaryFile.position() + first * sizeof(r));
+	}
+
+	unsigned long decoded = 0;
+	next = 0;
+	while (BinaryFile.available() >= (int)sizeof(r))
+	{
+		if (decoded >= count)
+		{
+			next = first + decoded;
+			break;
+		}
+
+		if (BinaryFile.peek() != LogBinarySync)
+		{
+			BinaryFile.read();
+			continue;
+		}
+
+		BinaryFile.read(&r, sizeof(r));
+		if (r.Version != LogBinaryVersion || r.Length != sizeof(r))
+		{
+			BinaryFile.seek(BinaryFile.position() - sizeof(r) + 1);
+			continue;
+		}
+
+		out.print(r.Time); out.print(d);
+		out.print(r.SSSS); out.print(d);
+		out.print(r.Lat / 10000000.0, 5); out.print(d);
+		out.print(r.Lon / 10000000.0, 5); out.print(d);
+		out.print(r.COG); out.print(d);
+		out.print(r.SOG_mps); out.print(d);
+		out.print(r.HDG); out.print(d);
+		out.print(r.Pitch); out.print(d);
+		out.print(r.Roll); out.print(d);
+		out.print(r.ROLL_Avg); out.print(d);
+		out.print(r.HDG_Mag); out.print(d);
+		out.print(r.HDG_Err); out.print(d);
+		out.print(r.CTS); out.print(d);
+		out.print(r.BTW); out.print(d);
+		out.print(r.AWA); out.print(d);
+		out.print(r.CTE); out.print(d);
+		out.print(r.MaxCTE); out.print(d);
+		out.print(r.TackDuration); out.print(d);
+		out.print(r.TurnHDG); out.print(d);
+		out.print(r.TargetHDG); out.print(d);
+		out.print(CourseTypeToString((SteeringCourseType)r.CourseType)); out.print(d);
+		out.print(GetInIronsStatusString((InIronsStateType)r.InIronsState)); out.print(d);
+		out.print(r.DTW); out.print(d);
+		out.print(r.RLB); out.print(d);
+		out.print(r.Sailable ? "Y" : "N"); out.print(d);
+		out.print(r.WingAngle); out.print(d);
+		out.print(r.AWD); out.print(d);
+		out.print(r.TWD); out.print(d);
+		out.print(r.CDA); out.print(d);
+		out.print(r.PastBoundaryHold ? "Y" : "N"); out.print(d);
+		out.print(r.LocationAge); out.print(d);
+		out.print(r.SimulatedGPS); out.print(d);
+		out.print(r.LocValid); out.print(d);
+		out.print(r.Steer); out.print(d);
+		out.print(r.TTA); out.print(d);
+		out.print(r.ServoPwr); out.print(d);
+		out.print(r.VMG); out.print(d);
+		out.print(r.VMC); out.print(d);
+		out.print(r.AWA_Avg); out.print(d);
+		out.println(r.SOG_Avg);
+
+		decoded++;
+		if ((decoded % 20) == 0)
+		{
+			Watchdog_Pat();
+		}
+	}
+
+	BinaryFile.close();
+	return true;
+}
+
 void SD_Logging_1m()
 {
 	// medium logging at 1 minute interval
@@ -649,7 +975,24 @@ void SD_Logging_1m()
 	//LogFile.print(dtostrf(imu.Baro, 7, 1, FloatString));
 	LogFile.print(Configuration.SDCardLogDelimiter);
 	LogFile.print(dtostrf(InternalTemperature.readTemperatureC(), 5, 1, FloatString));
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(SchedulerIdlePercent());
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(SchedulerIdleEnabled());
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(LogFile.MaxQueueDepth);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(LogFile.MaxWrite_us);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(LogFile.Overflows);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(HeapMonitorStats().Peak);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(HeapMonitorStats().SteadyStateRises);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(HeapMonitorStats().SteadyStateCalls);
 	LogFile.println();
+	LogFile.ResetStatistics();
 
   // VPwr values
 	LogFile.print(F("VPwr"));
@@ -694,9 +1037,50 @@ void SD_Logging_1m()
 
 	SD_Logging_Waypoint();
 
+	SD_Logging_TaskProfile();
+
 	LogFile.flush();
 }
 
+void SD_Logging_TaskProfile(void)
+{
+	// log the execution time profile of each scheduler task.
+	// Histogram bucket n counts runs of 2^n to 2^(n+1)-1 microseconds.
+	// V1.0 17/10/2026 John Semmens
+	for (int t = 0; t < SchedulerTaskCount(); t++)
+	{
+		const SchedulerTaskType* task = SchedulerGetTask(t);
+		if (task->action == NULL)
+			continue;
+
+		LogFile.print(F("Task"));
+		LogTime();
+		LogFile.print(t);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->Name);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->RunCount);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->MinRun_us);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(SchedulerMeanRun_us(task));
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->MaxRun_us);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->Overruns);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->MissedDeadlines);
+		LogFile.print(Configuration.SDCardLogDelimiter);
+		LogFile.print(task->MaxLateness_ms);
+		for (int i = 0; i < SchedulerHistogramBuckets; i++)
+		{
+			LogFile.print(Configuration.SDCardLogDelimiter);
+			LogFile.print(task->Histogram[i]);
+		}
+		LogFile.println();
+	}
+}
+
 
 void SD_Logging_Waypoint()
 {
@@ -735,11 +1119,24 @@ void Check_LogFileSize()
 	if (LogFile.size() >= (uint32_t(Configuration.MaxFileSize) * 1024)) {
 		CloseThenOpenLogFile();
 		}
+
+	// V1.1 17/10/2026 check the binary log file too.
+	if (LogBinaryFile && LogBinaryFile.size() >= (uint32_t(Configuration.MaxFileSize) * 1024)) {
+		CloseThenOpenLogFile();
+	}
 }
 
 void CloseThenOpenLogFile(void)
 {
 	LogFile.close();
+	if (LogBinaryFile)
+	{
+		LogBinaryFile.close();
+	}
+	if (FlightRecorderFile)
+	{
+		FlightRecorderFile.close();
+	}
 	SD_Logging_OpenFile();
 };
 
@@ -747,6 +1144,13 @@ void CloseThenOpenLogFile(void)
 void SD_Logging_Event_Decisions(void)
 {
 	// Log_Decisions  dec - Time, command state, decision, decsion reason, and Decision event Value.
+	if (LogReplay_CaptureDecision())
+	{
+		return;
+	}
+
+	FlightRecorder_Trigger(frtDecision);
+
 	LogFile.print(F("DEC"));
 	LogTime();
 	LogFile.print(StateValues.mission_index);
@@ -761,6 +1165,36 @@ void SD_Logging_Event_Decisions(void)
 	LogFile.print(Configuration.SDCardLogDelimiter);
 	LogFile.print(DecisionEventValue2);
 	LogFile.println();
+
+	// let the simulated batch runner count the tacks, in-irons events and waypoints.
+	simulated_batch.event(DecisionEvent, DecisionEventReason);
+}
+
+void SD_Logging_Event_SimRun(bool timed_out)
+{
+	// log the result of one run of a simulated batch.
+	// V1.0 17/10/2026 John Semmens
+	LogFile.print(F("SimRun"));
+	LogTime();
+	LogFile.print(simulated_batch.RunsCompleted);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.RunSeed);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(timed_out);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_weather.MajorWindDirection);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.Distance_m, 0);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.TackCount);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.InIronsCount);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.MaxCTE);
+	LogFile.print(Configuration.SDCardLogDelimiter);
+	LogFile.print(simulated_batch.RunTime_s, 0);
+	LogFile.println();
+	LogFile.flush();
 }
 
 void SD_Logging_Event_ParameterChange(int ParameterIndex, char ParameterValue[12])
@@ -774,9 +1208,16 @@ void SD_Logging_Event_ParameterChange(int ParameterIndex, char ParameterValue[12
 	LogFile.println();
 }
 
-void SD_Logging_Event_Messsage(String message)
+void SD_Logging_Event_Messsage(const char* message)
 {
 	// Log a message  - Time, message
+	// V1.1 17/10/2026 takes the message as text, rather than a String. Format the message with FormatText.
+	// V1.2 17/10/2026 not logged during a log replay, as the manoeuvre messages would be from the replayed voyage.
+	if (LogReplay_Active())
+	{
+		return;
+	}
+
 	LogFile.print(F("MSG"));
 	LogTime();
 	LogFile.print(message);
@@ -784,11 +1225,22 @@ void SD_Logging_Event_Messsage(String message)
 	LogFile.flush();
 }
 
+void SD_Logging_Event_Messsage(const __FlashStringHelper* message)
+{
+	SD_Logging_Event_Messsage((const char*)message);
+}
+
 void SD_Logging_Event_MissionStep(int mission_index)
 {
 	char FloatString[16];
 
 	// Log the mission step  - Time, message
+	// V1.1 17/10/2026 not logged during a log replay.
+	if (LogReplay_Active())
+	{
+		return;
+	}
+
 	LogFile.print(F("MIS"));
 	LogTime();
 	LogFile.print(mission_index);
@@ -848,7 +1300,7 @@ void SD_Logging_Event_Wingsail_Power(void)
 	LogFile.println();
 }
 
-void SD_Logging_Event_Wingsail_Monitor(String Description)
+void SD_Logging_Event_Wingsail_Monitor(const char* Description)
 {
 	LogFile.print(F("WSMon"));
 	LogTime();
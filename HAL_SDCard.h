@@ -9,13 +9,78 @@
 	#include "WProgram.h"
 #endif
 
+	static const int LogFileNameSize = 13;	// 8.3 file name and the terminating null
+
+	// Binary 1 second log record.
+	// When Configuration.SDCardLogBinary is set, the 1 second records are written in this form to a .bin file
+	// with the same name as the .log file. The file starts with a one line text schema, and then the records follow.
+	// Change LogBinaryVersion and the schema when the record is changed.
+	static const byte LogBinaryVersion = 1;
+	static const byte LogBinarySync = 0xA5;
+
+	struct __attribute__((packed)) LogBinaryRecordType {
+		byte Sync;				// LogBinarySync, to find the start of a record.
+		byte Version;			// LogBinaryVersion
+		uint16_t Length;		// record size in bytes
+		uint32_t Time;			// seconds since 1970 (TimeLib now())
+		uint32_t SSSS;			// seconds since boot
+
+		int32_t Lat;			// degrees * 10^7
+		int32_t Lon;
+		int16_t COG;
+		float SOG_mps;
+
+		int16_t HDG;
+		int16_t Pitch;
+		int16_t Roll;
+		int16_t ROLL_Avg;
+		int16_t HDG_Mag;
+		int16_t HDG_Err;
+
+		int16_t CTS;
+		int16_t BTW;
+		int16_t AWA;
+		int16_t CTE;
+		int16_t MaxCTE;
+		int32_t TackDuration;
+		int16_t TurnHDG;
+		int16_t TargetHDG;
+		byte CourseType;
+		byte InIronsState;
+
+		int32_t DTW;
+		int16_t RLB;
+		byte Sailable;
+		int16_t WingAngle;
+		int16_t AWD;
+		int16_t TWD;
+		int16_t CDA;
+		byte PastBoundaryHold;
+
+		int32_t LocationAge;
+		byte SimulatedGPS;
+		byte LocValid;
+
+		int16_t Steer;
+		int16_t TTA;
+		byte ServoPwr;
+
+		float VMG;
+		float VMC;
+		float AWA_Avg;
+		float SOG_Avg;
+	};
+
 	void SD_Logging_Init();
 	void SD_Logging_OpenFile();
 	void SD_Logging_1s(void);
 	void SD_Logging_1m(void);
 	void SD_Logging_Waypoint(void);
+	void SD_Logging_TaskProfile(void);
+	void SD_Logging_1s_Binary(void);
+	bool SD_Logging_DecodeBinary(const char* filename, Print& out, unsigned long first, unsigned long count, unsigned long& next);
 
-	void OpenSDLogFile(String LogFileName);
+	void OpenSDLogFile(const char* LogFileName);
 
 	void Check_LogFileSize(void);
 	void CloseThenOpenLogFile(void);
@@ -24,15 +89,18 @@
 	void SD_Logging_Event_Decisions(void);
 	void SD_Logging_Event_Usage(void);
 	void SD_Logging_Event_ParameterChange(int ParameterIndex, char ParameterValue[12]);
-	void SD_Logging_Event_Messsage(String message);
+	void SD_Logging_Event_Messsage(const char* message);
+	void SD_Logging_Event_Messsage(const __FlashStringHelper* message);
 	void SD_Logging_Event_MissionStep(int mission_index);
+	void SD_Logging_Event_SimRun(bool timed_out);
 
 	void SD_Logging_Event_Wingsail_Power(void);
-	void SD_Logging_Event_Wingsail_Monitor(String Description);
+	void SD_Logging_Event_Wingsail_Monitor(const char* Description);
 	//void SD_Logging_Event_GPS_Power(void);
 
 	void LogTime(void);
 	void LogTimeHeader(void);
+	void LogSeedHeader(void);
 	void dateTime(uint16_t* date, uint16_t* time);
 #endif
 
@@ -0,0 +1,196 @@
+// Buffered SD card log file writer.
+// The logging code prints its records into a RAM ring buffer. drain() is called from its own scheduler task,
+// and each call does at most one of: write one sector (or the partial sector when a flush is requested),
+// update the file directory entry, or close and open a file.
+// This keeps the time in each call to about one sector write, rather than the whole 1 second log and flush,
+// or a file close and open, blocking the loop at once.
+// The current file size includes the buffered bytes, so that the file size limit check is not delayed by the buffer.
+// drain() returns true if it wrote to the card, so the SD writer task can stop at one writer's sector each call.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 the buffer given to the constructor. drain() returns whether it wrote to the card.
+
+#include "HAL_SDLogWriter.h"
+
+bool HALSDLogWriter::open(const char* filename)
+{
+	// open the log file for appending.
+	// If a file is open, or data is waiting, the open is queued behind the data already buffered.
+	// Only one open can be queued. Returns false if another file is still waiting to be opened,
+	// leaving that open, and the data already buffered for it, as they are. A queued close is replaced by the open.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 a second open while one is queued is rejected, rather than replacing the queued file name.
+	if (OpenPending && PendingName[0])
+	{
+		return false;
+	}
+
+	FileSize = 0;
+
+	if (!LogFile && !OpenPending && Head == Tail)
+	{
+		LogFile = SD.open(filename, FILE_WRITE);
+		if (LogFile)
+		{
+			FileSize = LogFile.size();
+		}
+		return LogFile;
+	}
+
+	strncpy(PendingName, filename, sizeof(PendingName) - 1);
+	PendingName[sizeof(PendingName) - 1] = '\0';
+	OpenPending = true;
+	RotateAt = Head;
+	return true;
+}
+
+void HALSDLogWriter::close(void)
+{
+	// close the file once the data buffered for it has been written.
+	// V1.0 17/10/2026 John Semmens
+	PendingName[0] = '\0';
+	OpenPending = true;
+	RotateAt = Head;
+}
+
+size_t HALSDLogWriter::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t HALSDLogWriter::write(const uint8_t* buf, size_t size)
+{
+	// put the bytes into the ring buffer. Bytes that don't fit are counted and discarded.
+	// V1.0 17/10/2026 John Semmens
+	if (!*this)
+	{
+		return 0;
+	}
+
+	uint32_t space = BufferSize - (Head - Tail);
+	if (size > space)
+	{
+		Overflows += size - space;
+		size = space;
+	}
+
+	for (size_t i = 0; i < size; i++)
+	{
+		Buffer[(Head + i) & (BufferSize - 1)] = buf[i];
+	}
+	Head += size;
+	FileSize += size;
+
+	if (Head - Tail > MaxQueueDepth)
+	{
+		MaxQueueDepth = Head - Tail;
+	}
+	return size;
+}
+
+void HALSDLogWriter::flush(void)
+{
+	// request that the buffered data is written and the file updated. This doesn't wait.
+	FlushRequested = true;
+}
+
+uint32_t HALSDLogWriter::size(void)
+{
+	return FileSize;
+}
+
+HALSDLogWriter::operator bool()
+{
+	// true if there is, or will be, an open file to write to.
+	if (OpenPending)
+	{
+		return PendingName[0] != '\0';
+	}
+	return LogFile;
+}
+
+bool HALSDLogWriter::drain(void)
+{
+	// write the next part of the buffer to the file.
+	// Returns true if the card was written: data, the directory entry, or a file closed or opened.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 returns whether the card was written.
+	unsigned long start_us = micros();
+	bool written = true;
+
+	if (SyncPending)
+	{
+		LogFile.flush();
+		SyncPending = false;
+	}
+	else if (OpenPending && Tail == RotateAt)
+	{
+		if (LogFile)
+		{
+			LogFile.close();
+		}
+		if (PendingName[0])
+		{
+			LogFile = SD.open(PendingName, FILE_WRITE);
+		}
+		OpenPending = false;
+	}
+	else
+	{
+		uint32_t limit = OpenPending ? RotateAt : Head;
+		uint32_t count = limit - Tail;
+
+		// wait for a full sector, unless the data must be written out now.
+		if (count > LogWriterSectorSize)
+		{
+			count = LogWriterSectorSize;
+		}
+		else if (count < LogWriterSectorSize && !OpenPending && !FlushRequested)
+		{
+			count = 0;
+		}
+
+		// the part of the data up to the end of the ring buffer. The rest is written in the next call.
+		uint32_t index = Tail & (BufferSize - 1);
+		if (count > BufferSize - index)
+		{
+			count = BufferSize - index;
+		}
+
+		written = count > 0 && LogFile;
+		if (written)
+		{
+			LogFile.write(&Buffer[index], count);
+		}
+		Tail += count;
+
+		if (FlushRequested && Tail == Head)
+		{
+			FlushRequested = false;
+			SyncPending = true;
+		}
+	}
+
+	unsigned long duration_us = micros() - start_us;
+	if (duration_us > MaxWrite_us)
+	{
+		MaxWrite_us = duration_us;
+	}
+	return written;
+}
+
+unsigned int HALSDLogWriter::QueueDepth(void)
+{
+	return Head - Tail;
+}
+
+unsigned int HALSDLogWriter::Capacity(void)
+{
+	return BufferSize;
+}
+
+void HALSDLogWriter::ResetStatistics(void)
+{
+	MaxQueueDepth = QueueDepth();
+	MaxWrite_us = 0;
+	Overflows = 0;
+}
@@ -0,0 +1,70 @@
+// HAL_SDLogWriter.h
+
+// Buffered SD card log file writer.
+// Log records are printed into a RAM ring buffer, and drain() writes the buffer to the file a sector at a time,
+// so that no single call blocks for longer than about one sector write.
+// Opening a new file is queued behind the data already buffered for the current file, and done by drain().
+// Only one open can be queued at a time; open() returns false while another is waiting.
+// The buffer is given to the constructor, so each file can have a buffer to suit how much it logs.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 the buffer and its size given to the constructor. drain() returns whether it wrote to the card.
+
+#ifndef _HAL_SDLogWriter_h
+#define _HAL_SDLogWriter_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "SD.h"
+
+static const unsigned int LogWriterBufferSize = 8192;		// bytes. The log files. A buffer size must be a power of 2.
+static const unsigned int LogWriterSmallBufferSize = 2048;	// bytes. Files written a sector at a time, e.g. the flight recorder.
+static const unsigned int LogWriterSectorSize = 512;
+
+class HALSDLogWriter : public Print
+{
+public:
+	template <unsigned int N> HALSDLogWriter(uint8_t(&buffer)[N]) : Buffer(buffer), BufferSize(N)
+	{
+		static_assert(N >= LogWriterSectorSize && (N & (N - 1)) == 0, "the log writer buffer must be a power of 2, of at least a sector");
+	}
+
+	bool open(const char* filename);
+	void close(void);
+	virtual size_t write(uint8_t c);
+	virtual size_t write(const uint8_t* buf, size_t size);
+	void flush(void);
+	uint32_t size(void);
+	operator bool();
+
+	bool drain(void);
+
+	unsigned int QueueDepth(void);
+	unsigned int Capacity(void);	// bytes. the size of the buffer.
+	unsigned int MaxQueueDepth;		// bytes. most bytes waiting to be written.
+	unsigned long MaxWrite_us;		// longest drain() call.
+	unsigned long Overflows;		// bytes discarded because the buffer was full.
+	void ResetStatistics(void);
+
+	using Print::write;
+
+private:
+	File LogFile;
+	uint8_t* const Buffer;
+	const unsigned int BufferSize;
+	uint32_t Head;					// total bytes put into the buffer
+	uint32_t Tail;					// total bytes written to the file
+	uint32_t FileSize;				// size of the current file, including the bytes still in the buffer.
+
+	bool OpenPending;				// close the current file when Tail reaches RotateAt, then open PendingName.
+	uint32_t RotateAt;
+	char PendingName[13];			// 8.3 file name. Empty to just close the file.
+
+	bool FlushRequested;			// write out the partial sector, then update the file directory entry.
+	bool SyncPending;
+};
+
+#endif
@@ -8,8 +8,12 @@
 #include "LoRaManagement.h"
 #include "LoRa_E32.h"
 #include "TelemetryMessages.h"
+#include "configValues.h"
 
 extern byte MessageArray[EndMarker+1];
+extern Stream* Serials[];
+extern HardwareSerial* UARTs[];
+extern configValuesType Configuration;
 
 
 byte EByte_AuxPin = 2;
@@ -22,6 +26,11 @@ ResponseStatus rs;
 
 void HALTelemetry::Init()
 {
+    // V1.1 17/10/2026 added a transmit buffer, so that a message is not held up by the 9600 baud port,
+    //                  and the size of each message can be measured for the airtime budget.
+    static char SerialWriteBuffer[TelemetryWriteBufferSize];
+    (*UARTs[Configuration.LoRaPort]).addMemoryForWrite(SerialWriteBuffer, sizeof(SerialWriteBuffer));
+
     Init_LoRa();
     Set_LoRa_Mode(LoRa_Mode_Type::RxLowPower);
   //  Set_LoRa_Mode(LoRa_Mode_Type::TxShortRange);
@@ -1,13 +1,23 @@
 // 
 // 
-// 
+// V1.1 17/10/2026 added VirtualMillis, a clock for the navigation and simulation that can run faster than real time.
+// V1.2 17/10/2026 the simulation speed is passed to the scheduler for the simulated tasks. The scheduler itself stays on millis().
 
 #include "HAL_Time.h"
 #include "TimeLib.h"
 #include "HAL_SDCard.h"
+#include "TextFormat.h"
+#include "SchedulerCooperative.h"
 
 extern time_t GPSTime;
 
+// Virtual clock. 
+// This runs at SimulationSpeed times real time, so that a simulated mission can be completed in less time.
+// At the normal speed of 1 it is identical to millis().
+static int SimulationSpeed = 1;
+static unsigned long VirtualBase_ms;	// virtual time at the last change of speed
+static unsigned long RealBase_ms;		// real time at the last change of speed
+
 void time_init()
 {
 	// set the Time library to use Teensy 3.0's RTC to keep time
@@ -32,7 +42,8 @@ void sync_RTC_to_GPS()
 	Teensy3Clock.set(GPSTime);  // set the RTC to match the GPS Time.
 
 	// log an event on the SD Card
-	String LogMessage = "RTC synced to GPS. Adjusted by " + String(TimeAdjustment) + " seconds.";
+	char LogMessage[48];
+	FormatText(LogMessage, sizeof(LogMessage), "RTC synced to GPS. Adjusted by %ld seconds.", TimeAdjustment);
 	Serial.println(LogMessage);
 	SD_Logging_Event_Messsage(LogMessage);
 }
@@ -41,4 +52,33 @@ void sync_RTC_to_GPS()
 time_t getTeensy3Time()
 {
 	return Teensy3Clock.get();
-}
\ No newline at end of file
+}
+
+unsigned long VirtualMillis()
+{
+	// return the virtual time in ms. 
+	// Used in place of millis() for the navigation, mission and simulation timing.
+	// V1.0 17/10/2026 John Semmens
+	return VirtualBase_ms + (millis() - RealBase_ms) * SimulationSpeed;
+}
+
+void SetSimulationSpeed(int speed)
+{
+	// set the speed of the virtual clock relative to real time.
+	// The virtual clock is re-based so that it continues smoothly from its current value.
+	// V1.0 17/10/2026 John Semmens
+	if (speed < 1)
+		speed = 1;
+
+	unsigned long now_ms = millis();
+	VirtualBase_ms = VirtualBase_ms + (now_ms - RealBase_ms) * SimulationSpeed;
+	RealBase_ms = now_ms;
+	SimulationSpeed = speed;
+
+	SchedulerSetSpeed(speed);
+}
+
+int GetSimulationSpeed()
+{
+	return SimulationSpeed;
+}
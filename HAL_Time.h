@@ -16,5 +16,12 @@ void sync_RTC_to_GPS(void);
 
 time_t getTeensy3Time(void);
 
+// highest supported simulation speed. Limited by the time taken to run the fast tasks.
+static const int MaxSimulationSpeed = 20;
+
+unsigned long VirtualMillis(void);
+void SetSimulationSpeed(int speed);
+int GetSimulationSpeed(void);
+
 #endif
 
@@ -4,6 +4,7 @@
 
 #include "HAL_Watchdog.h"
 #include "HAL_SDCard.h"
+#include "TextFormat.h"
 
 void Watchdog_Init(int timeout)
 {
@@ -12,7 +13,9 @@ void Watchdog_Init(int timeout)
 	Serial.print(timeout);
 	Serial.println("s");
 
-	SD_Logging_Event_Messsage("Initialising watchdog: " + String(timeout) + "s");
+	char message[32];
+	FormatText(message, sizeof(message), "Initialising watchdog: %ds", timeout);
+	SD_Logging_Event_Messsage(message);
 
 	WDOG_UNLOCK = WDOG_UNLOCK_SEQ1;
 	WDOG_UNLOCK = WDOG_UNLOCK_SEQ2;
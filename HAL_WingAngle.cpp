@@ -1,19 +1,31 @@
 // 
 // 
 // wingsail angle in degrees; positive angles to starboard, negative angles to port: -180 to 0 to +180
+// V1.1 17/10/2026 each bus is held with the I2C manager while its sensor is read.
+// V1.2 17/10/2026 the port sensor samples at 40 Hz into its FIFO, which is read in the background.
+//                 The standby starboard sensor, which isn't used for the angle, is only read by the health check.
+// V1.3 17/10/2026 GetMeanAngle, the mean of the 25 ms samples, used for the wingsail angle and tack.
 
 #include "HAL_WingAngle.h"
 #include "configValues.h"
 #include "DisplayStrings.h"
+#include "I2CManager.h"
 
 extern configValuesType Configuration;
 
+static int PortDevice = -1;	// I2C manager devices
+static int StbdDevice = -1;
+
+// the sensor data ready pins aren't connected. Pin 12, set up for this before, is the servo 0 power pin.
+static const int WingAnglePortInterruptPin = -1;
+
 void HALWingAngle::Init(void)
 {
 	Serial.println(F("*** Initialising WingAngle Sensors..."));
 
 	Serial.println(F("Port WingAngle Sensor..."));
-	WingSailAngleSensorPort.Init(1); // I2c #1
+	PortDevice = I2CAddDevice(1, MPU9250_ADDRESS, "Wing port");
+	WingSailAngleSensorPort.Init(1, PortDevice, true, WingAnglePortInterruptPin); // I2c #1
 
 	PortStatus = EquipmentStatusType::Unknown;
 	if (WingSailAngleSensorPort.status)
@@ -24,7 +36,8 @@ void HALWingAngle::Init(void)
 	Serial.println(F("Port WingAngle Sensor Initialising complete."));
 
 	Serial.println(F("Starboard WingAngle Sensor..."));
-	WingSailAngleSensorStbd.Init(2); // I2c #2
+	StbdDevice = I2CAddDevice(2, MPU9250_ADDRESS, "Wing stbd");
+	WingSailAngleSensorStbd.Init(2, StbdDevice, false); // I2c #2, standby
 
 	StbdStatus = EquipmentStatusType::Unknown;
 	if (WingSailAngleSensorStbd.status)
@@ -34,7 +47,13 @@ void HALWingAngle::Init(void)
 	Serial.println(GetEquipmentStatusString(StbdStatus));
 	Serial.println(F("Starboard WingAngle Sensor Initialising complete."));
 
-	Read();
+	// a first reading of each, before the background reads start.
+	WingSailAngleSensorPort.Read();
+	WingSailAngleSensorStbd.Read();
+	PortTemperature = WingSailAngleSensorPort.temperature;
+	StbdTemperature = WingSailAngleSensorStbd.temperature;
+	UpdateAngle();
+
 	PeakAnglePort = Angle;
 	PeakAngleStbd = Angle;
 
@@ -44,18 +63,72 @@ void HALWingAngle::Init(void)
 
 void HALWingAngle::Read()
 {
-	WingSailAngleSensorPort.Read();
-	WingSailAngleSensorStbd.Read();
+	// add the port sensor samples read in the background since the last call, then start the next read.
+	// V1.2 17/10/2026 John Semmens
+	if (WingSailAngleSensorPort.Collect())
+	{
+		UpdateAngle();
+	}
+	WingSailAngleSensorPort.StartRead();
+}
+
+bool HALWingAngle::GetAngleSample(int age, int& angle, unsigned long& time_ms)
+{
+	// V1.0 17/10/2026 John Semmens
+	WingAngleSampleType sample;
 
+	if (!WingSailAngleSensorPort.GetSample(age, sample))
+	{
+		return false;
+	}
+	angle = CorrectedAngle(sample.MagneticBearing);
+	time_ms = sample.Time_ms;
+	return true;
+}
+
+bool HALWingAngle::GetMeanAngle(unsigned long period_ms, int& angle)
+{
+	// mean of the samples within period_ms of the latest. The angles are averaged as differences from the latest,
+	// so samples either side of +/-180 don't average to zero.
+	// V1.0 17/10/2026 John Semmens
+	int latest;
+	unsigned long latest_ms;
+
+	if (!GetAngleSample(0, latest, latest_ms))
+	{
+		return false;
+	}
+
+	long sum = 0;
+	int count = 1;
+	int sample;
+	unsigned long sample_ms;
+	while (GetAngleSample(count, sample, sample_ms) && (latest_ms - sample_ms) < period_ms)
+	{
+		sum += wrap_180(sample - latest);
+		count++;
+	}
+
+	angle = wrap_180(latest + (int)(sum / count));
+	return true;
+}
+
+int HALWingAngle::CorrectedAngle(int MagneticBearing)
+{
+	// the wing angle from a port sensor bearing, with the calibration offset and the deviation correction.
+	int RawAngle = MagneticBearing + Configuration.WindAngleCalibrationOffset;
+
+	return wrap_180(RawAngle - DeviationCalc(RawAngle)); // subtract the Deviation Error
+}
+
+void HALWingAngle::UpdateAngle()
+{
 	// use the port sensor and connections.
 	int RawAngle = WingSailAngleSensorPort.MagneticBearing + Configuration.WindAngleCalibrationOffset;
 
 	Deviation = DeviationCalc(RawAngle); // Deviation Error
 	Angle = wrap_180(RawAngle - Deviation); // subtract the Deviation Error
 
-	PortTemperature = WingSailAngleSensorPort.temperature;
-	StbdTemperature = WingSailAngleSensorStbd.temperature;
-
 	// test code for sending mx and my to USB serial.
 	// only send out serial data while the OLED Display is showing the detailed Wingsail Sensor data.
 	if (Configuration.DisplayScreenView == 'y')
@@ -140,9 +213,19 @@ void HALWingAngle::UpdateMovementDetection(int WingSailAngle)
 void HALWingAngle::HealthCheck()
 {
 	// this is expected to the called every 10 seconds
+	// V1.1 17/10/2026 reads the temperatures, and checks the standby starboard sensor.
 
 	static int prev_Movement;
 
+	WingSailAngleSensorPort.Read();
+	PortTemperature = WingSailAngleSensorPort.temperature;
+
+	if (WingSailAngleSensorStbd.status)
+	{
+		StbdStatus = WingSailAngleSensorStbd.Read() ? EquipmentStatusType::DataGood : EquipmentStatusType::DataBad;
+		StbdTemperature = WingSailAngleSensorStbd.temperature;
+	}
+
 	if (Movement == 0 && prev_Movement == 0)
 	{
 		// fault
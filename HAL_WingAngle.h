@@ -34,9 +34,21 @@ class HALWingAngle
 		void Read(void);
 		void Init(void);
 
+		// the wing angle from the port sensor's samples, 25 ms apart, age places before the latest.
+		// Returns false if there isn't one.
+		bool GetAngleSample(int age, int& angle, unsigned long& time_ms);
+
+		// the mean wing angle of the port sensor's samples over the period before the latest sample.
+		// Returns false if there are no samples.
+		bool GetMeanAngle(unsigned long period_ms, int& angle);
+
 		int Deviation;
 
 		int DeviationCalc(int MagneticAngle);
+
+	private:
+		void UpdateAngle(void);
+		int CorrectedAngle(int MagneticBearing);
 };
 
 #endif
@@ -0,0 +1,98 @@
+// Heap use and high water mark.
+// mallinfo walks the allocator's own records, so measuring the heap doesn't allocate from it.
+// The allocator calls are counted in __malloc_lock, which newlib calls on entry to each malloc, free and realloc 
+// to make the heap thread safe. Defining it here replaces newlib's empty version, so no linker options are needed.
+// A realloc that moves the block also calls malloc and free, so counts more than once.
+// mallinfo takes the same lock, so the monitor's own measurement is left out of the count.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 count the allocator calls, and log the first call after setup.
+// V1.2 17/10/2026 the mallinfo call in HeapMeasure is not counted, so the steady state count can stay at zero.
+
+#include "HeapMonitor.h"
+#include "HAL_SDCard.h"
+#include "TextFormat.h"
+#include <malloc.h>
+
+static HeapStatsType HeapStats;
+static bool SteadyState = false;
+static unsigned long BaselineCalls;		// allocator calls at the end of setup
+
+static volatile unsigned long AllocatorCalls;
+static volatile bool Measuring = false;		// true during the monitor's own mallinfo call
+
+extern "C" void __malloc_lock(struct _reent* reent)
+{
+	if (!Measuring)
+	{
+		AllocatorCalls++;
+	}
+}
+
+extern "C" void __malloc_unlock(struct _reent* reent)
+{
+}
+
+static void HeapMeasure(void)
+{
+	Measuring = true;
+	struct mallinfo info = mallinfo();
+	Measuring = false;
+	HeapStats.InUse = info.uordblks;
+	HeapStats.Arena = info.arena;
+	HeapStats.AllocatorCalls = AllocatorCalls;
+}
+
+void HeapMonitorBegin(void)
+{
+	// record the heap use at the end of setup, as the baseline for steady state.
+	// V1.0 17/10/2026 John Semmens
+	HeapMeasure();
+	HeapStats.Baseline = HeapStats.InUse;
+	HeapStats.Peak = HeapStats.InUse;
+	HeapStats.SteadyStateRises = 0;
+	HeapStats.SteadyStateCalls = 0;
+	BaselineCalls = HeapStats.AllocatorCalls;
+	SteadyState = true;
+
+	char message[48];
+	FormatText(message, sizeof(message), "Heap %lu bytes, arena %lu", (unsigned long)HeapStats.InUse, (unsigned long)HeapStats.Arena);
+	SD_Logging_Event_Messsage(message);
+}
+
+void HeapMonitorUpdate(void)
+{
+	// update the high water mark. A rise after setup is counted and logged.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 count the allocator calls after setup. The first is logged.
+	HeapMeasure();
+
+	if (SteadyState)
+	{
+		unsigned long calls = HeapStats.AllocatorCalls - BaselineCalls;
+		if (calls && !HeapStats.SteadyStateCalls)
+		{
+			char message[48];
+			FormatText(message, sizeof(message), "Heap allocator used after setup, %lu calls", calls);
+			SD_Logging_Event_Messsage(message);
+		}
+		HeapStats.SteadyStateCalls = calls;
+	}
+
+	if (HeapStats.InUse > HeapStats.Peak)
+	{
+		HeapStats.Peak = HeapStats.InUse;
+		if (SteadyState)
+		{
+			HeapStats.SteadyStateRises++;
+
+			char message[48];
+			FormatText(message, sizeof(message), "Heap peak %lu bytes, +%lu", (unsigned long)HeapStats.Peak, (unsigned long)(HeapStats.Peak - HeapStats.Baseline));
+			SD_Logging_Event_Messsage(message);
+		}
+	}
+}
+
+const HeapStatsType& HeapMonitorStats(void)
+{
+	return HeapStats;
+}
@@ -0,0 +1,37 @@
+// HeapMonitor.h
+
+// Heap use and high water mark, to show the heap is not used once the vessel is running.
+// Allocations are expected during setup. HeapMonitorBegin, called at the end of setup, records the heap use
+// as the steady state baseline. HeapMonitorUpdate then tracks the high water mark, and counts and logs each rise
+// above the baseline, which should stay at zero for months of unattended running.
+// The high water mark can't see a malloc followed by a free of the same size, so the calls to the allocator are counted too.
+// Any call after setup is churn, even if the peak doesn't rise.
+// The count excludes the monitor's own measurement of the heap.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 count the allocator calls.
+// V1.2 17/10/2026 the monitor's own mallinfo call is not counted.
+
+#ifndef _HEAPMONITOR_h
+#define _HEAPMONITOR_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+struct HeapStatsType {
+	uint32_t InUse;				// bytes allocated now
+	uint32_t Arena;				// bytes taken from RAM by the allocator. It never shrinks.
+	uint32_t Peak;				// high water mark of the bytes allocated
+	uint32_t Baseline;			// bytes allocated at the end of setup
+	unsigned long SteadyStateRises;	// times the high water mark rose after setup. Should be zero.
+	unsigned long AllocatorCalls;	// malloc, free and realloc calls since power on, not counting the monitor
+	unsigned long SteadyStateCalls;	// allocator calls after setup. Should be zero.
+};
+
+void HeapMonitorBegin(void);
+void HeapMonitorUpdate(void);
+const HeapStatsType& HeapMonitorStats(void);
+
+#endif
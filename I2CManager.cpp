@@ -0,0 +1,459 @@
+// I2C transaction manager.
+// The queue of each bus is changed by tasks, with the bus interrupt masked, and by the completion callbacks in
+// the I2C interrupt. A transaction is started when the one before it finishes, from the callback,
+// or when it is queued to an idle bus.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 only the bus interrupt is masked while the queue is changed, and transfers are started with it unmasked.
+//					With all interrupts disabled, i2c_t3 found it could not run in the background and ran each
+//					transfer, and the transfers its callbacks went on to, in blocking immediate mode.
+
+#include "I2CManager.h"
+#include "i2c_t3.h"
+
+struct I2CBusStateType {
+	i2c_t3* Port;
+	IRQ_NUMBER_t Irq;
+	I2CTransactionType* volatile Queue;	// waiting transactions, in priority order
+	I2CTransactionType* volatile Active;
+	uint32_t Started_us;
+	int Held;						// device holding the bus with I2CBusBegin, or -1
+	uint32_t HeldStart_us;
+	volatile bool ResetNeeded;		// recover the bus with resetBus before starting another transaction
+	I2CBusStatsType Stats;
+};
+
+static I2CBusStateType Buses[I2CManagerBuses] = {
+	{ &Wire, IRQ_I2C0, NULL, NULL, 0, -1, 0, false, {} },
+	{ &Wire1, IRQ_I2C1, NULL, NULL, 0, -1, 0, false, {} },
+	{ &Wire2, IRQ_I2C2, NULL, NULL, 0, -1, 0, false, {} },
+};
+
+static I2CDeviceStatsType Devices[I2CManagerMaxDevices];
+static int DeviceCount = 0;
+
+// only the bus interrupt is masked while its queue is changed. Disabling all interrupts would make i2c_t3 run a
+// transfer started meanwhile in blocking immediate mode, and micros() enables interrupts again anyway.
+// The mask is restored rather than cleared, so that the lock can be taken in the bus interrupt, and nested.
+static inline bool LockBus(I2CBusStateType& bus)
+{
+	bool enabled = NVIC_IS_ENABLED(bus.Irq);
+	NVIC_DISABLE_IRQ(bus.Irq);
+	return enabled;
+}
+
+static inline void UnlockBus(I2CBusStateType& bus, bool enabled)
+{
+	if (enabled)
+	{
+		NVIC_ENABLE_IRQ(bus.Irq);
+	}
+}
+
+static void RecordLatency(I2CDeviceStatsType& device, uint32_t latency_us)
+{
+	device.TotalLatency_us += latency_us;
+	if (latency_us > device.MaxLatency_us)
+	{
+		device.MaxLatency_us = latency_us;
+	}
+}
+
+static void Finish(I2CBusStateType& bus, I2CTransactionType* t, I2CResultType result)
+{
+	// record the result and tell the driver. The transaction is no longer on the bus or in the queue, so the bus
+	// interrupt doesn't touch it, and the bus lock isn't needed.
+	I2CDeviceStatsType& device = Devices[t->Device];
+
+	switch (result)
+	{
+	case I2CResultType::Ok:
+		device.Transactions++;
+		RecordLatency(device, micros() - t->Queued_us);
+		break;
+
+	case I2CResultType::Timeout:
+		device.Timeouts++;
+		break;
+
+	case I2CResultType::Missed:
+		device.Missed++;
+		break;
+
+	default:
+		device.Errors++;
+	}
+
+	t->Result = result;
+	if (t->Done)
+	{
+		t->Done(t);
+	}
+}
+
+static void StartNext(I2CBusStateType& bus)
+{
+	// start the first transaction in the queue, if the bus is free.
+	// Call from a task with the bus unlocked, or from the bus interrupt. The transaction is taken from the queue with
+	// the bus locked, then started with the bus interrupt enabled, so that i2c_t3 runs it in the background.
+	for (;;)
+	{
+		I2CTransactionType* t = NULL;
+
+		bool enabled = LockBus(bus);
+		if (!bus.Active && bus.Held < 0 && !bus.ResetNeeded && bus.Queue)
+		{
+			t = bus.Queue;
+			bus.Queue = t->Next;
+			bus.Active = t;		// nothing else is started while this one is checked
+		}
+		UnlockBus(bus, enabled);
+
+		if (!t)
+		{
+			return;
+		}
+
+		if (t->Deadline_us > 0 && micros() - t->Queued_us > t->Deadline_us)
+		{
+			bus.Active = NULL;
+			Finish(bus, t, I2CResultType::Missed);
+			continue;
+		}
+
+		uint8_t address = Devices[t->Device].Address;
+		bus.Started_us = micros();
+		t->Result = I2CResultType::Active;
+
+		if (t->TxLength > 0)
+		{
+			// the callbacks go on to the read, if there is one. A failure to start calls the error callback.
+			bus.Port->beginTransmission(address);
+			bus.Port->write(t->Tx, t->TxLength);
+			bus.Port->sendTransmission(t->RxLength > 0 ? I2C_NOSTOP : I2C_STOP);
+		}
+		else
+		{
+			bus.Port->sendRequest(address, t->RxLength, I2C_STOP);
+		}
+		return;
+	}
+}
+
+static void Complete(I2CBusStateType& bus, I2CResultType result)
+{
+	bool enabled = LockBus(bus);
+	I2CTransactionType* t = bus.Active;
+	bus.Active = NULL;
+	UnlockBus(bus, enabled);
+
+	if (t)
+	{
+		Finish(bus, t, result);
+	}
+	StartNext(bus);
+}
+
+static void TransmitDone(I2CBusStateType& bus)
+{
+	I2CTransactionType* t = bus.Active;
+	if (!t)
+	{
+		// a blocking transfer
+		return;
+	}
+
+	if (t->RxLength > 0)
+	{
+		bus.Port->sendRequest(Devices[t->Device].Address, t->RxLength, I2C_STOP);
+	}
+	else
+	{
+		Complete(bus, I2CResultType::Ok);
+	}
+}
+
+static void RequestDone(I2CBusStateType& bus)
+{
+	I2CTransactionType* t = bus.Active;
+	if (!t)
+	{
+		return;
+	}
+
+	bus.Port->read(t->Rx, t->RxLength);
+	Complete(bus, I2CResultType::Ok);
+}
+
+static void Error(I2CBusStateType& bus)
+{
+	// also called for errors of the blocking transfers, which are counted against the device holding the bus.
+	i2c_status status = bus.Port->status();
+	bool timeout = (status == I2C_TIMEOUT);
+
+	if (timeout || status == I2C_ARB_LOST || status == I2C_NOT_ACQ)
+	{
+		bus.ResetNeeded = true;
+	}
+
+	if (bus.Active)
+	{
+		Complete(bus, timeout ? I2CResultType::Timeout : I2CResultType::Error);
+	}
+	else if (bus.Held >= 0)
+	{
+		if (timeout)
+		{
+			Devices[bus.Held].Timeouts++;
+		}
+		else
+		{
+			Devices[bus.Held].Errors++;
+		}
+	}
+}
+
+// i2c_t3 callbacks have no parameters, so there is one set for each bus.
+static void Bus0TransmitDone(void) { TransmitDone(Buses[0]); }
+static void Bus0RequestDone(void) { RequestDone(Buses[0]); }
+static void Bus0Error(void) { Error(Buses[0]); }
+static void Bus1TransmitDone(void) { TransmitDone(Buses[1]); }
+static void Bus1RequestDone(void) { RequestDone(Buses[1]); }
+static void Bus1Error(void) { Error(Buses[1]); }
+static void Bus2TransmitDone(void) { TransmitDone(Buses[2]); }
+static void Bus2RequestDone(void) { RequestDone(Buses[2]); }
+static void Bus2Error(void) { Error(Buses[2]); }
+
+void I2CManagerInit(void)
+{
+	// call before the drivers begin their buses.
+	// V1.0 17/10/2026 John Semmens
+	static void(*const TransmitDoneCallbacks[I2CManagerBuses])(void) = { Bus0TransmitDone, Bus1TransmitDone, Bus2TransmitDone };
+	static void(*const RequestDoneCallbacks[I2CManagerBuses])(void) = { Bus0RequestDone, Bus1RequestDone, Bus2RequestDone };
+	static void(*const ErrorCallbacks[I2CManagerBuses])(void) = { Bus0Error, Bus1Error, Bus2Error };
+
+	for (int b = 0; b < I2CManagerBuses; b++)
+	{
+		Buses[b].Port->setDefaultTimeout(I2CTransactionTimeout_us);
+		Buses[b].Port->onTransmitDone(TransmitDoneCallbacks[b]);
+		Buses[b].Port->onReqFromDone(RequestDoneCallbacks[b]);
+		Buses[b].Port->onError(ErrorCallbacks[b]);
+	}
+}
+
+int I2CAddDevice(uint8_t bus, uint8_t address, const char* name)
+{
+	// returns the device number for the transactions, or -1 if there is no room or the bus is not managed.
+	// V1.0 17/10/2026 John Semmens
+	if (bus >= I2CManagerBuses)
+	{
+		return -1;
+	}
+
+	// a driver initialised again keeps its device.
+	for (int d = 0; d < DeviceCount; d++)
+	{
+		if (Devices[d].Bus == bus && Devices[d].Address == address)
+		{
+			return d;
+		}
+	}
+
+	if (DeviceCount >= I2CManagerMaxDevices)
+	{
+		return -1;
+	}
+
+	I2CDeviceStatsType& device = Devices[DeviceCount];
+	device = I2CDeviceStatsType();
+	device.Name = name;
+	device.Bus = bus;
+	device.Address = address;
+	return DeviceCount++;
+}
+
+bool I2CQueue(I2CTransactionType* t)
+{
+	// add a transaction to the queue of its bus, after those of the same or higher priority.
+	// Returns false if the device is not known, or the transaction is already queued.
+	// Can be called from a task, or from the completion function of a transaction on the same bus.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 started after the bus is unlocked.
+	if (t->Device < 0 || t->Device >= DeviceCount)
+	{
+		return false;
+	}
+
+	I2CBusStateType& bus = Buses[Devices[t->Device].Bus];
+	bool queued = false;
+
+	bool enabled = LockBus(bus);
+	if (t->Result != I2CResultType::Queued && t->Result != I2CResultType::Active)
+	{
+		t->Result = I2CResultType::Queued;
+		t->Queued_us = micros();
+
+		I2CTransactionType* volatile* place = &bus.Queue;
+		while (*place && (*place)->Priority <= t->Priority)
+		{
+			place = &(*place)->Next;
+		}
+		t->Next = *place;
+		*place = t;
+		queued = true;
+	}
+	UnlockBus(bus, enabled);
+
+	if (queued)
+	{
+		StartNext(bus);
+	}
+	return queued;
+}
+
+void I2CManagerPoll(void)
+{
+	// time out stuck transactions and recover the buses. Call from a task every few ms.
+	// V1.0 17/10/2026 John Semmens
+	for (int b = 0; b < I2CManagerBuses; b++)
+	{
+		I2CBusStateType& bus = Buses[b];
+
+		I2CTransactionType* stuck = NULL;
+
+		bool enabled = LockBus(bus);
+		if (bus.Active && micros() - bus.Started_us > 2 * I2CTransactionTimeout_us)
+		{
+			// i2c_t3 should have timed it out already, so the interrupt has been lost.
+			stuck = bus.Active;
+			bus.Active = NULL;
+			bus.ResetNeeded = true;
+		}
+		bool reset = bus.ResetNeeded && !bus.Active && bus.Held < 0;
+		UnlockBus(bus, enabled);
+
+		if (stuck)
+		{
+			Finish(bus, stuck, I2CResultType::Timeout);
+		}
+
+		if (reset)
+		{
+			bus.Port->resetBus();
+			bus.Stats.Resets++;
+
+			enabled = LockBus(bus);
+			bus.ResetNeeded = false;
+			UnlockBus(bus, enabled);
+			StartNext(bus);
+		}
+	}
+}
+
+bool I2CBusBegin(int device)
+{
+	// wait for the background transactions on the device's bus to finish, then hold the bus for blocking transfers.
+	// Returns false if the device is not known. The bus is still held if the wait times out, as the transfers have their
+	// own timeouts, but the time out is counted.
+	// V1.0 17/10/2026 John Semmens
+	if (device < 0 || device >= DeviceCount)
+	{
+		return false;
+	}
+
+	I2CBusStateType& bus = Buses[Devices[device].Bus];
+	uint32_t start = micros();
+
+	if (bus.Active || bus.Queue)
+	{
+		bus.Stats.Waits++;
+		while ((bus.Active || bus.Queue) && micros() - start < I2CBusWait_us)
+		{
+		}
+
+		uint32_t wait = micros() - start;
+		if (wait > bus.Stats.MaxWait_us)
+		{
+			bus.Stats.MaxWait_us = wait;
+		}
+	}
+
+	bool enabled = LockBus(bus);
+	bus.Held = device;
+	bus.HeldStart_us = start;
+	bool waitTimeout = bus.Active != NULL;
+	UnlockBus(bus, enabled);
+
+	if (waitTimeout)
+	{
+		// the last background transaction still has to finish. It will time out if it is stuck.
+		bus.Stats.WaitTimeouts++;
+		while (bus.Active && micros() - start < I2CBusWait_us + 2 * I2CTransactionTimeout_us)
+		{
+		}
+	}
+
+	return true;
+}
+
+void I2CBusEnd(int device)
+{
+	// release the bus held by I2CBusBegin, recover it after a timeout, and start the waiting transactions.
+	// V1.0 17/10/2026 John Semmens
+	if (device < 0 || device >= DeviceCount)
+	{
+		return;
+	}
+
+	I2CBusStateType& bus = Buses[Devices[device].Bus];
+	if (bus.Held != device)
+	{
+		return;
+	}
+
+	Devices[device].Transactions++;
+	RecordLatency(Devices[device], micros() - bus.HeldStart_us);
+
+	if (bus.ResetNeeded && !bus.Active)
+	{
+		bus.Port->resetBus();
+		bus.Stats.Resets++;
+		bus.ResetNeeded = false;
+	}
+
+	bool enabled = LockBus(bus);
+	bus.Held = -1;
+	UnlockBus(bus, enabled);
+	StartNext(bus);
+}
+
+int I2CDeviceCount(void)
+{
+	return DeviceCount;
+}
+
+const I2CDeviceStatsType& I2CDeviceStats(int device)
+{
+	return Devices[device];
+}
+
+const I2CBusStatsType& I2CBusStats(int bus)
+{
+	return Buses[bus].Stats;
+}
+
+void I2CResetStats(void)
+{
+	// V1.0 17/10/2026 John Semmens
+	for (int d = 0; d < DeviceCount; d++)
+	{
+		I2CDeviceStatsType& device = Devices[d];
+		device.Transactions = device.Errors = device.Timeouts = device.Missed = 0;
+		device.MaxLatency_us = 0;
+		device.TotalLatency_us = 0;
+	}
+
+	for (int b = 0; b < I2CManagerBuses; b++)
+	{
+		Buses[b].Stats = I2CBusStatsType();
+	}
+}
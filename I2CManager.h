@@ -0,0 +1,91 @@
+// I2CManager.h
+
+// I2C transaction manager for the Wire, Wire1 and Wire2 buses.
+// Background (non-blocking) transactions are queued per bus, in priority order, and run one after another by the
+// i2c_t3 completion callbacks. The manager owns those callbacks, so drivers queue transactions rather than
+// install their own. Each transaction has a completion function, called from the I2C interrupt when it has finished,
+// which may queue the next transaction of a sequence.
+// Drivers that use the i2c_t3 blocking calls, such as the OLED and the INA3221, wrap each group of calls in
+// I2CBusBegin/I2CBusEnd. I2CBusBegin waits for the background transactions on the bus to finish, and holds
+// the bus so that no more are started until I2CBusEnd.
+// Every bus has a default timeout, so a stuck transaction ends with an error rather than blocking everything.
+// Timeouts and lost arbitration are recovered with resetBus, which clocks out a device holding SDA low.
+// Latency, error, timeout and deadline counters are kept for each device.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _I2CMANAGER_h
+#define _I2CMANAGER_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+static const int I2CManagerBuses = 3;				// Wire, Wire1 and Wire2
+static const int I2CManagerMaxDevices = 8;
+static const uint32_t I2CTransactionTimeout_us = 5000;	// longest time for a transaction, and the i2c_t3 default timeout.
+static const uint32_t I2CBusWait_us = 5000;			// longest time I2CBusBegin waits for the background transactions.
+
+enum class I2CResultType : uint8_t {
+	Idle,		// not queued yet
+	Queued,
+	Active,
+	Ok,
+	Error,		// NAK, lost arbitration or bus not acquired
+	Timeout,
+	Missed		// the deadline passed before it was started
+};
+
+struct I2CTransactionType {
+	// set by the caller
+	int Device;					// from I2CAddDevice
+	uint8_t Priority;			// 0 is the highest priority, as for scheduler tasks. Equal priorities run in order queued.
+	uint8_t TxLength;			// bytes written, e.g. the register address
+	uint8_t Tx[4];
+	uint16_t RxLength;			// bytes read after the write, with a repeated start. 0 for a write only.
+	uint8_t* Rx;
+	uint32_t Deadline_us;		// longest time in the queue before it is dropped as missed. 0 for no deadline.
+	void(*Done)(I2CTransactionType* t);	// called from the I2C interrupt when finished. May be NULL.
+	void* Context;				// for the caller's use, e.g. the driver object
+
+	// set by the manager
+	volatile I2CResultType Result;
+	uint32_t Queued_us;
+	I2CTransactionType* Next;
+};
+
+struct I2CDeviceStatsType {
+	const char* Name;
+	uint8_t Bus;
+	uint8_t Address;
+	unsigned long Transactions;		// background transactions and blocking I2CBusBegin/End sections completed
+	unsigned long Errors;
+	unsigned long Timeouts;
+	unsigned long Missed;			// background transactions dropped at their deadline
+	unsigned long MaxLatency_us;	// from queued, or from I2CBusBegin, to finished
+	unsigned long long TotalLatency_us;	// used to calculate the mean.
+};
+
+struct I2CBusStatsType {
+	unsigned long Resets;			// resetBus recoveries
+	unsigned long Waits;			// I2CBusBegin calls that had to wait for background transactions
+	unsigned long MaxWait_us;
+	unsigned long WaitTimeouts;		// I2CBusBegin calls that gave up waiting
+};
+
+void I2CManagerInit(void);
+int I2CAddDevice(uint8_t bus, uint8_t address, const char* name);
+
+bool I2CQueue(I2CTransactionType* t);
+void I2CManagerPoll(void);
+
+bool I2CBusBegin(int device);
+void I2CBusEnd(int device);
+
+int I2CDeviceCount(void);
+const I2CDeviceStatsType& I2CDeviceStats(int device);
+const I2CBusStatsType& I2CBusStats(int bus);
+void I2CResetStats(void);
+
+#endif
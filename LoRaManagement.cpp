@@ -9,6 +9,7 @@ extern LoRa_E32 e32ttl100;
 extern ResponseStructContainer c;
 extern LoRaConfiguration configuration;
 extern ResponseStatus rs;
+extern byte EByte_AuxPin;
 
 void Init_LoRa(void)
 {
@@ -83,4 +84,11 @@ void Set_LoRa_Mode(LoRa_Mode_Type mode)
 
 	default:;
 	}
+}
+
+bool LoRa_TransmitComplete(void)
+{
+	// the module holds AUX low while it has data from the UART still to send over the air.
+	// V1.0 17/10/2026 John Semmens
+	return digitalRead(EByte_AuxPin) == HIGH;
 }
\ No newline at end of file
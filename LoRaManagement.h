@@ -20,6 +20,7 @@ enum LoRa_Mode_Type
 
 void Init_LoRa(void);
 void Set_LoRa_Mode(LoRa_Mode_Type mode);
+bool LoRa_TransmitComplete(void);
 
 #endif
 
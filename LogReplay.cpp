@@ -0,0 +1,365 @@
+// Replay of an SD card log file through the sailing navigation.
+// The 1 second records (LOC, ATT, SAI, NAV, Perf), together with the WAY and DEC records, hold the inputs the navigation used.
+// These are fed back into NavigationUpdate_SlowData and UpdateCourseToSteer once per slow loop interval,
+// and the recomputed CTS, CourseType and decision events are compared with what was logged.
+// This allows a change to SailingNavigation.cpp to be checked against logs of previous voyages.
+//
+// The replay takes over the navigation data while it runs, and holds up the scheduler, so it is only allowed from the CLI
+// when the vessel is idle, i.e. ashore or with the sails feathered.
+// The navigation data and command state are saved before the replay and restored afterwards.
+// The navigation filters and the state kept between updates are reset before the replay, and again afterwards,
+// so the replay doesn't start from the live state, and the live navigation doesn't carry on from the replay.
+// The mission step start time is held more than 8 seconds back, so a live mission step doesn't make every replayed update
+// choose the favoured tack again. The virtual clock doesn't move during the replay.
+// The file is read in blocks and each line is split in place, so no memory is allocated while reading the log.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 added LogReplay_Active.
+// V1.2 17/10/2026 the navigation reset before and after the replay. Each replayed decision is matched by type and reason
+//					with the DEC records logged in the same or the previous navigation update.
+
+#include "LogReplay.h"
+#include "Navigation.h"
+#include "SailingNavigation.h"
+#include "CommandState_Processor.h"
+#include "configValues.h"
+#include "DisplayStrings.h"
+#include "HAL_Watchdog.h"
+#include "AP_Math.h"
+#include "Mission.h"
+#include "HAL_Time.h"
+#include "SD.h"
+
+extern NavigationDataType NavData;
+extern StateValuesStruct StateValues;
+extern MissionValuesStruct MissionValues;
+extern configValuesType Configuration;
+extern bool UseSimulatedVessel;
+extern DecisionEventType DecisionEvent;
+extern DecisionEventReasonType DecisionEventReason;
+
+// the navigation is updated every 5 seconds in the slow loop.
+static const int ReplaySlowInterval_s = 5;
+
+// the sailing navigation chooses the favoured tack for 8 seconds after a mission step. Held longer ago than that.
+static const unsigned long ReplayMissionStepHeld_ms = 60000;
+
+// a recomputed CTS within this many degrees of the logged CTS is a match.
+static const int ReplayCTSTolerance = 5;
+
+// longest line and most fields expected in a log record.
+static const int ReplayMaxLineLength = 200;
+static const int ReplayMaxFields = 24;
+
+// the first data field of each record, following the record tag and the 7 time fields of LogTime().
+static const int ReplayFirstDataField = 8;
+
+static bool ReplayActive = false;
+static LogReplayResultType* ReplayResult;
+
+// logged DEC records not yet matched by a replayed decision. Unmatched records are dropped when they are more than one
+// navigation update old, as the replay raises its decisions at the update following the 1 second group they were logged in.
+static const int ReplayPendingDecisions = 8;
+struct ReplayDecisionType {
+	int Event;				// DecisionEventType, or -1 if the logged text isn't known
+	int Reason;				// DecisionEventReasonType, or -1
+	unsigned long Update;	// navigation updates replayed when it was logged
+};
+static ReplayDecisionType PendingDecisions[ReplayPendingDecisions];
+static int PendingCount;
+
+// values from the most recent records of the 1 second group.
+static int LoggedCTS;
+static char LoggedCourseType[16];
+
+static int32_t ParseCoordinate(const char* field)
+{
+	// the log holds degrees to 5 decimal places.
+	return (int32_t)(atof(field) * 10000000.0);
+}
+
+static int SplitFields(char* line, char* fields[])
+{
+	// split the line in place at each delimiter. Returns the number of fields.
+	// V1.0 17/10/2026 John Semmens
+	int count = 0;
+	fields[count++] = line;
+
+	for (char* c = line; *c; c++)
+	{
+		if (*c == Configuration.SDCardLogDelimiter)
+		{
+			*c = '\0';
+			if (count < ReplayMaxFields)
+			{
+				fields[count++] = c + 1;
+			}
+		}
+	}
+	return count;
+}
+
+static int ParseDecisionEvent(const char* field)
+{
+	// the logged text of a DecisionEventType, back to the enumerated value.
+	// V1.0 17/10/2026 John Semmens
+	for (int i = 0; i <= deRecoverInIronsToStbd; i++)
+	{
+		if (!strcmp(DecisionEventToString((DecisionEventType)i), field))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int ParseDecisionReason(const char* field)
+{
+	// the logged text of a DecisionEventReasonType, back to the enumerated value.
+	// V1.0 17/10/2026 John Semmens
+	for (int i = 0; i <= rInIronsRecover; i++)
+	{
+		if (!strcmp(DecisionEventReasonToString((DecisionEventReasonType)i), field))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void DropPendingDecisions(int count)
+{
+	// remove the oldest pending DEC records. They are logged decisions the replay didn't make.
+	// V1.0 17/10/2026 John Semmens
+	ReplayResult->DecisionMismatches += count;
+	PendingCount -= count;
+	memmove(PendingDecisions, PendingDecisions + count, PendingCount * sizeof(PendingDecisions[0]));
+}
+
+static void AddPendingDecision(int event, int reason)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (PendingCount == ReplayPendingDecisions)
+	{
+		DropPendingDecisions(1);
+	}
+	PendingDecisions[PendingCount].Event = event;
+	PendingDecisions[PendingCount].Reason = reason;
+	PendingDecisions[PendingCount].Update = ReplayResult->Updates;
+	PendingCount++;
+}
+
+static void MatchDecision(int event, int reason)
+{
+	// match a replayed decision with the earliest pending DEC of the same type and reason.
+	// The pending records before it were skipped by the replay.
+	// V1.0 17/10/2026 John Semmens
+	for (int i = 0; i < PendingCount; i++)
+	{
+		if (PendingDecisions[i].Event == event && PendingDecisions[i].Reason == reason)
+		{
+			DropPendingDecisions(i);
+			PendingCount--;
+			memmove(PendingDecisions, PendingDecisions + 1, PendingCount * sizeof(PendingDecisions[0]));
+			ReplayResult->DecisionMatches++;
+			return;
+		}
+	}
+	ReplayResult->DecisionMismatches++;
+}
+
+static void ExpirePendingDecisions(void)
+{
+	// drop the DEC records logged before the previous navigation update.
+	// V1.0 17/10/2026 John Semmens
+	int expired = 0;
+	while (expired < PendingCount && ReplayResult->Updates - PendingDecisions[expired].Update > 1)
+	{
+		expired++;
+	}
+	DropPendingDecisions(expired);
+}
+
+static void ReplayNavigation(void)
+{
+	// run the slow loop navigation on the replayed inputs, and compare with the logged outputs.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 DEC records that weren't replayed are dropped.
+	NavigationUpdate_SlowData();
+	UpdateCourseToSteer();
+	ReplayResult->Updates++;
+	ExpirePendingDecisions();
+
+	int error = abs(wrap_180(NavData.CTS - LoggedCTS));
+	if (error > ReplayCTSTolerance)
+	{
+		ReplayResult->CTSMismatches++;
+	}
+	if (error > ReplayResult->MaxCTSError)
+	{
+		ReplayResult->MaxCTSError = error;
+	}
+
+	if (strcmp(CourseTypeToString(NavData.CourseType), LoggedCourseType))
+	{
+		ReplayResult->CourseTypeMismatches++;
+	}
+}
+
+static void ReplayRecord(char* fields[], int count)
+{
+	// load the values from one log record into the navigation data.
+	// V1.0 17/10/2026 John Semmens
+	const int f = ReplayFirstDataField;
+
+	// skip the column header lines written at the start of each file.
+	if (count > 1 && !strcmp(fields[1], "YYYY"))
+	{
+		return;
+	}
+
+	if (!strcmp(fields[0], "LOC") && count > f + 3)
+	{
+		NavData.Currentloc.lat = ParseCoordinate(fields[f]);
+		NavData.Currentloc.lng = ParseCoordinate(fields[f + 1]);
+		NavData.COG = atoi(fields[f + 2]);
+		NavData.SOG_mps = atof(fields[f + 3]);
+		NavData.COG_Avg = NavData.COG;
+	}
+
+	if (!strcmp(fields[0], "ATT") && count > f)
+	{
+		NavData.HDG = atoi(fields[f]);
+	}
+
+	if (!strcmp(fields[0], "SAI") && count > f + 9)
+	{
+		LoggedCTS = atoi(fields[f]);
+		NavData.AWA = atoi(fields[f + 3]);
+		NavData.MaxCTE = atoi(fields[f + 5]);
+		strncpy(LoggedCourseType, fields[f + 9], sizeof(LoggedCourseType) - 1);
+	}
+
+	if (!strcmp(fields[0], "NAV") && count > f + 6)
+	{
+		NavData.TWD = atoi(fields[f + 6]);
+	}
+
+	if (!strcmp(fields[0], "WAY") && count > f + 3)
+	{
+		NavData.prev_WP.lat = ParseCoordinate(fields[f]);
+		NavData.prev_WP.lng = ParseCoordinate(fields[f + 1]);
+		NavData.next_WP.lat = ParseCoordinate(fields[f + 2]);
+		NavData.next_WP.lng = ParseCoordinate(fields[f + 3]);
+		NavData.next_WP_valid = true;
+	}
+
+	if (!strcmp(fields[0], "DEC") && count > f + 3)
+	{
+		StateValues.mission_index = atoi(fields[f]);
+		ReplayResult->LoggedDecisions++;
+		AddPendingDecision(ParseDecisionEvent(fields[f + 2]), ParseDecisionReason(fields[f + 3]));
+	}
+
+	// Perf is the last record of each 1 second group.
+	if (!strcmp(fields[0], "Perf") && count > f + 3)
+	{
+		NavData.AWA_Avg = atoi(fields[f + 2]);
+		NavData.SOG_Avg = atof(fields[f + 3]);
+		NavData.TackDuration++;
+
+		ReplayResult->Seconds++;
+		if ((ReplayResult->Seconds % ReplaySlowInterval_s) == 0)
+		{
+			ReplayNavigation();
+		}
+	}
+}
+
+bool LogReplay(const char* filename, LogReplayResultType& result)
+{
+	// replay the log file. Returns false if the file could not be opened.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 the navigation is reset before and after the replay.
+	File ReplayFile = SD.open(filename);
+	if (!ReplayFile)
+	{
+		return false;
+	}
+
+	memset(&result, 0, sizeof(result));
+	ReplayResult = &result;
+	unsigned long start_ms = millis();
+
+	// save the live state, and replay with the location validated as for the simulator.
+	NavigationDataType SavedNavData = NavData;
+	StateValuesStruct SavedStateValues = StateValues;
+	bool SavedUseSimulatedVessel = UseSimulatedVessel;
+	unsigned long SavedMissionCommandStartTime = MissionValues.MissionCommandStartTime;
+
+	StateValues.CommandState = vcsFollowMission;
+	UseSimulatedVessel = true;
+	LoggedCTS = 0;
+	LoggedCourseType[0] = '\0';
+	PendingCount = 0;
+	MissionValues.MissionCommandStartTime = VirtualMillis() - ReplayMissionStepHeld_ms;
+	ReplayActive = true;
+	Navigation_Reset();
+
+	char block[512];
+	char line[ReplayMaxLineLength + 1];
+	char* fields[ReplayMaxFields];
+	int length = 0;
+	int n;
+
+	while ((n = ReplayFile.read(block, sizeof(block))) > 0)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			char c = block[i];
+			if (c == '\n')
+			{
+				line[length] = '\0';
+				ReplayRecord(fields, SplitFields(line, fields));
+				result.Lines++;
+				length = 0;
+			}
+			else if (c != '\r' && length < ReplayMaxLineLength)
+			{
+				line[length++] = c;
+			}
+		}
+		Watchdog_Pat();
+	}
+	ReplayFile.close();
+	DropPendingDecisions(PendingCount);
+
+	ReplayActive = false;
+	NavData = SavedNavData;
+	StateValues = SavedStateValues;
+	UseSimulatedVessel = SavedUseSimulatedVessel;
+	MissionValues.MissionCommandStartTime = SavedMissionCommandStartTime;
+	Navigation_Reset();
+
+	result.Duration_ms = millis() - start_ms;
+	return true;
+}
+
+bool LogReplay_CaptureDecision(void)
+{
+	// called when a decision event is to be logged. During a replay the decision is compared with the log rather than logged.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 matched with the logged DEC records by type and reason.
+	if (ReplayActive)
+	{
+		ReplayResult->ReplayDecisions++;
+		MatchDecision(DecisionEvent, DecisionEventReason);
+	}
+	return ReplayActive;
+}
+
+bool LogReplay_Active(void)
+{
+	// true while a replay is running. Used to stop replayed navigation events reaching the flight recorder and the log.
+	// V1.0 17/10/2026 John Semmens
+	return ReplayActive;
+}
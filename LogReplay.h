@@ -0,0 +1,37 @@
+// LogReplay.h
+
+// Replay of an SD card log file through the sailing navigation.
+// The logged inputs (location, heading, wind, waypoints) are fed back into NavigationUpdate_SlowData and UpdateCourseToSteer,
+// and the recomputed CTS, CourseType and decision events are compared with those that were logged.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 LogReplay_Active, so the navigation doesn't trigger the flight recorder during a replay.
+// V1.2 17/10/2026 decision events compared by type and reason with the logged DEC records, rather than only counted.
+
+#ifndef _LOGREPLAY_h
+#define _LOGREPLAY_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+struct LogReplayResultType {
+	unsigned long Lines;				// lines read from the log file
+	unsigned long Seconds;				// 1 second record groups replayed
+	unsigned long Updates;				// navigation updates, one per slow loop interval
+	unsigned long CTSMismatches;		// recomputed CTS differs from the logged CTS by more than the tolerance
+	unsigned long CourseTypeMismatches;	// recomputed CourseType differs from the logged CourseType
+	unsigned long LoggedDecisions;		// DEC records in the log
+	unsigned long ReplayDecisions;		// decision events raised by the replay
+	unsigned long DecisionMatches;		// replayed decisions with the type and reason of a DEC logged in the same or previous update
+	unsigned long DecisionMismatches;	// replayed decisions with no such DEC, and DEC records that weren't replayed
+	int MaxCTSError;					// degrees
+	unsigned long Duration_ms;
+};
+
+bool LogReplay(const char* filename, LogReplayResultType& result);
+bool LogReplay_CaptureDecision(void);
+bool LogReplay_Active(void);
+
+#endif
@@ -443,6 +443,65 @@ void MPU9250::MPU9250SelfTest(float * destination) // Should return percent devi
 }
 
         
+// Background sampling. V1.0 17/10/2026 John Semmens
+// Call after initMPU9250() and initAK8963(). The AK8963 is no longer on the host I2C bus once the bypass is off,
+// so readMagData() can't be used after this. The magnetometer values come from decodeMagRecord() instead.
+void MPU9250::initSampling(uint8_t sampleRateDivider)
+{
+  // 100 Hz continuous, faster than the sample rate, so each sample has a new measurement.
+  Mmode = 0x06;
+  writeByte(AK8963_ADDRESS, AK8963_CNTL, Mscale << 4 | Mmode);
+  delay(10);
+
+  writeByte(MPU9250_ADDRESS, CONFIG, 0x04);                 // gyro and thermometer bandwidth 20 Hz
+  writeByte(MPU9250_ADDRESS, SMPLRT_DIV, sampleRateDivider); // sample rate = 1 kHz / (1 + SMPLRT_DIV)
+
+  // Bypass off. The interrupt pin is active high, push-pull, a 50 us pulse for each sample, so each sample
+  // has its own rising edge to timestamp it.
+  writeByte(MPU9250_ADDRESS, INT_PIN_CFG, 0x00);
+
+  // Data ready waits for the external sensor data (bit 6). 400 kHz master clock.
+  writeByte(MPU9250_ADDRESS, I2C_MST_CTRL, 0x4D);
+  writeByte(MPU9250_ADDRESS, I2C_SLV0_ADDR, AK8963_ADDRESS | 0x80); // read
+  writeByte(MPU9250_ADDRESS, I2C_SLV0_REG, AK8963_ST1);
+  writeByte(MPU9250_ADDRESS, I2C_SLV0_CTRL, 0x80 | MagRecordLength); // reading up to ST2 releases the next measurement
+  writeByte(MPU9250_ADDRESS, USER_CTRL, 0x20);              // I2C master on
+  writeByte(MPU9250_ADDRESS, INT_ENABLE, 0x01);             // data ready interrupt
+  delay(10);
+}
+
+void MPU9250::enableFifo(bool enable)
+{
+  // Empty the FIFO, and start or stop filling it with magnetometer records.
+  writeByte(MPU9250_ADDRESS, FIFO_EN, 0x00);
+  writeByte(MPU9250_ADDRESS, USER_CTRL, 0x24);   // reset the FIFO, I2C master still on
+  if (enable)
+  {
+    writeByte(MPU9250_ADDRESS, USER_CTRL, 0x60); // FIFO and I2C master on
+    writeByte(MPU9250_ADDRESS, FIFO_EN, 0x01);   // SLV0 data
+  }
+}
+
+bool MPU9250::decodeMagRecord(const uint8_t * record)
+{
+  // Sets magCount, mx, my and mz from a magnetometer record, as readMagData() and Read() do.
+  // Returns false, leaving the values unchanged, if the record shows a magnetic sensor overflow.
+  if (record[7] & 0x08)
+  {
+    return false;
+  }
+
+  // Data stored as little Endian
+  magCount[0] = ((int16_t)record[2] << 8) | record[1];
+  magCount[1] = ((int16_t)record[4] << 8) | record[3];
+  magCount[2] = ((int16_t)record[6] << 8) | record[5];
+
+  mx = (float)magCount[0] * mRes * magCalibration[0] - magbias[0];
+  my = (float)magCount[1] * mRes * magCalibration[1] - magbias[1];
+  mz = (float)magCount[2] * mRes * magCalibration[2] - magbias[2];
+  return true;
+}
+
 // Wire.h read and write protocols
 void MPU9250::writeByte(uint8_t address, uint8_t subAddress, uint8_t data)
 {
@@ -466,7 +525,8 @@ uint8_t MPU9250::readByte( uint8_t address, uint8_t subAddress)
   return data;                             // Return data read from slave register
 }
 
-void MPU9250::readBytes(uint8_t address, uint8_t subAddress, uint8_t count,
+// Returns the number of bytes read, less than count on an I2C error.
+uint8_t MPU9250::readBytes(uint8_t address, uint8_t subAddress, uint8_t count,
                         uint8_t * dest)
 {  
     i2c_t3(I2CPort).beginTransmission(address);   // Initialize the Tx buffer
@@ -476,4 +536,5 @@ void MPU9250::readBytes(uint8_t address, uint8_t subAddress, uint8_t count,
   i2c_t3(I2CPort).requestFrom(address, count);  // Read bytes from slave register address 
   while (i2c_t3(I2CPort).available()) {
     dest[i++] = i2c_t3(I2CPort).read(); }         // Put read results in the Rx buffer
+  return i;
 }
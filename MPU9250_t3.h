@@ -212,6 +212,14 @@ class MPU9250
     // 2 for 8 Hz, 6 for 100 Hz continuous magnetometer data read
     uint8_t Mmode = 0x02;
 
+  public:
+    // Background sampling. V1.0 17/10/2026 John Semmens
+    // After initSampling() the MPU9250 reads the AK8963 itself, with its own I2C master, at each sample.
+    // A magnetometer record is the AK8963 ST1, HXL to HZH and ST2 registers, as copied to EXT_SENS_DATA_00.
+    // The records can go into the FIFO, 64 of them in its 512 bytes, and be read in one burst.
+    static const uint8_t MagRecordLength = 8;
+    static const uint16_t FifoSize = 512;
+
   public:
     uint8_t I2CPort;
     float pitch, yaw, roll;
@@ -269,7 +277,10 @@ class MPU9250
     void MPU9250SelfTest(float * destination);
     void writeByte(uint8_t, uint8_t, uint8_t);
     uint8_t readByte(uint8_t, uint8_t);
-    void readBytes(uint8_t, uint8_t, uint8_t, uint8_t *);
+    uint8_t readBytes(uint8_t, uint8_t, uint8_t, uint8_t *);
+    void initSampling(uint8_t sampleRateDivider);
+    void enableFifo(bool enable);
+    bool decodeMagRecord(const uint8_t * record);
 };  // class MPU9250
 
 #endif // _MPU9250_t3_H_
@@ -0,0 +1,342 @@
+// Ellipsoid (hard and soft iron) magnetometer calibration.
+// V1.0 17/10/2026 John Semmens
+
+#include "MagCalibration.h"
+
+static const double PriorWeight = 0.5;	// each of the 14 prior points counts as half a sample
+static const double MaxWeight = 2000;		// older samples are scaled down, so the fit follows changes
+static const float MinSpacing = 0.05;		// normalised distance from the last sample used, about 3 degrees of turn
+static const float MaxAxisRatio = 3;		// beyond this the fit is more likely poor coverage than real soft iron
+static const int Terms = EllipsoidFitTerms;
+
+static inline int Index(int i, int j)
+{
+	// position of A[i][j], i <= j, in the packed upper triangle.
+	return i * Terms - i * (i - 1) / 2 + (j - i);
+}
+
+void EllipsoidFit::Reset(const float centre[3], const float radius[3])
+{
+	// V1.0 17/10/2026 John Semmens
+	for (int i = 0; i < Terms * (Terms + 1) / 2; i++)
+	{
+		A[i] = 0;
+	}
+	for (int i = 0; i < Terms; i++)
+	{
+		B[i] = 0;
+	}
+	Weight = 0;
+	Samples = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		Centre[i] = centre[i];
+		Scale[i] = (radius[i] > 0) ? 1 / radius[i] : 1;
+		Last[i] = 0;
+	}
+
+	// the prior: the unit sphere in normalised coordinates, which is the min/max calibration's ellipsoid.
+	// The 6 axis directions and the 8 corner directions.
+	const double c = 0.57735;	// 1 / sqrt(3)
+	for (int axis = 0; axis < 3; axis++)
+	{
+		for (int sign = -1; sign <= 1; sign += 2)
+		{
+			double p[3] = { 0, 0, 0 };
+			p[axis] = sign;
+			AddPoint(p, PriorWeight);
+		}
+	}
+	for (int corner = 0; corner < 8; corner++)
+	{
+		double p[3] = { (corner & 1) ? c : -c, (corner & 2) ? c : -c, (corner & 4) ? c : -c };
+		AddPoint(p, PriorWeight);
+	}
+}
+
+void EllipsoidFit::AddPoint(const double p[3], double weight)
+{
+	// add the point's terms to the normal equations.
+	double d[Terms] = {
+		p[0] * p[0], p[1] * p[1], p[2] * p[2],
+		2 * p[1] * p[2], 2 * p[0] * p[2], 2 * p[0] * p[1],
+		2 * p[0], 2 * p[1], 2 * p[2] };
+
+	for (int i = 0; i < Terms; i++)
+	{
+		for (int j = i; j < Terms; j++)
+		{
+			A[Index(i, j)] += weight * d[i] * d[j];
+		}
+		B[i] += weight * d[i];
+	}
+	Weight += weight;
+}
+
+bool EllipsoidFit::AddSample(float x, float y, float z)
+{
+	// V1.0 17/10/2026 John Semmens
+	float n[3] = { (x - Centre[0]) * Scale[0], (y - Centre[1]) * Scale[1], (z - Centre[2]) * Scale[2] };
+
+	float dx = n[0] - Last[0];
+	float dy = n[1] - Last[1];
+	float dz = n[2] - Last[2];
+	if (dx * dx + dy * dy + dz * dz < MinSpacing * MinSpacing)
+	{
+		return false;
+	}
+
+	if (Weight >= MaxWeight)
+	{
+		// exponential forgetting, keeping the total weight bounded.
+		double k = (MaxWeight - 1) / Weight;
+		for (int i = 0; i < Terms * (Terms + 1) / 2; i++)
+		{
+			A[i] *= k;
+		}
+		for (int i = 0; i < Terms; i++)
+		{
+			B[i] *= k;
+		}
+		Weight *= k;
+	}
+
+	double p[3] = { n[0], n[1], n[2] };
+	AddPoint(p, 1);
+	Last[0] = n[0];
+	Last[1] = n[1];
+	Last[2] = n[2];
+	Samples++;
+	return true;
+}
+
+static void Eigen3(double m[3][3], double values[3], double vectors[3][3])
+{
+	// eigenvalues and eigenvectors (columns) of a symmetric 3x3 matrix, by Jacobi rotations. m is destroyed.
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			vectors[i][j] = (i == j) ? 1 : 0;
+		}
+	}
+
+	for (int sweep = 0; sweep < 20; sweep++)
+	{
+		double off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+		if (off < 1e-24)
+		{
+			break;
+		}
+
+		for (int p = 0; p < 2; p++)
+		{
+			for (int q = p + 1; q < 3; q++)
+			{
+				if (fabs(m[p][q]) < 1e-30)
+				{
+					continue;
+				}
+
+				double theta = (m[q][q] - m[p][p]) / (2 * m[p][q]);
+				double t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta * theta + 1));
+				double c = 1 / sqrt(t * t + 1);
+				double s = t * c;
+
+				for (int k = 0; k < 3; k++)
+				{
+					double mkp = m[k][p];
+					double mkq = m[k][q];
+					m[k][p] = c * mkp - s * mkq;
+					m[k][q] = s * mkp + c * mkq;
+				}
+				for (int k = 0; k < 3; k++)
+				{
+					double mpk = m[p][k];
+					double mqk = m[q][k];
+					m[p][k] = c * mpk - s * mqk;
+					m[q][k] = s * mpk + c * mqk;
+				}
+				for (int k = 0; k < 3; k++)
+				{
+					double vkp = vectors[k][p];
+					double vkq = vectors[k][q];
+					vectors[k][p] = c * vkp - s * vkq;
+					vectors[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		values[i] = m[i][i];
+	}
+}
+
+void EllipsoidFit::Fit(MagCalibrationType& result)
+{
+	// V1.0 17/10/2026 John Semmens
+	double L[Terms][Terms];
+	double theta[Terms];
+
+	result.Valid = false;
+	result.Samples = Samples;
+
+	// Cholesky factorisation of the normal matrix, A = L L'.
+	for (int j = 0; j < Terms; j++)
+	{
+		double sum = A[Index(j, j)];
+		for (int k = 0; k < j; k++)
+		{
+			sum -= L[j][k] * L[j][k];
+		}
+		if (sum <= 1e-12 * A[Index(j, j)] || sum <= 0)
+		{
+			return;
+		}
+		L[j][j] = sqrt(sum);
+
+		for (int i = j + 1; i < Terms; i++)
+		{
+			sum = A[Index(j, i)];
+			for (int k = 0; k < j; k++)
+			{
+				sum -= L[i][k] * L[j][k];
+			}
+			L[i][j] = sum / L[j][j];
+		}
+	}
+
+	// solve L y = B, then L' theta = y.
+	for (int i = 0; i < Terms; i++)
+	{
+		double sum = B[i];
+		for (int k = 0; k < i; k++)
+		{
+			sum -= L[i][k] * theta[k];
+		}
+		theta[i] = sum / L[i][i];
+	}
+	for (int i = Terms - 1; i >= 0; i--)
+	{
+		double sum = theta[i];
+		for (int k = i + 1; k < Terms; k++)
+		{
+			sum -= L[k][i] * theta[k];
+		}
+		theta[i] = sum / L[i][i];
+	}
+
+	// x'Mx + 2v'x = 1
+	double M[3][3] = {
+		{ theta[0], theta[5], theta[4] },
+		{ theta[5], theta[1], theta[3] },
+		{ theta[4], theta[3], theta[2] } };
+	double v[3] = { theta[6], theta[7], theta[8] };
+
+	// centre c = -M^-1 v, by the adjugate.
+	double adj[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			int i1 = (j + 1) % 3, i2 = (j + 2) % 3, j1 = (i + 1) % 3, j2 = (i + 2) % 3;
+			adj[i][j] = M[i1][j1] * M[i2][j2] - M[i1][j2] * M[i2][j1];
+		}
+	}
+	double det = M[0][0] * adj[0][0] + M[0][1] * adj[1][0] + M[0][2] * adj[2][0];
+	if (det <= 0)
+	{
+		return;
+	}
+
+	double c[3];
+	for (int i = 0; i < 3; i++)
+	{
+		c[i] = -(adj[i][0] * v[0] + adj[i][1] * v[1] + adj[i][2] * v[2]) / det;
+	}
+
+	// (x - c)'M(x - c) = k
+	double k = 1 - (v[0] * c[0] + v[1] * c[1] + v[2] * c[2]);
+	if (k <= 0)
+	{
+		return;
+	}
+
+	// the ellipsoid in raw counts is Scale E Scale, with E = M / k. Its symmetric square root maps it to the sphere
+	// without a rotation, so the heading isn't turned. The common scale is taken out to keep the numbers near 1.
+	double common = cbrt((double)Scale[0] * Scale[1] * Scale[2]);
+	double E[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			E[i][j] = M[i][j] / k * (Scale[i] / common) * (Scale[j] / common);
+		}
+	}
+
+	double values[3];
+	double vectors[3][3];
+	Eigen3(E, values, vectors);
+
+	double minValue = values[0];
+	double maxValue = values[0];
+	for (int i = 1; i < 3; i++)
+	{
+		minValue = min(minValue, values[i]);
+		maxValue = max(maxValue, values[i]);
+	}
+	if (minValue <= 0)
+	{
+		return;
+	}
+	result.AxisRatio = sqrt(maxValue / minValue);
+
+	// SoftIron = common V sqrt(values) V', HardIron = Centre + c / Scale.
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			double w = 0;
+			for (int e = 0; e < 3; e++)
+			{
+				w += vectors[i][e] * sqrt(values[e]) * vectors[j][e];
+			}
+			result.SoftIron[i * 3 + j] = w * common;
+		}
+		result.HardIron[i] = Centre[i] + c[i] / Scale[i];
+	}
+
+	// the residual sum of (d'theta - 1)^2 from the sums: theta'A theta - 2 theta'B + Weight.
+	// Near the surface, d'theta - 1 is about 2k times the relative radial distance.
+	double residual = Weight;
+	for (int i = 0; i < Terms; i++)
+	{
+		double row = 0;
+		for (int j = 0; j < Terms; j++)
+		{
+			row += A[(i <= j) ? Index(i, j) : Index(j, i)] * theta[j];
+		}
+		residual += theta[i] * row - 2 * theta[i] * B[i];
+	}
+	result.Quality = 100 * sqrt(max(residual, 0.0) / Weight) / (2 * k);
+
+	const float* s = result.SoftIron;
+	float softDet = s[0] * (s[4] * s[8] - s[5] * s[7]) - s[1] * (s[3] * s[8] - s[5] * s[6]) + s[2] * (s[3] * s[7] - s[4] * s[6]);
+	result.FieldStrength = (softDet > 0) ? pow(softDet, -1.0 / 3) : 0;
+
+	result.Valid = result.AxisRatio <= MaxAxisRatio;
+}
+
+void MagCalibrationApply(const float softIron[9], const float hardIron[3], const float raw[3], float corrected[3])
+{
+	// V1.0 17/10/2026 John Semmens
+	float d[3] = { raw[0] - hardIron[0], raw[1] - hardIron[1], raw[2] - hardIron[2] };
+
+	for (int i = 0; i < 3; i++)
+	{
+		corrected[i] = softIron[i * 3] * d[0] + softIron[i * 3 + 1] * d[1] + softIron[i * 3 + 2] * d[2];
+	}
+}
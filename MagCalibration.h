@@ -0,0 +1,64 @@
+// MagCalibration.h
+
+// Ellipsoid (hard and soft iron) calibration of a magnetometer, fitted incrementally to streamed samples.
+// The min/max calibration only finds an offset and a scale for each axis, so soft iron, which tilts and
+// squashes the sphere of readings into an ellipsoid, is left as a heading error that the cardinal corrections
+// can only patch at four points.
+// The fit is an algebraic least squares fit of x'Mx + 2v'x = 1. Only the sums of its normal equations are kept,
+// 54 numbers, so the memory used is the same however many samples are added.
+// Samples close to the last one used are skipped, so a long time on one heading doesn't outweigh the rest.
+// The fit starts from the min/max calibration, as prior points on its ellipsoid, so the directions the
+// samples don't cover, usually up and down on a boat that only heels a little, stay as they were.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _MAGCALIBRATION_h
+#define _MAGCALIBRATION_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+static const int EllipsoidFitTerms = 9;	// x^2 y^2 z^2 2yz 2xz 2xy 2x 2y 2z
+
+struct MagCalibrationType {
+	float SoftIron[9];		// row major. SoftIron * (raw - HardIron) is of unit length on the fitted ellipsoid.
+	float HardIron[3];		// raw counts
+	float Quality;			// rms distance of the samples from the fitted ellipsoid, % of the field. Lower is better.
+	float FieldStrength;	// mean radius, raw counts
+	float AxisRatio;		// longest to shortest axis of the ellipsoid
+	unsigned long Samples;	// samples used
+	bool Valid;
+};
+
+class EllipsoidFit
+{
+public:
+	// start again, with the prior from a min/max calibration: its centre and the radius on each axis.
+	void Reset(const float centre[3], const float radius[3]);
+
+	// add a raw sample. Returns false if it was skipped as too close to the last one used.
+	bool AddSample(float x, float y, float z);
+
+	// solve for the calibration. result.Valid is false if the samples don't define an ellipsoid.
+	void Fit(MagCalibrationType& result);
+
+	unsigned long Samples;
+
+private:
+	double A[EllipsoidFitTerms * (EllipsoidFitTerms + 1) / 2];	// sum of d d', upper triangle by rows
+	double B[EllipsoidFitTerms];		// sum of d
+	double Weight;						// sum of the weights, for the residual
+
+	float Centre[3];					// the samples are normalised by the prior, to keep the sums well scaled.
+	float Scale[3];
+	float Last[3];						// the last sample used, normalised
+
+	void AddPoint(const double p[3], double weight);
+};
+
+// corrected = SoftIron * (raw - HardIron)
+void MagCalibrationApply(const float softIron[9], const float hardIron[3], const float raw[3], float corrected[3]);
+
+#endif
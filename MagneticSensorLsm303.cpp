@@ -33,6 +33,21 @@ MagneticSensorLsm303::MagneticSensorLsm303(void)
   io_timeout = 0;  ///< 0 = no timeout
   did_timeout = false;
   DeviceOk = false;
+  pending = 0;
+  readFailed = false;
+  readStarted = false;
+  accDevice = magDevice = -1;
+  fifoTransaction.Result = accTransaction.Result = magTransaction.Result = tempTransaction.Result = I2CResultType::Idle;
+  burstCount = 0;
+  tempRead = false;
+  temperatureC = 0;
+  burstReads = burstErrors = burstOverruns = 0;
+  accSamples = 1;
+  oversampling = false;
+  ellipsoidCalibration = false;
+  fifoSamples = fifoOverruns = 0;
+  accHistoryNext = magHistoryNext = 0;
+  accPrimed = magPrimed = false;
 }
 
 void MagneticSensorLsm303::EnableCalibration(bool _CalibrateMode)
@@ -204,6 +219,9 @@ bool MagneticSensorLsm303::init(deviceType device, sa0State sa0)
       Serial.println("LSM303DLH");
       break;
   }
+
+  accDevice = I2CAddDevice(I2CPort, acc_address, "LSM303 acc");
+  magDevice = I2CAddDevice(I2CPort, mag_address, "LSM303 mag");
   
   return true;
 }
@@ -381,19 +399,20 @@ void MagneticSensorLsm303::readAcc(void)
     }
   }
 
-  byte xla = Wire.read();
-  byte xha = Wire.read();
-  byte yla = Wire.read();
-  byte yha = Wire.read();
-  byte zla = Wire.read();
-  byte zha = Wire.read();
+  byte raw[6];
+  Wire.read(raw, 6);
+  decodeAcc(raw);
+}
 
+///< Stores the 6 accelerometer data bytes, in register order, in vector a
+void MagneticSensorLsm303::decodeAcc(const byte* raw)
+{
   ///< combine high and low bytes
   ///< This no longer drops the lowest 4 bits of the readings from the DLH/DLM/DLHC, which are always 0
   ///< (12-bit resolution, left-aligned). The D has 16-bit resolution
-  accelerometer.x = (int16_t)(xha << 8 | xla);
-  accelerometer.y = (int16_t)(yha << 8 | yla);
-  accelerometer.z = (int16_t)(zha << 8 | zla);
+  accelerometer.x = (int16_t)(raw[1] << 8 | raw[0]);
+  accelerometer.y = (int16_t)(raw[3] << 8 | raw[2]);
+  accelerometer.z = (int16_t)(raw[5] << 8 | raw[4]);
 }
 
 ///< Reads the 3 magnetometer channels and stores them in vector m
@@ -416,39 +435,47 @@ void MagneticSensorLsm303::readMag(void)
     }
   }
 
+  byte raw[6];
+  Wire.read(raw, 6);
+  decodeMag(raw);
+}
+
+///< Stores the 6 magnetometer data bytes, in register order, in vector m
+void MagneticSensorLsm303::decodeMag(const byte* raw)
+{
   byte xlm, xhm, ylm, yhm, zlm, zhm;
 
   if (_device == device_D)
   {
     ///< D: X_L, X_H, Y_L, Y_H, Z_L, Z_H
-    xlm = Wire.read();
-    xhm = Wire.read();
-    ylm = Wire.read();
-    yhm = Wire.read();
-    zlm = Wire.read();
-    zhm = Wire.read();
+    xlm = raw[0];
+    xhm = raw[1];
+    ylm = raw[2];
+    yhm = raw[3];
+    zlm = raw[4];
+    zhm = raw[5];
   }
   else
   {
     ///< DLHC, DLM, DLH: X_H, X_L...
-    xhm = Wire.read();
-    xlm = Wire.read();
+    xhm = raw[0];
+    xlm = raw[1];
 
     if (_device == device_DLH)
     {
       ///< DLH: ...Y_H, Y_L, Z_H, Z_L
-      yhm = Wire.read();
-      ylm = Wire.read();
-      zhm = Wire.read();
-      zlm = Wire.read();
+      yhm = raw[2];
+      ylm = raw[3];
+      zhm = raw[4];
+      zlm = raw[5];
     }
     else
     {
       ///< DLM, DLHC: ...Z_H, Z_L, Y_H, Y_L
-      zhm = Wire.read();
-      zlm = Wire.read();
-      yhm = Wire.read();
-      ylm = Wire.read();
+      zhm = raw[2];
+      zlm = raw[3];
+      yhm = raw[4];
+      ylm = raw[5];
     }
   }
 
@@ -463,7 +490,12 @@ void MagneticSensorLsm303::read(void)
 {
   readAcc();
   readMag();
+  calculateAttitude();
+}
 
+///< Calculates pitch and roll from the accelerometer, and updates the calibration when it is running
+void MagneticSensorLsm303::calculateAttitude(void)
+{
   pitch = (atan2(-accelerometer.x, sqrt((long)accelerometer.y * accelerometer.y + (long)accelerometer.z * accelerometer.z)) * 180) / PI;
   roll = (atan2(accelerometer.y, accelerometer.z) * 180) / PI;
 
@@ -471,16 +503,322 @@ void MagneticSensorLsm303::read(void)
       UpdateCalibration();
 }
 
+///< Non-blocking read. V1.0 17/10/2026 John Semmens
+///< V1.1 17/10/2026 transactions queued with the I2C manager, rather than chained by i2c_t3 callbacks of our own.
+///< The blocking read() waits about 1.5 ms at 100 kHz for the two register address writes and the two 6 byte reads,
+///< and readTempC() as long again for its two single register reads, every 25 ms in the FastLoop.
+///< startRead() queues a register address write and read for the accelerometer, the magnetometer, and now and then
+///< the temperature, and returns. The results are left in the raw buffers until collect() decodes them.
+///< When oversampling, the FIFO status is read first, and its completion queues the read of the samples in the FIFO.
+static const uint8_t CompassPriority = 0;           ///< the steering uses the compass. Ahead of everything else.
+static const uint32_t CompassDeadline_us = 20000;   ///< drop a transaction that can't start within most of a FastLoop
+
+void MagneticSensorLsm303::setupTransaction(I2CTransactionType& t, int device, byte reg, uint16_t length, byte* data)
+{
+  t.Device = device;
+  t.Priority = CompassPriority;
+  t.TxLength = 1;
+  t.Tx[0] = reg;
+  t.RxLength = length;
+  t.Rx = data;
+  t.Deadline_us = CompassDeadline_us;
+  t.Done = transactionDone;
+  t.Context = this;
+}
+
+void MagneticSensorLsm303::startRead(void)
+{
+  if (!DeviceOk || accDevice < 0 || magDevice < 0 || pending > 0)
+  {
+    // the last read hasn't finished. collect() counts it.
+    return;
+  }
+
+  readStarted = true;
+  readFailed = false;
+  tempRead = false;
+  if (++burstCount >= TempInterval)
+  {
+    burstCount = 0;
+    tempRead = true;
+  }
+
+  ///< assert the MSB of the address to get the accelerometer to do slave-transmit subaddress updating.
+  ///< In FIFO mode the address wraps from OUT_Z_H_A back to OUT_X_L_A, so all the samples are read in one transfer.
+  setupTransaction(fifoTransaction, accDevice, FIFO_SRC_REG_A, 1, &fifoStatus);
+  setupTransaction(accTransaction, accDevice, OUT_X_L_A | (1 << 7), 6, accRaw);
+  ///< If LSM303D, assert MSB to enable subaddress updating
+  ///< OUT_X_L_M comes first on D, OUT_X_H_M on others
+  setupTransaction(magTransaction, magDevice,
+    (_device == device_D) ? translated_regs[-OUT_X_L_M] | (1 << 7) : translated_regs[-OUT_X_H_M], 6, magRaw);
+  setupTransaction(tempTransaction, magDevice, TEMP_OUT_H_M, 2, tempRaw);
+
+  // count them all first, as each can finish as soon as it is queued.
+  pending = tempRead ? 3 : 2;
+  if (oversampling)
+  {
+    I2CQueue(&fifoTransaction);
+  }
+  else
+  {
+    accSamples = 1;
+    I2CQueue(&accTransaction);
+  }
+  I2CQueue(&magTransaction);
+  if (tempRead)
+  {
+    I2CQueue(&tempTransaction);
+  }
+}
+
+void MagneticSensorLsm303::transactionDone(I2CTransactionType* t)
+{
+  // called from the I2C interrupt when a transaction of the read has finished.
+  MagneticSensorLsm303* sensor = (MagneticSensorLsm303*)t->Context;
+
+  if (t->Result != I2CResultType::Ok)
+  {
+    sensor->readFailed = true;
+  }
+  else if (t == &sensor->fifoTransaction)
+  {
+    // FIFO_SRC_REG_A: OVRN_FIFO (bit 6) is set when all 32 places are full. Otherwise FSS (bits 4:0) is the number of samples.
+    if (sensor->fifoStatus & 0x40)
+    {
+      sensor->fifoOverruns++;
+      sensor->accSamples = FifoDepth;
+    }
+    else
+    {
+      sensor->accSamples = sensor->fifoStatus & 0x1F;
+    }
+
+    if (sensor->accSamples > 0)
+    {
+      sensor->accTransaction.RxLength = sensor->accSamples * 6;
+      sensor->pending++;
+      I2CQueue(&sensor->accTransaction);
+    }
+  }
+
+  sensor->pending--;
+}
+
+bool MagneticSensorLsm303::collect(void)
+{
+  if (!readStarted)
+  {
+    return false;
+  }
+
+  if (pending > 0)
+  {
+    // the previous read hasn't finished. Leave it to finish, and use the last results again.
+    burstOverruns++;
+    return false;
+  }
+
+  readStarted = false;
+  if (readFailed)
+  {
+    burstErrors++;
+    return false;
+  }
+
+  if (oversampling)
+  {
+    filterAcc();
+    filterMag();
+  }
+  else
+  {
+    decodeAcc(accRaw);
+    decodeMag(magRaw);
+  }
+  if (tempRead)
+  {
+    // same conversion as readTempC()
+    temperatureC = (float)((tempRaw[0] << 4) + (tempRaw[1] >> 4)) / 8 + 20;
+  }
+  burstReads++;
+
+  calculateAttitude();
+  return true;
+}
+
+///< Oversampling. V1.0 17/10/2026 John Semmens
+///< Low pass FIR filters, Hamming windowed sinc, -6 dB at 10 Hz.
+///< Accelerometer: 200 Hz samples. -30 dB at 20 Hz, the Nyquist frequency of the 40 Hz FastLoop, and -44 dB above 30 Hz.
+///< Magnetometer: 40 Hz samples, one for each read. The magnetometer has no FIFO, so each read takes the latest of its 75 Hz
+///< samples, and anything above 20 Hz has already aliased by then. This filter only smooths the samples it is given.
+///< Both delay by 50 ms, 10 samples at 200 Hz and 2 samples at 40 Hz, so the tilt compensation uses readings from the same time.
+///< V1.1 17/10/2026 the history is taken oldest first. Rotated, the coefficients were a different filter at each position.
+///< Sea state motion, at below 1 Hz, is passed unchanged.
+static constexpr float AccFir[] = {
+  0.004085f, 0.006067f, 0.011242f, 0.020029f, 0.032211f, 0.046909f, 0.062675f, 0.077708f, 0.090137f, 0.098336f,
+  0.101199f,
+  0.098336f, 0.090137f, 0.077708f, 0.062675f, 0.046909f, 0.032211f, 0.020029f, 0.011242f, 0.006067f, 0.004085f };
+static constexpr float MagFir[] = { 0.020104f, 0.230867f, 0.498059f, 0.230867f, 0.020104f };
+static_assert(sizeof(AccFir) / sizeof(AccFir[0]) == MagneticSensorLsm303::AccFirTaps, "AccFir must have AccFirTaps coefficients.");
+static_assert(sizeof(MagFir) / sizeof(MagFir[0]) == MagneticSensorLsm303::MagFirTaps, "MagFir must have MagFirTaps coefficients.");
+
+///< Adds a sample to an FIR filter history, at next. An empty history is filled with the sample.
+static void firAdd(int16_t* history, uint8_t taps, uint8_t next, int16_t sample, bool fill)
+{
+  if (fill)
+  {
+    for (uint8_t i = 0; i < taps; i++)
+    {
+      history[i] = sample;
+    }
+  }
+  else
+  {
+    history[next] = sample;
+  }
+}
+
+///< The FIR filter output. next is where the next sample goes, which is the oldest sample in the history.
+///< The coefficients are symmetric, so newest first would do as well, but not starting part way through the history.
+static int16_t firOutput(const float* coefficients, const int16_t* history, uint8_t taps, uint8_t next)
+{
+  float sum = 0;
+  for (uint8_t i = 0; i < taps; i++)
+  {
+    sum += coefficients[i] * history[(next + i) % taps];
+  }
+  return (int16_t)lroundf(sum);
+}
+
+///< Decodes the accelerometer samples read from the FIFO into the history, and filters them.
+///< Only one output is calculated for each read, which is the decimation.
+void MagneticSensorLsm303::filterAcc(void)
+{
+  if (accSamples == 0)
+  {
+    // nothing new. Keep the last output.
+    return;
+  }
+
+  for (uint8_t i = 0; i < accSamples; i++)
+  {
+    decodeAcc(accRaw + 6 * i);
+    firAdd(accHistory[0], AccFirTaps, accHistoryNext, accelerometer.x, !accPrimed);
+    firAdd(accHistory[1], AccFirTaps, accHistoryNext, accelerometer.y, !accPrimed);
+    firAdd(accHistory[2], AccFirTaps, accHistoryNext, accelerometer.z, !accPrimed);
+    accPrimed = true;
+    accHistoryNext = (accHistoryNext + 1) % AccFirTaps;
+  }
+  fifoSamples += accSamples;
+
+  accelerometer.x = firOutput(AccFir, accHistory[0], AccFirTaps, accHistoryNext);
+  accelerometer.y = firOutput(AccFir, accHistory[1], AccFirTaps, accHistoryNext);
+  accelerometer.z = firOutput(AccFir, accHistory[2], AccFirTaps, accHistoryNext);
+}
+
+///< Decodes the magnetometer sample into the history, and filters it.
+void MagneticSensorLsm303::filterMag(void)
+{
+  decodeMag(magRaw);
+  firAdd(magHistory[0], MagFirTaps, magHistoryNext, magnetometer.x, !magPrimed);
+  firAdd(magHistory[1], MagFirTaps, magHistoryNext, magnetometer.y, !magPrimed);
+  firAdd(magHistory[2], MagFirTaps, magHistoryNext, magnetometer.z, !magPrimed);
+  magPrimed = true;
+  magHistoryNext = (magHistoryNext + 1) % MagFirTaps;
+
+  magnetometer.x = firOutput(MagFir, magHistory[0], MagFirTaps, magHistoryNext);
+  magnetometer.y = firOutput(MagFir, magHistory[1], MagFirTaps, magHistoryNext);
+  magnetometer.z = firOutput(MagFir, magHistory[2], MagFirTaps, magHistoryNext);
+}
+
+void MagneticSensorLsm303::setOversampling(bool enable)
+{
+  if (_device != device_DLHC)
+  {
+    // the FIFO register settings below are for the DLHC.
+    oversampling = false;
+    return;
+  }
+
+  if (enable)
+  {
+    ///< 0x67 = 0b01100111
+    ///< ODR = 0110 (200 Hz ODR); LPen = 0 (normal mode); Zen = Yen = Xen = 1 (all axes enabled)
+    writeAccReg(CTRL_REG1_A, 0x67);
+
+    ///< 0x40 = 0b01000000
+    ///< FIFO_EN = 1
+    writeAccReg(CTRL_REG5_A, 0x40);
+
+    ///< 0x80 = 0b10000000
+    ///< FM = 10 (stream mode, the oldest sample is dropped when full)
+    writeAccReg(FIFO_CTRL_REG_A, 0x80);
+
+    ///< 0x98 = 0b10011000
+    ///< TEMP_EN = 1; DO = 110 (75 Hz ODR)
+    writeMagReg(CRA_REG_M, 0x98);
+  }
+  else
+  {
+    ///< FM = 00 (bypass mode), FIFO_EN = 0, then the rates set by enable()
+    writeAccReg(FIFO_CTRL_REG_A, 0x00);
+    writeAccReg(CTRL_REG5_A, 0x00);
+    writeAccReg(CTRL_REG1_A, 0x47);
+    writeMagReg(CRA_REG_M, 0x8c);
+  }
+
+  oversampling = enable;
+  accPrimed = magPrimed = false;
+}
+
 float MagneticSensorLsm303::getNavigationAngle(void)
 {
+  return getNavigationAngle(magnetometer, accelerometer, ellipsoidCalibration ? softIron : NULL, hardIron);
+}
+
+float MagneticSensorLsm303::getNavigationAngle(vector<int16_t> mag, vector<int16_t> acc, const float* softIron, const float* hardIron)
+{
+  vector<float> m;
+
+  if (softIron == NULL)
+  {
+    ///< subtract offset (average of min and max) from magnetometer readings
+    m.x = mag.x - ((int32_t)magnetometer_min.x + magnetometer_max.x) / 2;
+    m.y = mag.y - ((int32_t)magnetometer_min.y + magnetometer_max.y) / 2;
+    m.z = mag.z - ((int32_t)magnetometer_min.z + magnetometer_max.z) / 2;
+  }
+  else
+  {
+    ///< hard and soft iron correction, 17/10/2026 John Semmens
+    float raw[3] = { (float)mag.x, (float)mag.y, (float)mag.z };
+    float corrected[3];
+    MagCalibrationApply(softIron, hardIron, raw, corrected);
+    m.x = corrected[0];
+    m.y = corrected[1];
+    m.z = corrected[2];
+  }
+
   if (_device == device_D)
   {
-    return heading((vector<int>){1, 0, 0});
+    return heading(m, acc, (vector<int>){1, 0, 0});
   }
   else
   {
-    return heading((vector<int>){0, -1, 0});
+    return heading(m, acc, (vector<int>){0, -1, 0});
+  }
+}
+
+void MagneticSensorLsm303::setEllipsoidCalibration(bool enable, const float softIron[9], const float hardIron[3])
+{
+  for (int i = 0; i < 9; i++)
+  {
+    this->softIron[i] = softIron[i];
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    this->hardIron[i] = hardIron[i];
   }
+  ellipsoidCalibration = enable;
 }
 
 void MagneticSensorLsm303::vectorNormalize(vector<float> *a)
@@ -491,21 +829,14 @@ void MagneticSensorLsm303::vectorNormalize(vector<float> *a)
   a->z /= mag;
 }
 
-template <typename T> float MagneticSensorLsm303::heading(vector<T> from)
+template <typename T> float MagneticSensorLsm303::heading(vector<float> mag, vector<int16_t> acc, vector<T> from)
 {
-    vector<int32_t> temp_m = {magnetometer.x, magnetometer.y, magnetometer.z};
-
-    ///< subtract offset (average of min and max) from magnetometer readings
-    temp_m.x -= ((int32_t)magnetometer_min.x + magnetometer_max.x) / 2;
-    temp_m.y -= ((int32_t)magnetometer_min.y + magnetometer_max.y) / 2;
-    temp_m.z -= ((int32_t)magnetometer_min.z + magnetometer_max.z) / 2;
-
     ///< compute E and N
     vector<float> E;
     vector<float> N;
-    vectorCross(&temp_m, &accelerometer, &E);
+    vectorCross(&mag, &acc, &E);
     vectorNormalize(&E);
-    vectorCross(&accelerometer, &E, &N);
+    vectorCross(&acc, &E, &N);
     vectorNormalize(&N);
 
     ///< compute heading
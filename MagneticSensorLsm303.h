@@ -23,6 +23,8 @@
 #ifndef MAGNETICSENSORLSM303_h
 #define MAGNETICSENSORLSM303_h
 #include <Arduino.h> ///< for byte data type
+#include "I2CManager.h"
+#include "MagCalibration.h"
 ///< The Arduino two-wire interface uses a 7-bit number for the address,
 ///< and sets the last bit correctly based on reads and writes
 #define D_SA0_HIGH_ADDRESS                0b0011101 //x1D
@@ -278,13 +280,112 @@ class MagneticSensorLsm303
 	*/
     float getNavigationAngle(void);
 
+	/*!
+	*	@brief Get the tilt-compensated heading of the given readings, as getNavigationAngle() does for the current ones.
+	*          17/10/2026 John Semmens
+	*
+	*	@param mag raw magnetometer reading
+	*	@param acc accelerometer reading
+	*	@param softIron ellipsoid calibration, see MagCalibration.h. NULL for the min/max calibration.
+	*	@param hardIron ellipsoid calibration offset, raw counts
+	*	@return the heading in degrees
+	*/
+    float getNavigationAngle(vector<int16_t> mag, vector<int16_t> acc, const float* softIron, const float* hardIron);
+
+	/*!
+	*	@brief Use the ellipsoid calibration for getNavigationAngle() rather than the min/max calibration.
+	*          17/10/2026 John Semmens
+	*
+	*	@param enable on or off
+	*	@param softIron 3x3 soft iron matrix, row major. Copied.
+	*	@param hardIron hard iron offset, raw counts. Copied.
+	*/
+    void setEllipsoidCalibration(bool enable, const float softIron[9], const float hardIron[3]);
+
+    bool ellipsoidCalibration;      ///< getNavigationAngle() uses softIron and hardIron
+
     float pitch;
     float roll;
     float readTempC();
     uint8_t I2CPort;
     boolean DeviceOk;
 
+	/*!
+	*	@brief Starts a non-blocking read of the accelerometer and magnetometer, and every TempInterval reads
+	*          the temperature. The transfers are queued with the I2C manager, so this returns at once and
+	*          the bus is left to work in the background. 17/10/2026 John Semmens
+	*/
+    void startRead(void);
+
+	/*!
+	*	@brief Takes the results of the read started by startRead(), and calculates pitch and roll as read() does.
+	*
+	*	@return true if there were new results. false if no read was started, it is still in progress, or it failed.
+	*/
+    bool collect(void);
+
+	/*!
+	*	@brief Turns oversampling on or off. LSM303DLHC only. 17/10/2026 John Semmens
+	*          On: the accelerometer runs at 200 Hz into its FIFO, and startRead() reads all the samples in the FIFO
+	*          in one transfer. collect() passes them through a 21 tap low pass FIR filter, so the one accelerometer
+	*          reading for each FastLoop is decimated from about 5 samples rather than a single sample.
+	*          The magnetometer has no FIFO. It runs at 75 Hz and its one sample per read goes through a 5 tap FIR
+	*          filter, with the same 50 ms delay as the accelerometer filter, so the tilt compensation of the heading
+	*          uses readings from the same time. Taking one sample per read, it smooths but can't anti-alias.
+	*          Off: 50 Hz accelerometer, 7.5 Hz magnetometer and one sample of each per read, as set by enable().
+	*          Wait for the bus to be idle before calling.
+	*/
+    void setOversampling(bool enable);
+
+    bool oversampling;              ///< oversampling is on
+    static const uint8_t FifoDepth = 32;     ///< accelerometer FIFO samples
+    static const uint8_t AccFirTaps = 21;
+    static const uint8_t MagFirTaps = 5;
+    unsigned long fifoSamples;      ///< accelerometer samples read from the FIFO
+    unsigned long fifoOverruns;     ///< reads that found the FIFO full, and so may have lost samples
+
+    float temperatureC;             ///< temperature from the last read that included it
+    static const uint8_t TempInterval = 40;  ///< reads between temperature reads. 1 second at 25 ms.
+    unsigned long burstReads;       ///< reads completed
+    unsigned long burstErrors;      ///< reads that failed with a bus error or timeout, or missed their deadline
+    unsigned long burstOverruns;    ///< reads still in progress when collect() was called
+    int accDevice;                  ///< I2C manager devices, for the blocking register access of init and setOversampling
+    int magDevice;
+
   private:
+    float softIron[9];              ///< ellipsoid calibration
+    float hardIron[3];
+    I2CTransactionType fifoTransaction; ///< FIFO status, when oversampling
+    I2CTransactionType accTransaction;
+    I2CTransactionType magTransaction;
+    I2CTransactionType tempTransaction;
+    volatile uint8_t pending;       ///< transactions of the read not finished
+    volatile bool readFailed;
+    bool readStarted;
+    byte fifoStatus;
+    uint8_t burstCount;             ///< reads since the last temperature read
+    byte accRaw[FifoDepth * 6];
+    uint8_t accSamples;             ///< samples to read into accRaw
+    byte magRaw[6];
+    byte tempRaw[2];
+    bool tempRead;                  ///< this read included the temperature
+
+    static void transactionDone(I2CTransactionType* t);
+    void setupTransaction(I2CTransactionType& t, int device, byte reg, uint16_t length, byte* data);
+
+    void decodeAcc(const byte* raw);
+    void decodeMag(const byte* raw);
+    void calculateAttitude(void);
+
+    int16_t accHistory[3][AccFirTaps];  ///< x, y and z accelerometer samples for the FIR filter
+    int16_t magHistory[3][MagFirTaps];
+    uint8_t accHistoryNext;         ///< where the next sample goes, which is the oldest sample
+    uint8_t magHistoryNext;
+    bool accPrimed;                 ///< the history has been filled
+    bool magPrimed;
+    void filterAcc(void);
+    void filterMag(void);
+
     uint8_t valueL;
     uint8_t valueH;
     deviceType _device; ///< chip type (D, DLHC, DLM, or DLH)
@@ -313,7 +414,7 @@ class MagneticSensorLsm303
 	*    		"from" vector and north, in degrees
 	*
 	*/
-    template <typename T> float heading(vector<T> from);
+    template <typename T> float heading(vector<float> mag, vector<int16_t> acc, vector<T> from);
 
 	/*!
 	*	@brief  The number of three sum of squares
@@ -5,6 +5,7 @@
 // V1.1 30/8/2016 updated for reorganisation of navigation global variables into a structure
 // V1.2 28/4/2018 updated to reorganise design and improve quality.
 // V1.3 16/7/2019 adding the new Mission command for Steering a Wind Angle
+// V1.4 17/10/2026 mission step timing uses VirtualMillis, to support faster than real time simulation.
 
 #include "Mission.h"
 #include "configValues.h"
@@ -49,7 +50,7 @@ void MissionUpdate(void) {
 				StateValues.StartingMission = false;
 
 				// start command timer. Record the start time of each new command	
-				MissionValues.MissionCommandStartTime = millis();
+				MissionValues.MissionCommandStartTime = VirtualMillis();
 
 				//set up the next waypoint
 				UpdatePrevNextWP();
@@ -71,7 +72,7 @@ void MissionUpdate(void) {
 				//PowerControl(MissionValues.MissionList[StateValues.mission_index].controlMask);
 
 				// start command timer. Record the start time of each new command	
-				MissionValues.MissionCommandStartTime = millis(); 
+				MissionValues.MissionCommandStartTime = VirtualMillis(); 
 					
 				// Log Mission Step Details
 				SD_Logging_Event_MissionStep(StateValues.mission_index);
@@ -121,7 +122,7 @@ bool IsMissionStepComplete(void) {
 			// check if past duration and if so, advance mission index.
 			// mission command duration is expressed in minutes.
 			// perform the test using seconds. There was an overflow occuring when milliseconds was used
-			if (((millis() - MissionValues.MissionCommandStartTime)/1000) >= (MissionValues.MissionList[StateValues.mission_index].duration * 60))
+			if (((VirtualMillis() - MissionValues.MissionCommandStartTime)/1000) >= (MissionValues.MissionList[StateValues.mission_index].duration * 60))
 			{
 				StepComplete = true;
 
@@ -10,6 +10,13 @@
 // V1.7 2/1/2021 added Laylines for running to the NavData structure
 //				 added Port and Starboard Tack Running to SteeringCourseType enum
 // V1.8 22/7/2023 removed GPS power controls.
+// V1.9 17/10/2026 a change of the in-irons state triggers the flight recorder.
+// V1.10 17/10/2026 manoeuvre log messages are formatted into a fixed buffer, rather than built from Strings.
+// V1.11 17/10/2026 the cardinal corrections are not applied with the compass ellipsoid calibration.
+// V1.12 17/10/2026 added Navigation_Reset, to restart the filters and the manoeuvre state for each simulated batch run.
+//					The previous CTE and turn heading states moved from static locals to the file, so they can be reset.
+// V1.13 17/10/2026 the in-irons flight recorder trigger is ignored during a log replay.
+// V1.14 17/10/2026 Navigation_Reset also used before and after a log replay. The sailing state is reset by SailingNavigation_Reset.
 
 #include "location.h"
 #include "Navigation.h"
@@ -20,6 +27,9 @@
 #include "Wingsail.h"
 #include "Filters.h"
 #include "sim_vessel.h"
+#include "FlightRecorder.h"
+#include "TextFormat.h"
+#include "LogReplay.h"
 
 extern HALIMU imu;
 extern NavigationDataType NavData;
@@ -40,6 +50,12 @@ LowPassFilter SOGFilter;
 LowPassAngleFilter COGFilter;
 LowPassAngleFilter AWAFilter;
 
+// state kept between calls, reset by Navigation_Reset
+static int Prev_CTE;			// NavigationUpdate_SlowData
+static bool TurnHeadingReady;	// UpdateTurnHeadingV2
+static int Prev_CTS;
+static int TurnCounter;
+
 void NavigationUpdate_SlowData(void) // 5 seconds
 {
 	// calculate the DTW, BTW and CTE for the current Previous and Next Waypoints,
@@ -52,8 +68,7 @@ void NavigationUpdate_SlowData(void) // 5 seconds
 	//					Add handling for case when the WP  Valid flags are not valid.
 	// V1.4 12/11/2017 updated to change BRL to RLB.
 	// V1.5 21/10/2018 updated to change test for past waypoint to require it to be within range.
-
-	static int Prev_CTE;
+	// V1.6 17/10/2026 Prev_CTE moved to the file, so it can be reset.
 
 	if (NavData.next_WP_valid && gps.GPS_LocationIs_Valid(NavData.Currentloc)) {
 		NavData.RLB = get_bearing(NavData.prev_WP, NavData.next_WP);
@@ -114,7 +129,12 @@ void NavigationUpdate_SlowData(void) // 5 seconds
 	NavData.PortLaylineRunning = wrap_360_Int(NavData.TWD + 180 + Configuration.MinimumAngleDownWind);
 	NavData.StarboardLaylineRunning = wrap_360_Int(NavData.TWD + 180 - Configuration.MinimumAngleDownWind);
 
+	InIronsStateType PreviousInIronsState = NavData.InIronsState;
 	NavData.InIronsState = GetInIronsState(NavData);
+	if (NavData.InIronsState != PreviousInIronsState && !LogReplay_Active())
+	{
+		FlightRecorder_Trigger(frtInIrons);
+	}
 
 	// detect if past boundary and set state., provided we are beating, and not reaching or running.
 	if ((abs(NavData.CTE) > NavData.MaxCTE) && (abs(NavData.AWA_Avg) < 50))
@@ -216,6 +236,33 @@ void Navigation_Init(void)
 	AWAFilter.FilterConstant = 0.1;
 }
 
+void Navigation_Reset(void)
+{
+	// restart the navigation state, as if the vessel had just been switched on at its current location and heading.
+	// Used between simulated batch runs, so that each run starts from the same state, and before and after a log replay,
+	// so the replay and the live navigation don't carry on from each other.
+	// The filters start from the current values rather than zero. 
+	// The mission boundary (MaxCTE) is not changed, it is set by the mission.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 the tack, in-irons and target heading state reset by SailingNavigation_Reset, which also clears the CourseType.
+	TrueWindFilter.Init(NavData.AWD);
+	RollFilter.Init(0);
+	SOGFilter.Init(NavData.SOG_mps);
+	COGFilter.Init(NavData.COG);
+	HeadingErrorFilter.Init(0);
+	AWAFilter.Init(NavData.AWA);
+
+	NavData.CTE = 0;
+	NavData.TurnHDG = NavData.HDG;
+	NavData.TargetHDG = NavData.HDG;
+	SailingNavigation_Reset();
+
+	Prev_CTE = 0;
+	TurnHeadingReady = false;
+	Prev_CTS = 0;
+	TurnCounter = 0;
+}
+
 void GetTrueWind(void)
 {
 	// calculate the true wind 
@@ -253,12 +300,13 @@ void UpdateTurnHeadingV2(void)
 	//			This is because the TWD is poor approximation, which corrupts the wind direction, especially when running, and may add to instability.
 	// V2.4 18/10/2021 Added static variable "initialised" to prevent any actions until we've been here once before.   
 	// V2.5 5/6/2022 bug fix: previously forget to make TurnHeadingInitialised static. 
+	// V2.6 17/10/2026 log messages formatted into LogMessage.
+	// V2.7 17/10/2026 the static variables moved to the file, so they can be reset. TurnHeadingInitialised renamed TurnHeadingReady,
+	//					as it hid the unused global of the same name.
 	// 
 	// todo: this could be expanded to support gybe direction: CommencePortTack, CommenceStbdTack.
 
-	static bool TurnHeadingInitialised;
-	static int Prev_CTS;
-	static int TurnCounter;
+	char LogMessage[48];
 
 	// get the Current and Previous AWA based on TWD and Current and Previous CTS.
 	int PredictedAWA = AWA_Calculated(NavData.CTS, NavData.TWD);
@@ -269,7 +317,7 @@ void UpdateTurnHeadingV2(void)
 	// then COMMENCE
 	if ( ((PredictedAWA * PreviousAWA) < 0)
 		&& (Configuration.TackingMethod == ManoeuvreType::mtGybe) 
-		&& TurnHeadingInitialised 
+		&& TurnHeadingReady 
 		&& (NavData.ManoeuvreState == ManoeuvreStateType::mstNone || NavData.ManoeuvreState == ManoeuvreStateType::mstComplete)
 		)
 	{
@@ -283,7 +331,8 @@ void UpdateTurnHeadingV2(void)
 		{
 			NavData.ManoeuvreState = ManoeuvreStateType::mstCommenceToStbd;
 		}
-		SD_Logging_Event_Messsage("ManoeuvreState_0," + CourseTypeToString(NavData.ManoeuvreState));
+		FormatText(LogMessage, sizeof(LogMessage), "ManoeuvreState_0,%s", CourseTypeToString(NavData.ManoeuvreState));
+		SD_Logging_Event_Messsage(LogMessage);
 	}
 
 	//XXX asym gybe
@@ -318,7 +367,8 @@ void UpdateTurnHeadingV2(void)
 		// set the turn heading to be reaching on Port Tack, as an approach to final heading 
 		// but only if our turn heading doesn't overshoot CTS
 		NavData.TurnHDG = wrap_360_Int(NavData.AWD + GybeHoldAngle);
-		SD_Logging_Event_Messsage("ManoeuvreCalc_P," + String(NavData.AWD) + "," + String(GybeHoldAngle) + "," + String(NavData.AWD + GybeHoldAngle) + "," + String(NavData.TurnHDG));
+		FormatText(LogMessage, sizeof(LogMessage), "ManoeuvreCalc_P,%d,%d,%d,%d", NavData.AWD, GybeHoldAngle, NavData.AWD + GybeHoldAngle, NavData.TurnHDG);
+		SD_Logging_Event_Messsage(LogMessage);
 
 		if (abs(PredictedAWA) > 100) // if we are running then skip the approach step
 		{
@@ -334,7 +384,8 @@ void UpdateTurnHeadingV2(void)
 		// set the turn heading to be reaching on starboard Tack, as an approach to final heading 
 		// but only if our turn heading doesn't overshoot CTS
 		NavData.TurnHDG = wrap_360_Int(NavData.AWD - GybeHoldAngle);
-		SD_Logging_Event_Messsage("ManoeuvreCalc_S," + String(NavData.AWD) + "," + String(-GybeHoldAngle) + "," + String(NavData.AWD - GybeHoldAngle) + "," + String(NavData.TurnHDG));
+		FormatText(LogMessage, sizeof(LogMessage), "ManoeuvreCalc_S,%d,%d,%d,%d", NavData.AWD, -GybeHoldAngle, NavData.AWD - GybeHoldAngle, NavData.TurnHDG);
+		SD_Logging_Event_Messsage(LogMessage);
 
 		if (abs(PredictedAWA) > 100) // if we are running then skip the approach step
 		{
@@ -374,8 +425,9 @@ void UpdateTurnHeadingV2(void)
 	}
 
 	Prev_CTS = NavData.CTS;
-	TurnHeadingInitialised = true;
-	SD_Logging_Event_Messsage("ManoeuvreState_1," + CourseTypeToString(NavData.ManoeuvreState));
+	TurnHeadingReady = true;
+	FormatText(LogMessage, sizeof(LogMessage), "ManoeuvreState_1,%s", CourseTypeToString(NavData.ManoeuvreState));
+	SD_Logging_Event_Messsage(LogMessage);
 }
 
 int get_CTE_Correction(NavigationDataType NavData)
@@ -425,6 +477,19 @@ int AWA_Calculated(int CTS, int TWD)
 }
 
 int CompassDeviationCalc(int CompassAngle)
+{
+	// The deviation to be subtracted from the compass heading.
+	// The ellipsoid calibration corrects the soft iron errors that the cardinal corrections patch, so they aren't applied with it.
+	// V1.0 17/10/2026 John Semmens
+
+	if (Configuration.CompassEllipsoid)
+	{
+		return 0;
+	}
+	return CompassCardinalDeviation(CompassAngle);
+}
+
+int CompassCardinalDeviation(int CompassAngle)
 {
 	// function to provide a simple interpolated correction for the magnetic Angle returned by the WingAngle Sensor.
 	// This provides an error value to be subracted from the Wing Angle.
@@ -432,6 +497,7 @@ int CompassDeviationCalc(int CompassAngle)
 
 	// V1.0 17/7/2021 John Semmens
 	// V1.1 22/3/2022 updated for 0 to 360 degrees, rather than +/-180 degrees
+	// V1.2 17/10/2026 renamed from CompassDeviationCalc, which now chooses between this and the ellipsoid calibration.
 
 	float InterpolatedError = 0;
 
@@ -167,6 +167,7 @@ void NavigationUpdate_MediumData(void);
 void NavigationUpdate_FastData(void);
 
 void Navigation_Init(void);
+void Navigation_Reset(void);
 void GetTrueWind(void);
 void GetApparentWind(void);
 
@@ -177,6 +178,7 @@ void UpdateTurnHeadingV2(void);
 int AWA_Calculated(int CTS, int TWD);
 
 int CompassDeviationCalc(int CompassAngle);
+int CompassCardinalDeviation(int CompassAngle);
 
 void CalcDistToBoundary();
 #endif
@@ -12,6 +12,7 @@
 #endif
 
 #include "PID_v1.h"
+#include "HAL_Time.h"
 
 /*Constructor (...)*********************************************************
  *    The parameters specified here are those for for which we can't set up 
@@ -34,7 +35,7 @@ PID::PID(double* Input, double* Output, double* Setpoint,
     PID::SetControllerDirection(ControllerDirection);
     PID::SetTunings(Kp, Ki, Kd);
 
-    lastTime = millis()-SampleTime;				
+    lastTime = VirtualMillis()-SampleTime;				
 }
  
  
@@ -47,7 +48,7 @@ PID::PID(double* Input, double* Output, double* Setpoint,
 bool PID::Compute()
 {
    if(!inAuto) return false;
-   unsigned long now = millis();
+   unsigned long now = VirtualMillis();
    unsigned long timeChange = (now - lastTime);
    if(timeChange>=SampleTime)
    {
@@ -0,0 +1,363 @@
+// Configuration parameter registry.
+// Replaces the parameter set switch in the prs command and the parameter list switch in ListParameter.
+// The type of each parameter is taken from its field in configValuesType, so the table can't disagree with the structure.
+// Values are checked against the range in the table before they are set.
+//
+// Bulk dump and load:
+//	prd sends all the parameter values, ParameterDumpSize to a message: prd,<first parameter number>,<value>,<value>...
+//	The values are for the parameters in the table following the first, skipping unused parameter numbers.
+//	prb,<first parameter number>,<value>,<value>... loads them. A dump line with prd changed to prb can be sent back as is.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 a delimiter that is neither tab nor comma prints as ?, so a dump keeps one field per parameter.
+
+#include "ParameterRegistry.h"
+#include "configValues.h"
+#include "Steering.h"
+#include "HAL_IMU.h"
+#include <stddef.h>
+
+extern configValuesType Configuration;
+
+template <typename T> struct ParameterTypeOf;
+template <> struct ParameterTypeOf<bool> { static const ParameterTypeType Type = ptBool; };
+template <> struct ParameterTypeOf<char> { static const ParameterTypeType Type = ptChar; };
+template <> struct ParameterTypeOf<unsigned char> { static const ParameterTypeType Type = ptByte; };
+template <> struct ParameterTypeOf<short> { static const ParameterTypeType Type = ptShort; };
+template <> struct ParameterTypeOf<int> { static const ParameterTypeType Type = ptInt; };
+template <> struct ParameterTypeOf<unsigned int> { static const ParameterTypeType Type = ptUInt; };
+template <> struct ParameterTypeOf<long> { static const ParameterTypeType Type = ptLong; };
+template <> struct ParameterTypeOf<unsigned long> { static const ParameterTypeType Type = ptULong; };
+template <> struct ParameterTypeOf<float> { static const ParameterTypeType Type = ptFloat; };
+template <> struct ParameterTypeOf<double> { static const ParameterTypeType Type = ptDouble; };
+
+// a parameter of the type of its configValuesType field
+#define PARAMETER(id, name, field, min, max, units, changed) \
+	{ id, name, ParameterTypeOf<decltype(configValuesType::field)>::Type, offsetof(configValuesType, field), min, max, units, changed }
+
+// a parameter shown and set as text, stored in a field of the same size as the type
+#define PARAMETER_AS(id, name, field, type, changed) \
+	{ id, name, type, offsetof(configValuesType, field), 0, 0, "", changed }
+
+// in order of parameter number.
+static constexpr ParameterEntryType Parameters[] = {
+	PARAMETER(1, "Mag_Offset", CompassOffsetAngle, -360, 360, "deg", NULL),
+	PARAMETER(2, "TrimTabOffset", TrimTabOffset, 500, 2500, "us", NULL),
+	PARAMETER(3, "TrimTabScale", TrimTabScale, -100, 100, "us/deg", NULL),
+	PARAMETER(4, "TrimTab Default Angle", TrimTabDefaultAngle, -45, 45, "deg", NULL),
+	PARAMETER(5, "Sailable Angle Margin", SailableAngleMargin, 0, 90, "deg", NULL),
+	PARAMETER(6, "LoiterRadius", LoiterRadius, 1, 10000, "m", NULL),
+	PARAMETER(7, "timezone_offset", timezone_offset, 0, 14, "h", NULL),
+	PARAMETER(8, "LCDScreenView", DisplayScreenView, 0, 0, "", NULL),
+	PARAMETER(10, "UseGPSInitString", UseGPSInitString, 0, 1, "", NULL),
+	PARAMETER(11, "SaveStateValues", SaveStateValues, 0, 1, "", NULL),
+	PARAMETER(12, "MinimumAngleUpWind", MinimumAngleUpWind, 0, 90, "deg", NULL),
+	PARAMETER(13, "MinimumAngleDownWind", MinimumAngleDownWind, 0, 90, "deg", NULL),
+	PARAMETER(14, "WindAngleCalibrationOffset", WindAngleCalibrationOffset, -180, 180, "deg", NULL),
+	PARAMETER(15, "WPCourseHoldRadius", WPCourseHoldRadius, 0, 1000, "m", NULL),
+	PARAMETER_AS(16, "SDCardDelimiter", SDCardLogDelimiter, ptDelimiter, NULL),
+	PARAMETER(17, "RTHTimeManualControl", RTHTimeManualControl, 0, 86400, "s", NULL),
+	PARAMETER(18, "AWA to TWD_Offset Angle", TWD_Offset, -180, 180, "deg", NULL),
+	PARAMETER(19, "TargetHeadingFilterConstant", TargetHeadingFilterConstant, 0, 1, "", NULL),
+	PARAMETER(20, "MaxFileSize", MaxFileSize, 16, 1048576, "kb", NULL),
+	PARAMETER(21, "MagneticVariation", MagnetVariation, -180, 180, "deg", NULL),
+	PARAMETER(22, "LoRaPort", LoRaPort, 0, 4, "", NULL),
+	PARAMETER(23, "SatCommsPort", SatCommsPort, 0, 4, "", NULL),
+	PARAMETER(24, "LoRaPortBaudRate", LoRaPortBaudRate, 1200, 921600, "baud", NULL),
+	PARAMETER(25, "SatCommsPortBaudRate", SatCommsPortBaudRate, 1200, 921600, "baud", NULL),
+	PARAMETER(29, "Servo_Channel_Steering", Servo_Channel_Steering, 0, 15, "", NULL),
+	PARAMETER(30, "Servo_Channel_Steering_Stbd", Servo_Channel_Steering_Stbd, 0, 15, "", NULL),
+	PARAMETER(31, "SteeringDeadBand", SteeringDeadBand, 0, 100, "us", NULL),
+	PARAMETER(32, "Servo_Channel_Motor", Servo_Channel_Motor, 0, 15, "", NULL),
+	PARAMETER(33, "UseMotor", UseMotor, 0, 1, "", NULL),
+	PARAMETER(34, "DualRudder", DualRudder, 0, 1, "", NULL),
+	PARAMETER(35, "SteeringFilter", SteeringFilterConstant, 0, 1, "", SteeringPID_Init),
+	PARAMETER_AS(36, "pidDirection", pidDirection, ptDirection, SteeringPID_Init),
+	PARAMETER(37, "pidKp", pidKp, 0, 1000, "", SteeringPID_Init),
+	PARAMETER(38, "pidKi", pidKi, 0, 1000, "", SteeringPID_Init),
+	PARAMETER(39, "pidKd", pidKd, 0, 1000, "", SteeringPID_Init),
+	PARAMETER(40, "pidOutputmin", pidOutputmin, -1000, 1000, "us", SteeringPID_Init),
+	PARAMETER(41, "pidOutputmax", pidOutputmax, -1000, 1000, "us", SteeringPID_Init),
+	PARAMETER(42, "pidCentre", pidCentre, 500, 2500, "us", NULL),
+	PARAMETER(43, "WingAngleError000", WingAngleError000, -180, 180, "deg", NULL),
+	PARAMETER(44, "WingAngleError090", WingAngleError090, -180, 180, "deg", NULL),
+	PARAMETER(45, "WingAngleError180", WingAngleError180, -180, 180, "deg", NULL),
+	PARAMETER(46, "WingAngleError270", WingAngleError270, -180, 180, "deg", NULL),
+	PARAMETER(47, "WingAngle_mXScale", WingAngle_mXScale, 1, 32767, "", NULL),
+	PARAMETER(48, "WingAngle_mYScale", WingAngle_mYScale, 1, 32767, "", NULL),
+	PARAMETER(49, "CompassError000", CompassError000, -180, 180, "deg", NULL),
+	PARAMETER(50, "CompassError090", CompassError090, -180, 180, "deg", NULL),
+	PARAMETER(51, "CompassError180", CompassError180, -180, 180, "deg", NULL),
+	PARAMETER(52, "CompassError270", CompassError270, -180, 180, "deg", NULL),
+	PARAMETER(56, "SDCardLogBinary", SDCardLogBinary, 0, 1, "", NULL),
+	PARAMETER(57, "TelemetryBinary", TelemetryBinary, 0, 1, "", NULL),
+	PARAMETER(58, "CompassOversampling", CompassOversampling, 0, 1, "", IMU_Oversampling_Init),
+	PARAMETER(59, "CompassEllipsoid", CompassEllipsoid, 0, 1, "", IMU_Calibration_Init),
+};
+
+static const int ParameterTableSize = sizeof(Parameters) / sizeof(Parameters[0]);
+
+template <int N>
+constexpr bool ParameterTableSorted(const ParameterEntryType(&table)[N], int i = 1)
+{
+	return i >= N || (table[i - 1].Id < table[i].Id && ParameterTableSorted(table, i + 1));
+}
+static_assert(ParameterTableSorted(Parameters), "Parameters must be in order of parameter number, with no number repeated.");
+static_assert(sizeof(configValuesType::SDCardLogDelimiter) == sizeof(char) && sizeof(configValuesType::pidDirection) == sizeof(int),
+	"PARAMETER_AS fields must be the size of their type");
+
+int ParameterCount(void)
+{
+	return ParameterTableSize;
+}
+
+int ParameterMaxId(void)
+{
+	return Parameters[ParameterTableSize - 1].Id;
+}
+
+int ParameterIndex(int id)
+{
+	// the position of the parameter in the table, or -1 if there is no parameter with the number.
+	// V1.0 17/10/2026 John Semmens
+	int low = 0;
+	int high = ParameterTableSize - 1;
+
+	while (low <= high)
+	{
+		int mid = (low + high) / 2;
+		if (Parameters[mid].Id == id)
+		{
+			return mid;
+		}
+
+		if (Parameters[mid].Id < id)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+	return -1;
+}
+
+const ParameterEntryType& ParameterAt(int index)
+{
+	return Parameters[index];
+}
+
+static void* ParameterField(const ParameterEntryType& p)
+{
+	return (uint8_t*)&Configuration + p.Offset;
+}
+
+static double ParameterNumber(const ParameterEntryType& p)
+{
+	// the value of a numeric parameter.
+	void* field = ParameterField(p);
+
+	switch (p.Type)
+	{
+	case ptBool:		return *(bool*)field;
+	case ptByte:		return *(unsigned char*)field;
+	case ptShort:		return *(short*)field;
+	case ptInt:
+	case ptDirection:	return *(int*)field;
+	case ptUInt:		return *(unsigned int*)field;
+	case ptLong:		return *(long*)field;
+	case ptULong:		return *(unsigned long*)field;
+	case ptFloat:		return *(float*)field;
+	case ptDouble:		return *(double*)field;
+	default:			return 0;
+	}
+}
+
+void ParameterPrintValue(Print& out, const ParameterEntryType& p, bool compact)
+{
+	// print the value of the parameter. compact values are numbers or single characters, without commas, for the dump.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 placeholder for an unknown delimiter.
+	char value = *(char*)ParameterField(p);
+
+	switch (p.Type)
+	{
+	case ptBool:
+		if (compact)
+		{
+			out.print(value ? 1 : 0);
+		}
+		else
+		{
+			out.print(value ? "true" : "false");
+		}
+		break;
+
+	case ptChar:
+		out.print(value);
+		break;
+
+	case ptDelimiter:
+		if (value == '\t')
+		{
+			out.print(compact ? F("t") : F("Tab"));
+		}
+		else if (value == ',')
+		{
+			out.print(compact ? F("c") : F(","));
+		}
+		else
+		{
+			out.print(F("?")); // not a valid delimiter. Rejected if loaded back with prb.
+		}
+		break;
+
+	case ptDirection:
+		if (compact)
+		{
+			out.print((int)ParameterNumber(p));
+		}
+		else
+		{
+			out.print(ParameterNumber(p) == 0 ? F("Direct") : F("Reverse"));
+		}
+		break;
+
+	case ptFloat:
+	case ptDouble:
+	{
+		// up to 4 decimal places, without trailing zeros.
+		char FloatString[16];
+		dtostrf(ParameterNumber(p), 1, 4, FloatString);
+		char* end = FloatString + strlen(FloatString) - 1;
+		while (*end == '0')
+		{
+			*end-- = '\0';
+		}
+		if (*end == '.')
+		{
+			*end = '\0';
+		}
+		out.print(FloatString);
+		break;
+	}
+
+	case ptULong:
+	case ptUInt:
+		out.print((unsigned long)ParameterNumber(p));
+		break;
+
+	default:
+		out.print((long)ParameterNumber(p));
+	}
+}
+
+bool ParameterSet(const ParameterEntryType& p, const char* value)
+{
+	// set the parameter from the text value. Returns false, leaving the parameter unchanged, if the value is not valid.
+	// V1.0 17/10/2026 John Semmens
+	void* field = ParameterField(p);
+
+	switch (p.Type)
+	{
+	case ptChar:
+		if (*value == '\0')
+		{
+			return false;
+		}
+		*(char*)field = *value;
+		break;
+
+	case ptDelimiter:
+		if (*value == 't' || *value == 'T')
+		{
+			*(char*)field = '\t';
+		}
+		else if (*value == ',' || *value == 'c')
+		{
+			*(char*)field = ',';
+		}
+		else
+		{
+			return false;
+		}
+		break;
+
+	case ptDirection:
+		if (*value == 'd' || *value == 'D')
+		{
+			*(int*)field = 0;
+		}
+		else if (*value == 'r' || *value == 'R')
+		{
+			*(int*)field = 1;
+		}
+		else if (*value == '0' || *value == '1')
+		{
+			*(int*)field = (*value == '1');
+		}
+		else
+		{
+			return false;
+		}
+		break;
+
+	case ptBool:
+		*(bool*)field = (*value == 't' || *value == 'T' || *value == 'y' || *value == 'Y' || atoi(value) != 0);
+		break;
+
+	default:
+	{
+		double number = atof(value);
+		if (number < p.Min || number > p.Max)
+		{
+			return false;
+		}
+
+		long whole = lround(number);
+		switch (p.Type)
+		{
+		case ptByte:	*(unsigned char*)field = whole; break;
+		case ptShort:	*(short*)field = whole; break;
+		case ptInt:		*(int*)field = whole; break;
+		case ptUInt:	*(unsigned int*)field = whole; break;
+		case ptLong:	*(long*)field = whole; break;
+		case ptULong:	*(unsigned long*)field = whole; break;
+		case ptFloat:	*(float*)field = number; break;
+		case ptDouble:	*(double*)field = number; break;
+		default:;
+		}
+	}
+	}
+
+	if (p.Changed)
+	{
+		p.Changed();
+	}
+	return true;
+}
+
+int ParameterDumpMessages(void)
+{
+	return (ParameterTableSize + ParameterDumpSize - 1) / ParameterDumpSize;
+}
+
+void ParameterDump(Print& out, int message)
+{
+	// send one message of the parameter dump: prd,<first parameter number>,<value>,<value>...
+	// V1.0 17/10/2026 John Semmens
+	int first = message * ParameterDumpSize;
+	if (first < 0 || first >= ParameterTableSize)
+	{
+		return;
+	}
+
+	out.print(F("prd,"));
+	out.print(Parameters[first].Id);
+	for (int i = first; i < first + ParameterDumpSize && i < ParameterTableSize; i++)
+	{
+		out.print(",");
+		ParameterPrintValue(out, Parameters[i], true);
+	}
+	out.println();
+}
@@ -0,0 +1,56 @@
+// ParameterRegistry.h
+
+// Table of the configuration parameters that can be read and set from the CLI.
+// Each entry gives the parameter number, name, type, position in configValuesType, range and units,
+// so that the get, set, list and bulk dump/load commands all work from the one table.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _PARAMETERREGISTRY_h
+#define _PARAMETERREGISTRY_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+enum ParameterTypeType : byte {
+	ptBool,
+	ptChar,
+	ptByte,
+	ptShort,
+	ptInt,
+	ptUInt,
+	ptLong,
+	ptULong,
+	ptFloat,
+	ptDouble,
+	ptDelimiter,	// char. Tab or comma, shown as Tab/, or in the dump as t/c
+	ptDirection		// int. PID direction, shown as Direct/Reverse or in the dump as 0/1
+};
+
+struct ParameterEntryType {
+	byte Id;					// parameter number used by prg, prs and prl
+	const char* Name;
+	ParameterTypeType Type;
+	uint16_t Offset;			// offsetof(configValuesType, field)
+	float Min;					// range of numeric values accepted by ParameterSet
+	float Max;
+	const char* Units;
+	void(*Changed)(void);		// called after the value is set, or NULL.
+};
+
+static const int ParameterDumpSize = 6;	// values per prd/prb message. Fits the 58 byte LoRa packet, and the 7 CLI parameters.
+
+int ParameterCount(void);
+int ParameterMaxId(void);
+int ParameterIndex(int id);
+const ParameterEntryType& ParameterAt(int index);
+
+void ParameterPrintValue(Print& out, const ParameterEntryType& p, bool compact);
+bool ParameterSet(const ParameterEntryType& p, const char* value);
+
+int ParameterDumpMessages(void);
+void ParameterDump(Print& out, int message);
+
+#endif
@@ -7,6 +7,8 @@
 // V1.3 11/2/2019 addded decision logging for tacks and tack choices.
 // V1.4 12/2/2019 fix logic reversal in tacking decisions.
 // V1.5 3/1/2021 added in downwind tacking functionality.
+// V1.6 17/10/2026 mission step timing uses VirtualMillis, to support faster than real time simulation.
+// V1.7 17/10/2026 added SailingNavigation_Reset, for the tack and in-irons state and the target heading filter.
 
 #include "SailingNavigation.h"
 #include "Navigation.h"
@@ -18,6 +20,7 @@
 #include "location.h"
 #include "HAL_SDCard.h"
 #include "HAL_Servo.h"
+#include "HAL_Time.h"
 
 extern NavigationDataType NavData;
 extern StateValuesStruct StateValues;
@@ -37,6 +40,22 @@ void SailingNavigation_Init(void)
 	TargetHeadingFilter.FilterConstant = Configuration.TargetHeadingFilterConstant;
 }
 
+void SailingNavigation_Reset(void)
+{
+	// restart the sailing decisions, as if the vessel had just been switched on: no tack established,
+	// no tack or in-irons timing, and the target heading filter starting from the current heading.
+	// Called by Navigation_Reset.
+	// V1.0 17/10/2026 John Semmens
+	TargetHeadingFilter.Init(NavData.HDG);
+
+	NavData.CourseType = ctNotEstablished;
+	NavData.TackDuration = 0;
+	NavData.TimePastFavouredTack = 0;
+	NavData.ManoeuvreState = ManoeuvreStateType::mstNone;
+	NavData.InIronsState = iistNo;
+	NavData.PastBoundaryHold = false;
+}
+
 void UpdateCourseToSteer(void)
 {	// called in the slow loop -- about 5 seconds
 	// Set a sailing course to steer to get to the waypoint, making appropriate tacking decisions
@@ -178,7 +197,7 @@ int CalculateSailingCTS(void)
 			  // OR  if we have just incremented a mission step (in the last 8 seconds) then we need to re-assess and choose favoured tack
 			  //		we would get here within about 5 seconds, if it wasn't sailable, hence allow a bit more, i.e. 8 seconds.
 			if ((NavData.CourseType == SteeringCourseType::ctDirectToWayPoint) ||
-				((millis() - MissionValues.MissionCommandStartTime) < 8000))
+				((VirtualMillis() - MissionValues.MissionCommandStartTime) < 8000))
 			{
 				// given we were previously sailing direct to WP and now can't, then set the Tack to the Favoured tack
 				// (Note: NavData.CourseType is set within the SetTack function)
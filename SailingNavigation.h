@@ -16,6 +16,7 @@
 #include "DisplayStrings.h"
 
 void SailingNavigation_Init(void);
+void SailingNavigation_Reset(void);
 void UpdateCourseToSteer(void);
 
 void UpdateTargetHeading(void);
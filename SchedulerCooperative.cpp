@@ -1,39 +1,313 @@
 // This scheduler allows for tasks to be called at regular intervals.
 // It does not use interupts, in order to maintain compatibility with libraries that do, such as the wire library.
 // These functions rely on the millis() function, which provides the number of ms since the arduino was started.
-// This rolls over after about 50 days, but this should have no affect on this scheduler.
+// This rolls over after about 50 days. All time comparisons are made on the difference between two times,
+// so the rollover has no affect on this scheduler.
 // V1.0 31/7/2016 John Semmens
+// V2.0 17/10/2026 Replaced per-call SchedulerTick() with a registered task table and SchedulerRun().
+//					The next deadline is advanced by the interval rather than set from the current time, so tasks no longer drift.
+//					Only one task is run per call, chosen by priority then earliest deadline, so a slow task can't starve a fast one.
+//					Missed deadlines and worst case lateness are recorded per task.
+// V2.1 17/10/2026 Added per-task execution time profiling: min, mean, max, log2 histogram and overrun count.
+// V2.2 17/10/2026 Added SchedulerIdle(). When nothing is due, the processor is halted with WFI until the next interrupt.
+//					The SysTick interrupt (1 ms) keeps millis() running and wakes it, and serial receive interrupts wake it early.
+//					The percentage of time spent idle is measured over a 10 second window.
+// V2.3 17/10/2026 Added simulated tasks. Their interval is divided by the simulation speed, so the navigation and the simulated
+//					vessel run faster than real time, while the steering, sensors, radio, logging and SD card tasks keep their real intervals.
+// V2.4 17/10/2026 Overruns are counted against each task's own interval. A slow task is no longer counted as overrunning
+//					every time it takes longer than the 10 ms interval of the fastest task.
+// V2.5 17/10/2026 SchedulerIdle() moves the virtual clock of the host build (sil/) on to the next deadline, in place of WFI.
 
 #include "SchedulerCooperative.h"
 
-// nominate a maximum number of tasks to be supported.
-static const long MaxNumberOfTasks = 11; // max index +1
+// table of registered tasks.
+SchedulerTaskType TaskList[MaxNumberOfTasks];
 
+// earliest deadline of all of the registered tasks.
+// This allows SchedulerRun() to return after a single comparison when there is nothing due.
+static unsigned long NextDeadline;
 
-// array holding the times in ms for the next running of each task.
-unsigned long TaskList[MaxNumberOfTasks];
+// clock used by the scheduler. Normally millis(), but can be replaced to drive the scheduler from a simulated clock in a test.
+// Faster than real time simulation doesn't change the clock, see SchedulerSetSpeed.
+static unsigned long(*SchedulerClock)(void) = millis;
 
-// The SchedulerTick function should be called regularly to see if it is time to run each task.
-// This should be called in the LOOP for each Task to be run.
-void SchedulerTick(int TaskIndex, void(*action)(void*), unsigned long interval_ms) {
-	// TaskIndex: index to Task/function being processed.
-	// action: task/function name to be run if its time to run.
-	// interval_ms: task running interval in milliseconds. e.g 1000 ms is the interval of one second.
+// simulation speed, applied to the simulated tasks.
+static int SchedulerSpeed = 1;
+
+// idle mode
+static bool IdleEnabled = true;
+static unsigned long IdleTime_us;			// time spent halted in the current measurement window.
+static unsigned long IdleWindowStart_us;	// start of the current measurement window.
+static byte IdlePercent;					// percentage of time spent halted in the last complete window.
+static const unsigned long IdleWindow_us = 10000000UL; // 10 seconds
+
+// return true if time a is at or after time b, allowing for the rollover of millis().
+static inline bool TimeReached(unsigned long a, unsigned long b)
+{
+	return (long)(a - b) >= 0;
+}
+
+static void RecordRunTime(SchedulerTaskType& task, unsigned long run_us)
+{
+	// update the execution time profile of a task.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 an overrun is a run longer than the task's own interval, rather than the shortest interval of all the tasks.
+	if (task.RunCount == 1 || run_us < task.MinRun_us)
+		task.MinRun_us = run_us;
+	if (run_us > task.MaxRun_us)
+		task.MaxRun_us = run_us;
+	task.TotalRun_us += run_us;
 
-	// example: SchedulerTick(0,&loop_1s,1000);
+	if (run_us > task.interval_ms * 1000UL)
+		task.Overruns++;
 
-	unsigned long currentTime = millis();
+	// log2 bucket: the position of the highest set bit.
+	int bucket = 0;
+	while ((run_us >>= 1) && (bucket < SchedulerHistogramBuckets - 1))
+		bucket++;
+	task.Histogram[bucket]++;
+}
+
+static void UpdateNextDeadline(unsigned long currentTime)
+{
+	// find the earliest deadline across all registered tasks.
+	// V1.0 17/10/2026 John Semmens
+	bool found = false;
+	NextDeadline = currentTime;
 
-	if (currentTime > TaskList[TaskIndex])
+	for (int i = 0; i < MaxNumberOfTasks; i++)
 	{
-		TaskList[TaskIndex] = currentTime + interval_ms;
-		action(NULL);
+		if (TaskList[i].action == NULL)
+			continue;
+
+		if (!found || !TimeReached(TaskList[i].next_run_ms, NextDeadline))
+		{
+			NextDeadline = TaskList[i].next_run_ms;
+			found = true;
+		}
 	}
 }
 
-
-// Initialise the Task time array to zero. 
-// This should called once in the SETUP
+// Initialise the Task table to empty. 
+// This should called once in the SETUP, before the tasks are added.
 void SchedulerInit(void) {
 	memset(TaskList, 0, sizeof(TaskList));
-}
\ No newline at end of file
+	NextDeadline = SchedulerClock();
+}
+
+// Register a task to be run at a regular interval.
+// This should be called once in the SETUP for each Task to be run.
+// The first running of each task is due immediately.
+void SchedulerAddTask(int TaskIndex, void(*action)(void*), unsigned long interval_ms, byte priority, const char* name) {
+	// TaskIndex: index to Task/function being registered.
+	// action: task/function name to be run when its time to run.
+	// interval_ms: task running interval in milliseconds. e.g 1000 ms is the interval of one second.
+	// priority: 0 is the highest priority.
+	// name: short name used when reporting the task profile.
+
+	// example: SchedulerAddTask(0,&loop_1s,1000,2,"1s");
+	// V1.0 17/10/2026 John Semmens
+
+	if (TaskIndex < 0 || TaskIndex >= MaxNumberOfTasks)
+		return;
+
+	unsigned long currentTime = SchedulerClock();
+
+	TaskList[TaskIndex].action = action;
+	TaskList[TaskIndex].interval_ms = interval_ms;
+	TaskList[TaskIndex].next_run_ms = currentTime;
+	TaskList[TaskIndex].priority = priority;
+	TaskList[TaskIndex].Simulated = false;
+	TaskList[TaskIndex].BaseInterval_ms = interval_ms;
+	TaskList[TaskIndex].RunCount = 0;
+	TaskList[TaskIndex].MissedDeadlines = 0;
+	TaskList[TaskIndex].MaxLateness_ms = 0;
+	TaskList[TaskIndex].Name = name;
+
+	UpdateNextDeadline(currentTime);
+}
+
+// The SchedulerRun function should be called from the LOOP as often as possible.
+// It runs at most one task per call; the highest priority task that is due, with ties going to the earliest deadline.
+// Returns true if a task was run.
+bool SchedulerRun(void) {
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 added idle time measurement window.
+	unsigned long currentTime = SchedulerClock();
+
+	unsigned long window_us = micros() - IdleWindowStart_us;
+	if (window_us >= IdleWindow_us)
+	{
+		IdlePercent = (byte)((unsigned long long)IdleTime_us * 100 / window_us);
+		IdleTime_us = 0;
+		IdleWindowStart_us += window_us;
+	}
+
+	if (!TimeReached(currentTime, NextDeadline))
+		return false;
+
+	int selected = -1;
+	for (int i = 0; i < MaxNumberOfTasks; i++)
+	{
+		if (TaskList[i].action == NULL || !TimeReached(currentTime, TaskList[i].next_run_ms))
+			continue;
+
+		if (selected < 0
+			|| TaskList[i].priority < TaskList[selected].priority
+			|| (TaskList[i].priority == TaskList[selected].priority
+				&& !TimeReached(TaskList[i].next_run_ms, TaskList[selected].next_run_ms)))
+		{
+			selected = i;
+		}
+	}
+
+	if (selected < 0)
+	{
+		UpdateNextDeadline(currentTime);
+		return false;
+	}
+
+	SchedulerTaskType& task = TaskList[selected];
+
+	unsigned long lateness = currentTime - task.next_run_ms;
+	if (lateness > task.MaxLateness_ms)
+		task.MaxLateness_ms = lateness;
+
+	// advance the deadline by whole intervals to keep the task's phase.
+	// If one or more complete intervals have already passed, skip them rather than running the task back to back.
+	task.next_run_ms += task.interval_ms;
+	if (task.interval_ms > 0 && TimeReached(currentTime, task.next_run_ms))
+	{
+		unsigned long skipped = (currentTime - task.next_run_ms) / task.interval_ms + 1;
+		task.next_run_ms += skipped * task.interval_ms;
+		task.MissedDeadlines += skipped;
+	}
+	task.RunCount++;
+
+	UpdateNextDeadline(currentTime);
+
+	unsigned long start_us = micros();
+	task.action(NULL);
+	RecordRunTime(task, micros() - start_us);
+
+	return true;
+}
+
+// return the earliest deadline of the registered tasks, in ms.
+unsigned long SchedulerNextDeadline(void) {
+	return NextDeadline;
+}
+
+// replace the clock used by the scheduler. Passing NULL restores millis().
+// This allows the task timing to be exercised against a simulated clock.
+void SchedulerSetClock(unsigned long(*clock)(void)) {
+	SchedulerClock = (clock == NULL) ? millis : clock;
+}
+
+// mark a task as a navigation or simulation task, whose interval follows the simulation speed.
+// Call after SchedulerAddTask. The task runs at the current speed straight away.
+void SchedulerSetSimulated(int TaskIndex) {
+	// V1.0 17/10/2026 John Semmens
+	if (TaskIndex < 0 || TaskIndex >= MaxNumberOfTasks || TaskList[TaskIndex].action == NULL)
+		return;
+
+	TaskList[TaskIndex].Simulated = true;
+	SchedulerSetSpeed(SchedulerSpeed);
+}
+
+// set the simulation speed. The interval of each simulated task becomes its interval at the normal speed divided by
+// the speed. A task not due for longer than its new interval is brought forward, so a speed up takes effect at once.
+void SchedulerSetSpeed(int speed) {
+	// V1.0 17/10/2026 John Semmens
+	if (speed < 1)
+		speed = 1;
+	SchedulerSpeed = speed;
+
+	unsigned long currentTime = SchedulerClock();
+	for (int i = 0; i < MaxNumberOfTasks; i++)
+	{
+		SchedulerTaskType& task = TaskList[i];
+		if (task.action == NULL || !task.Simulated)
+			continue;
+
+		task.interval_ms = max(task.BaseInterval_ms / speed, 1UL);
+		if (!TimeReached(currentTime + task.interval_ms, task.next_run_ms))
+			task.next_run_ms = currentTime + task.interval_ms;
+	}
+	UpdateNextDeadline(currentTime);
+}
+
+// return the task at the given index, or NULL if the index is out of range.
+const SchedulerTaskType* SchedulerGetTask(int TaskIndex) {
+	if (TaskIndex < 0 || TaskIndex >= MaxNumberOfTasks)
+		return NULL;
+
+	return &TaskList[TaskIndex];
+}
+
+// return the number of task slots in use, i.e. the highest registered task index + 1.
+int SchedulerTaskCount(void) {
+	int count = 0;
+	for (int i = 0; i < MaxNumberOfTasks; i++)
+	{
+		if (TaskList[i].action != NULL)
+			count = i + 1;
+	}
+	return count;
+}
+
+// return the mean run time of a task in microseconds.
+unsigned long SchedulerMeanRun_us(const SchedulerTaskType* task) {
+	if (task == NULL || task->RunCount == 0)
+		return 0;
+
+	return (unsigned long)(task->TotalRun_us / task->RunCount);
+}
+
+// clear the execution time profile and deadline statistics of all tasks, without changing their schedule.
+void SchedulerResetProfile(void) {
+	for (int i = 0; i < MaxNumberOfTasks; i++)
+	{
+		TaskList[i].RunCount = 0;
+		TaskList[i].MissedDeadlines = 0;
+		TaskList[i].MaxLateness_ms = 0;
+		TaskList[i].MinRun_us = 0;
+		TaskList[i].MaxRun_us = 0;
+		TaskList[i].TotalRun_us = 0;
+		TaskList[i].Overruns = 0;
+		memset(TaskList[i].Histogram, 0, sizeof(TaskList[i].Histogram));
+	}
+}
+
+// Called from the LOOP when SchedulerRun() finds nothing to do.
+// Halt the processor until the next interrupt, unless a task is already due.
+// The 1 ms SysTick interrupt ensures this returns at least once a millisecond, so deadlines are still met.
+// Serial, GPS and Bluetooth receive interrupts also wake the processor early.
+void SchedulerIdle(void) {
+	// V1.0 17/10/2026 John Semmens
+	if (!IdleEnabled || TimeReached(SchedulerClock(), NextDeadline))
+		return;
+
+	unsigned long start_us = micros();
+#if defined(__arm__)
+	asm volatile("wfi");
+#elif defined(SIL)
+	// host build, see sil/. Nothing interrupts the host, so the virtual clock is moved on to the next deadline.
+	SilIdleUntil(NextDeadline);
+#endif
+	IdleTime_us += micros() - start_us;
+}
+
+// enable or disable the idle mode. When disabled, the LOOP spins between tasks as it did previously.
+void SchedulerSetIdle(bool enabled) {
+	IdleEnabled = enabled;
+}
+
+bool SchedulerIdleEnabled(void) {
+	return IdleEnabled;
+}
+
+// return the percentage of time spent halted in SchedulerIdle() over the last 10 seconds.
+byte SchedulerIdlePercent(void) {
+	return IdlePercent;
+}
@@ -3,6 +3,15 @@
 // This scheduler allows for tasks to be called at regular intervals.
 // It does not use interupts, in order to maintain compatibility with libraries that do, such as the wire library.
 // V1.0 31/7/2016 John Semmens
+// V2.0 17/10/2026 Tasks are registered once in setup and then dispatched by SchedulerRun().
+//					Each task keeps its phase (next += interval), and due tasks are run in priority then deadline order.
+// V2.1 17/10/2026 Added per-task execution time profiling.
+// V2.2 17/10/2026 Added idle mode. The processor waits for an interrupt between tasks rather than spinning.
+// V2.3 17/10/2026 MaxNumberOfTasks increased to 12 for the SD log writer task.
+// V2.4 17/10/2026 MaxNumberOfTasks increased to 13 for the CLI task.
+// V2.5 17/10/2026 MaxNumberOfTasks increased to 14 for the I2C task.
+// V2.6 17/10/2026 Simulated tasks, whose interval is divided by the simulation speed. MaxNumberOfTasks increased to 15 for the Sim task.
+// V2.7 17/10/2026 Overruns counted against each task's own interval.
 
 #ifndef _SCHEDULERCOOPERATIVE_h
 #define _SCHEDULERCOOPERATIVE_h
@@ -13,9 +22,52 @@
 	#include "WProgram.h"
 #endif
 
-void SchedulerTick(int TaskIndex, void(*action)(void*), unsigned long delayMs);
+// nominate a maximum number of tasks to be supported.
+static const int MaxNumberOfTasks = 15; // max index +1
+
+// number of log2 buckets in the run time histogram.
+// bucket n counts runs of 2^n to 2^(n+1)-1 microseconds. The last bucket also counts everything longer.
+static const int SchedulerHistogramBuckets = 16;
+
+struct SchedulerTaskType {
+	void(*action)(void*);			// task/function to be run. NULL means the slot is unused.
+	unsigned long interval_ms;		// task running interval in milliseconds.
+	unsigned long next_run_ms;		// deadline; the time in ms for the next running of the task.
+	byte priority;					// 0 is the highest priority. Used to choose between tasks that are due at the same time.
+	bool Simulated;					// navigation or simulation task. interval_ms is BaseInterval_ms divided by the simulation speed.
+	unsigned long BaseInterval_ms;	// interval at the normal speed of 1.
+
+	unsigned long RunCount;			// number of times the task has been run.
+	unsigned long MissedDeadlines;	// number of whole intervals skipped because the task could not be started in time.
+	unsigned long MaxLateness_ms;	// worst case delay between the deadline and the start of the task.
+
+	// execution time profile, in microseconds.
+	const char* Name;				// short name for display and logging.
+	unsigned long MinRun_us;
+	unsigned long MaxRun_us;
+	unsigned long long TotalRun_us;	// used to calculate the mean.
+	unsigned long Overruns;			// number of runs longer than the task's own interval, i.e. the task can't keep up with itself.
+	unsigned long Histogram[SchedulerHistogramBuckets];
+};
 
 void SchedulerInit(void);
+void SchedulerAddTask(int TaskIndex, void(*action)(void*), unsigned long interval_ms, byte priority, const char* name);
+bool SchedulerRun(void);
+
+const SchedulerTaskType* SchedulerGetTask(int TaskIndex);
+int SchedulerTaskCount(void);
+unsigned long SchedulerMeanRun_us(const SchedulerTaskType* task);
+void SchedulerResetProfile(void);
+
+unsigned long SchedulerNextDeadline(void);
+void SchedulerSetClock(unsigned long(*clock)(void));
+void SchedulerSetSimulated(int TaskIndex);
+void SchedulerSetSpeed(int speed);
+
+void SchedulerIdle(void);
+void SchedulerSetIdle(bool enabled);
+bool SchedulerIdleEnabled(void);
+byte SchedulerIdlePercent(void);
 
 #endif
 
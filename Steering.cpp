@@ -5,6 +5,7 @@
 
 // V1.0 13/11/2016 
 // V1.1 25/4/2018 updated 
+// V1.2 17/10/2026 added SteeringPID_Reset
 
 #include "Steering.h"
 #include "CommandState_Processor.h"
@@ -114,3 +115,17 @@ void SteeringPID_Init(void)
 	SteeringFilter.FilterConstant = Configuration.SteeringFilterConstant;
 }
 
+void SteeringPID_Reset(void)
+{
+	// restart the Steering PID and filter with the rudder centred, clearing the integral term.
+	// V1.0 17/10/2026 John Semmens
+	pidServoOutput = 0;
+	pidActualHdgError = 0;
+	SteeringPID.SetMode(MANUAL);
+	SteeringPID.SetMode(AUTOMATIC); // initialises the PID from the centred output
+
+	SteeringServoOutput = Configuration.pidCentre;
+	SteeringFilter.Init(Configuration.pidCentre);
+	SteeringServoOutput_LPF = Configuration.pidCentre;
+}
+
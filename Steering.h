@@ -12,6 +12,7 @@
 
 void SteeringFastUpdate(void);
 void SteeringPID_Init(void);
+void SteeringPID_Reset(void);
 void ComputeSteeringOutput(void);
 
 #endif
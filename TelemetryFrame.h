@@ -0,0 +1,133 @@
+// TelemetryFrame.h
+
+// Binary telemetry frame, used when Configuration.TelemetryBinary is set.
+// Several status messages are packed into one frame, to fit in one LoRa packet.
+// This header only uses stdint, so the base station decoder can use it unchanged.
+//
+// Frame:  Sync1 Sync2 Length Sequence { Id Payload } ... CRC_Hi CRC_Lo
+//		Length is the number of bytes from Sequence to the end of the last payload.
+//		The CRC is CRC-16/CCITT (0x1021, initial 0xFFFF) of Length to the end of the last payload.
+//		Multi-byte fields are little endian, as the Teensy stores them.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _TELEMETRYFRAME_h
+#define _TELEMETRYFRAME_h
+
+#include <stdint.h>
+
+static const uint8_t TelemetryFrameSync1 = 0xAA;
+static const uint8_t TelemetryFrameSync2 = 0x55;
+static const int TelemetryFrameMaxSize = 58;		// E32 transparent mode packet size
+static const int TelemetryFrameOverhead = 6;		// sync, length, sequence and CRC
+
+// message ids in the frame. These don't change when TelMessageType is reordered.
+enum TelemetryFrameIdType {
+	tfLNA = 1,
+	tfLAT = 2,
+	tfLPO = 3,
+	tfLWI = 4
+};
+
+struct __attribute__((packed)) TelemetryFrameLNA {
+	int16_t CTE;			// m
+	int32_t DTW;			// m
+	int16_t BTW;			// degrees
+	uint8_t Sailable;
+	int32_t Lat;			// degrees * 10^7
+	int32_t Lon;
+	int16_t COG;			// degrees
+	uint16_t SOG_cmps;		// cm/s
+	int16_t HDG;			// degrees
+};
+
+struct __attribute__((packed)) TelemetryFrameLAT {
+	int16_t HDG;			// degrees
+	int8_t Pitch;			// degrees
+	int8_t Roll;			// degrees
+	int8_t ROLL_Avg;		// degrees
+	int16_t VMG_cmps;		// cm/s
+};
+
+struct __attribute__((packed)) TelemetryFrameLPO {
+	uint16_t Solar_mV;
+	int16_t Solar_mA;
+	uint16_t BatteryIn_mV;
+	int16_t BatteryIn_mA;
+	uint16_t BatteryOut_mV;
+	int16_t BatteryOut_mA;
+};
+
+struct __attribute__((packed)) TelemetryFrameLWI {
+	int16_t AWA;			// degrees
+	int16_t TWD;			// degrees
+	uint16_t TWS_cmps;		// cm/s
+	int16_t WingAngle;		// degrees
+	int16_t TrimTabAngle;	// degrees
+};
+
+inline int TelemetryFramePayloadSize(uint8_t id)
+{
+	// payload bytes for the message id, or 0 if unknown.
+	switch (id)
+	{
+	case tfLNA: return sizeof(TelemetryFrameLNA);
+	case tfLAT: return sizeof(TelemetryFrameLAT);
+	case tfLPO: return sizeof(TelemetryFrameLPO);
+	case tfLWI: return sizeof(TelemetryFrameLWI);
+	default: return 0;
+	}
+}
+
+inline uint16_t TelemetryFrameCRC16(const uint8_t* data, int length)
+{
+	uint16_t crc = 0xFFFF;
+	for (int i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for (int b = 0; b < 8; b++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+inline bool TelemetryFrameDecode(const uint8_t* frame, int length,
+	void(*handler)(uint8_t id, const uint8_t* payload, void* context), void* context)
+{
+	// check a received frame, and pass each message in it to the handler.
+	// Returns false if the frame is incomplete, fails the CRC, or holds an unknown message id.
+	if (length < TelemetryFrameOverhead || frame[0] != TelemetryFrameSync1 || frame[1] != TelemetryFrameSync2)
+	{
+		return false;
+	}
+
+	int content = frame[2];
+	if (length < content + TelemetryFrameOverhead - 1)
+	{
+		return false;
+	}
+
+	uint16_t crc = ((uint16_t)frame[content + 3] << 8) | frame[content + 4];
+	if (crc != TelemetryFrameCRC16(&frame[2], content + 1))
+	{
+		return false;
+	}
+
+	// the messages follow the sequence number.
+	int i = 4;
+	while (i < content + 3)
+	{
+		uint8_t id = frame[i++];
+		int size = TelemetryFramePayloadSize(id);
+		if (size == 0 || i + size > content + 3)
+		{
+			return false;
+		}
+		handler(id, &frame[i], context);
+		i += size;
+	}
+	return true;
+}
+
+#endif
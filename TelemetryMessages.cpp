@@ -1,6 +1,17 @@
 // 
 // 
 // V1.01 4/8/2021 updated to support full addressing
+// V1.02 17/10/2026 added TPL, task execution time profile list
+// V1.03 17/10/2026 added IDL, scheduler idle mode and current comparison
+// V1.04 17/10/2026 added MCR, simulated mission batch results list
+// V1.05 17/10/2026 parameter list extended to 56, SDCardLogBinary
+// V1.06 17/10/2026 message queue: priority with ageing, per message rate limit, list messages interleaved,
+//					and messages spaced by an airtime budget from the LoRa air data rate instead of a fixed 2 seconds.
+// V1.07 17/10/2026 optional binary frames (TelemetryBinary). LNA, LAT, LPO and LWI that are waiting are sent together in one frame.
+// V1.08 17/10/2026 PRL and PRM from the parameter registry, and PRD, the parameter dump.
+// V1.09 17/10/2026 the message is sent to the LoRa module before it is put back into low power receive.
+// V1.10 17/10/2026 the LoRa module is put back into low power receive from a later telemetry loop call, once the message
+//					has been sent, rather than waiting for the transmit buffer to drain.
 
 #include "TelemetryMessages.h"
 #include "HAL.h"
@@ -19,8 +30,12 @@
 #include "LoRaManagement.h"
 #include "HAL_Time.h"
 #include "TimeLib.h"
+#include "SchedulerCooperative.h"
+#include "sim_batch.h"
+#include "TelemetryFrame.h"
+#include "ParameterRegistry.h"
 
-extern HardwareSerial* Serials[];
+extern Stream* Serials[];
 extern NavigationDataType NavData;
 extern HALIMU imu;
 
@@ -36,13 +51,14 @@ extern char VersionDate[];
 extern bool SD_Card_Present; // Flag for SD Card Presence
 extern configValuesType Configuration;
 extern HALWingAngle WingAngleSensor;
+extern sim_batch simulated_batch;
 
 extern byte MessageArray[EndMarker + 1];
 extern bool MessageToSend;
 extern int LastParameterIndex;
 extern uint32_t LastMessageSendTime;
 
-static const int MaxParameterIndex = 55;
+static const int SimBatchResultCount = 6; // number of result lines in the MCR list
 
 void SendMessage(int CommandPort, TelMessageType msg)
 {
@@ -360,7 +376,25 @@ void SendMessage(int CommandPort, TelMessageType msg)
 
 	case TelMessageType::PRM:
 		(*Serials[CommandPort]).print(F("prm,"));
-		(*Serials[CommandPort]).print(MaxParameterIndex);
+		(*Serials[CommandPort]).print(ParameterMaxId());
+		(*Serials[CommandPort]).println();
+		MessageArray[msg] = 0;
+		break;
+
+	case TelMessageType::IDL:
+		// idl,idle mode,idle %,mean mA idle on,samples,mean mA idle off,samples
+		(*Serials[CommandPort]).print(F("idl,"));
+		(*Serials[CommandPort]).print(SchedulerIdleEnabled() ? 1 : 0);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(SchedulerIdlePercent());
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(PowerSensor.IdleCurrent_mA(true));
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(PowerSensor.IdleOn_Count);
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(PowerSensor.IdleCurrent_mA(false));
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(PowerSensor.IdleOff_Count);
 		(*Serials[CommandPort]).println();
 		MessageArray[msg] = 0;
 		break;
@@ -372,7 +406,22 @@ void SendMessage(int CommandPort, TelMessageType msg)
 		break;
 
 	case TelMessageType::PRL: // parameter list
-		ListParameter(CommandPort, MaxParameterIndex - MessageArray[msg] + 1);
+		ListParameter(CommandPort, ParameterAt(ParameterCount() - MessageArray[msg]).Id);
+		MessageArray[msg]--;
+		break;
+
+	case TelMessageType::PRD: // parameter dump
+		ParameterDump(*Serials[CommandPort], ParameterDumpMessages() - MessageArray[msg]);
+		MessageArray[msg]--;
+		break;
+
+	case TelMessageType::TPL: // task profile list
+		SendTaskProfile(CommandPort, SchedulerTaskCount() - MessageArray[msg]);
+		MessageArray[msg]--;
+		break;
+
+	case TelMessageType::MCR: // simulated batch results list
+		SendSimBatchResult(CommandPort, SimBatchResultCount - MessageArray[msg]);
 		MessageArray[msg]--;
 		break;
 
@@ -380,53 +429,286 @@ void SendMessage(int CommandPort, TelMessageType msg)
 	}
 }
 
-void ProcessQueue(int SerialPortNumber)
+// Message scheduling.
+// Each waiting message has a priority from its place in TelMessageType, less the time it has waited,
+// so a message that has waited long enough is sent ahead of those queued after it.
+// List messages are sent one item at a time, behind the other messages. After each item the list goes to the back,
+// so that a long list is interleaved with status messages rather than holding them up.
+static const long TelemetryAgeingStep_ms = 1000;		// waiting this long is worth one place in the priority order.
+static const int TelemetryListPriorityOffset = 10;		// places that list messages are moved down the priority order.
+static const byte TelemetryAirtimeBudgetPercent = 50;	// the most of the time that the radio is transmitting.
+
+static uint32_t MessageQueuedTime[EndMarker + 1];	// millis when the message was queued, or when the last list item was sent.
+static uint32_t MessageSentTime[EndMarker + 1];		// millis when the message was last sent.
+static uint32_t NextSendGap_ms;						// time to wait after the last message, to keep within the airtime budget.
+static bool ReceivePending;							// the module is still in transmit mode, after the last message.
+static int ReceiveWhenFree;							// transmit buffer space when the last message has left the buffer.
+
+static bool IsListMessage(int msg)
 {
-	// called from the telemetry loop // 1 second
-	// find the first non-zero flag in the message array, send the corresponding message, and clear the flag
-	
-	const uint32_t SendGapTime = 2000; // ms
+	return (msg == PRL) || (msg == MCP) || (msg == TPL) || (msg == MCR) || (msg == PRD);
+}
 
-	int msg = 0;
-	while ((MessageArray[msg] == 0) && (msg < EndMarker))
+static uint32_t MessageMinInterval_ms(int msg)
+{
+	// the shortest time between two of the same message. The status messages can't usefully be sent faster than this.
+	switch (msg)
 	{
-		msg++;
-	};
+	case TelMessageType::LNA:
+	case TelMessageType::LAT:
+	case TelMessageType::LPO:
+	case TelMessageType::LWS:
+		return 2000;
 
-	if ((msg < EndMarker) && ((LastMessageSendTime + SendGapTime) < millis()) ) // don't enter if we are still within the gap time of the last send
+	default:
+		return 0;
+	}
+}
+
+static long MessagePriority_ms(int msg, uint32_t now_ms)
+{
+	// lower is sent first.
+	int place = IsListMessage(msg) ? msg + TelemetryListPriorityOffset : msg;
+	return place * TelemetryAgeingStep_ms - (long)(now_ms - MessageQueuedTime[msg]);
+}
+
+static uint8_t BinaryFrameId(int msg)
+{
+	// the binary frame id of the message, or 0 if the message is only sent as text.
+	// V1.0 17/10/2026 John Semmens
+	switch (msg)
 	{
-		// if we are here, its because we found something before hitting the endMarker
-		Set_LoRa_Mode(LoRa_Mode_Type::TxShortRange);
+	case TelMessageType::LNA: return tfLNA;
+	case TelMessageType::LAT: return tfLAT;
+	case TelMessageType::LPO: return tfLPO;
+	case TelMessageType::LWI: return tfLWI;
+	default: return 0;
+	}
+}
 
-		SendMessage(SerialPortNumber, (TelMessageType) msg);
+static int AddBinaryMessage(uint8_t* frame, int length, int msg)
+{
+	// add the message to the frame. Returns the new frame length, or 0 if it doesn't fit.
+	// V1.0 17/10/2026 John Semmens
+	uint8_t id = BinaryFrameId(msg);
+	int size = TelemetryFramePayloadSize(id);
+	if (length + 1 + size + 2 > TelemetryFrameMaxSize)
+	{
+		return 0;
+	}
 
-		Set_LoRa_Mode(LoRa_Mode_Type::RxLowPower);
-		LastMessageSendTime = millis();
+	frame[length++] = id;
+	uint8_t* payload = &frame[length];
+
+	switch (id)
+	{
+	case tfLNA:
+	{
+		TelemetryFrameLNA* p = (TelemetryFrameLNA*)payload;
+		p->CTE = NavData.CTE;
+		p->DTW = NavData.DTW;
+		p->BTW = NavData.BTW;
+		p->Sailable = NavData.IsBTWSailable;
+		p->Lat = NavData.Currentloc.lat;
+		p->Lon = NavData.Currentloc.lng;
+		p->COG = NavData.COG;
+		p->SOG_cmps = NavData.SOG_mps * 100;
+		p->HDG = NavData.HDG;
+		break;
+	}
+
+	case tfLAT:
+	{
+		TelemetryFrameLAT* p = (TelemetryFrameLAT*)payload;
+		p->HDG = NavData.HDG;
+		p->Pitch = (int)imu.Pitch;
+		p->Roll = (int)imu.Roll;
+		p->ROLL_Avg = NavData.ROLL_Avg;
+		p->VMG_cmps = NavData.VMG * 100;
+		break;
+	}
+
+	case tfLPO:
+	{
+		TelemetryFrameLPO* p = (TelemetryFrameLPO*)payload;
+		p->Solar_mV = PowerSensor.Solar_V * 1000;
+		p->Solar_mA = PowerSensor.Solar_I;
+		p->BatteryIn_mV = PowerSensor.BatteryIn_V * 1000;
+		p->BatteryIn_mA = PowerSensor.BatteryIn_I;
+		p->BatteryOut_mV = PowerSensor.BatteryOut_V * 1000;
+		p->BatteryOut_mA = PowerSensor.BatteryOut_I;
+		break;
+	}
+
+	case tfLWI:
+	{
+		TelemetryFrameLWI* p = (TelemetryFrameLWI*)payload;
+		p->AWA = NavData.AWA;
+		p->TWD = NavData.TWD;
+		p->TWS_cmps = NavData.TWS * 100;
+		p->WingAngle = WingSail.Angle;
+		p->TrimTabAngle = WingSail.TrimTabAngle;
+		break;
+	}
+
+	default:;
+	}
 
-		// check if there are no messages and clear the MessageToSend flag if true
-		msg = 0;
-		// check each slot, and then exit if one is occupied, or at the end.
-		while ((MessageArray[msg] == 0) && (msg < EndMarker))
+	return length + size;
+}
+
+static void SendBinaryFrame(int CommandPort, int msg, uint32_t now_ms)
+{
+	// send the message in a binary frame, together with any other waiting messages that can be sent in binary.
+	// V1.0 17/10/2026 John Semmens
+	static uint8_t Sequence;
+	uint8_t frame[TelemetryFrameMaxSize];
+
+	frame[0] = TelemetryFrameSync1;
+	frame[1] = TelemetryFrameSync2;
+	frame[3] = Sequence++;
+	int length = AddBinaryMessage(frame, 4, msg);
+	MessageArray[msg] = 0;
+
+	for (int m = 0; m < EndMarker; m++)
+	{
+		if (MessageArray[m] && BinaryFrameId(m) && (now_ms - MessageSentTime[m]) >= MessageMinInterval_ms(m))
 		{
-			msg++;
-		};
+			int added = AddBinaryMessage(frame, length, m);
+			if (added)
+			{
+				length = added;
+				MessageArray[m] = 0;
+				MessageSentTime[m] = now_ms;
+			}
+		}
+	}
 
-		if (msg == EndMarker) // if end the no messages waiting, so clear flag.
+	frame[2] = length - 3;
+	uint16_t crc = TelemetryFrameCRC16(&frame[2], length - 2);
+	frame[length++] = crc >> 8;
+	frame[length++] = crc & 0xFF;
+
+	(*Serials[CommandPort]).write(frame, length);
+}
+
+void ProcessQueue(int SerialPortNumber)
+{
+	// called from the telemetry loop
+	// find the waiting message with the best priority, send it, and clear its flag.
+	// V1.1 17/10/2026 messages are chosen by priority less time waiting, subject to a per message rate,
+	//					and are spaced by their airtime rather than a fixed 2 seconds.
+	// V1.2 17/10/2026 the message bytes are counted as soon as they are queued, then the transmit buffer is flushed 
+	//					before the mode change, so the module doesn't go to sleep with the message part sent.
+	// V1.3 17/10/2026 no flush. TelemetryReturnToReceive() changes the mode once the message has been sent.
+
+	uint32_t now_ms = millis();
+	if ((now_ms - LastMessageSendTime) < NextSendGap_ms) // don't send if we are still within the gap time of the last send
+	{
+		return;
+	}
+
+	if (ReceivePending) // the last message is still being sent
+	{
+		return;
+	}
+
+	int msg = EndMarker;
+	long priority = 0;
+	bool waiting = false;
+
+	for (int m = 0; m < EndMarker; m++)
+	{
+		if (MessageArray[m] == 0)
+		{
+			continue;
+		}
+		waiting = true;
+
+		if ((now_ms - MessageSentTime[m]) < MessageMinInterval_ms(m))
+		{
+			continue;
+		}
+
+		long p = MessagePriority_ms(m, now_ms);
+		if (msg == EndMarker || p < priority)
 		{
-			MessageToSend = false;
-		}		
-	};
+			msg = m;
+			priority = p;
+		}
+	}
+
+	if (!waiting) // no messages waiting, so clear flag.
+	{
+		MessageToSend = false;
+		return;
+	}
+
+	if (msg == EndMarker) // all waiting messages are rate limited
+	{
+		return;
+	}
+
+	Stream& port = *Serials[SerialPortNumber];
+	int free_before = port.availableForWrite();
+
+	Set_LoRa_Mode(LoRa_Mode_Type::TxShortRange);
+
+	if (Configuration.TelemetryBinary && BinaryFrameId(msg))
+	{
+		SendBinaryFrame(SerialPortNumber, msg, now_ms);
+	}
+	else
+	{
+		SendMessage(SerialPortNumber, (TelMessageType) msg);
+	}
+
+	// airtime of this message, from the bytes added to the transmit buffer, counted before the buffer drains.
+	int bytes = max(free_before - port.availableForWrite(), 0);
+
+	// the module goes back into low power receive from a later call, once the message has gone.
+	ReceivePending = true;
+	ReceiveWhenFree = free_before;
+
+	uint32_t airtime_ms = LoRaWakeUpTime_ms + (bytes * 8UL * 1000UL) / LoRaAirDataRate_bps;
+	NextSendGap_ms = airtime_ms * 100 / TelemetryAirtimeBudgetPercent;
+
+	LastMessageSendTime = now_ms;
+	MessageSentTime[msg] = now_ms;
+	MessageQueuedTime[msg] = now_ms; // the next item of a list goes to the back
+}
+
+void TelemetryReturnToReceive(int SerialPortNumber)
+{
+	// called from the telemetry loop, before ProcessQueue().
+	// Put the LoRa module back into low power receive once the last message has left the transmit buffer,
+	// and the module has sent it (AUX high). If the module doesn't say so, it is done at the end of the message's gap,
+	// before the next message is sent.
+	// V1.0 17/10/2026 John Semmens
+	if (!ReceivePending)
+	{
+		return;
+	}
+
+	bool sent = (*Serials[SerialPortNumber]).availableForWrite() >= ReceiveWhenFree && LoRa_TransmitComplete();
+	if (sent || (millis() - LastMessageSendTime) >= NextSendGap_ms)
+	{
+		Set_LoRa_Mode(LoRa_Mode_Type::RxLowPower);
+		ReceivePending = false;
+	}
 }
 
 void QueueMessage(TelMessageType msg)
 {
 	// Place the message on the message queue.
-	// Its not really a queue however. Its more like a checklist, where each message is represented in priority order.
-	// Then each message is flagged with a 1, if its to be sent.
-	// The high priority messages are at the top.
+	// Each message is represented by a flag in the message array, so a message that is already waiting is not queued twice.
 	// The "list" message are flagged by setting their to count of items in the list. 
-	// These are placed at the top of the list, even though they are not high priority. 
-	// The issue is that they need to get processed before other messages or they may take way too long to clear.
+	// V1.1 17/10/2026 record the time queued for the message priority.
+
+	if (MessageArray[msg] == 0)
+	{
+		MessageQueuedTime[msg] = millis();
+	}
 
 	switch (msg) 
 	{
@@ -435,7 +717,19 @@ void QueueMessage(TelMessageType msg)
 			break;
 
 		case TelMessageType::PRL: // parameter list  -- special case, because the rsponse is a list
-			MessageArray[msg] = MaxParameterIndex;
+			MessageArray[msg] = ParameterCount();
+			break;
+
+		case TelMessageType::PRD: // parameter dump  -- special case, because the rsponse is a list
+			MessageArray[msg] = ParameterDumpMessages();
+			break;
+
+		case TelMessageType::TPL: // task profile list  -- special case, because the rsponse is a list
+			MessageArray[msg] = SchedulerTaskCount();
+			break;
+
+		case TelMessageType::MCR: // simulated batch results list  -- special case, because the rsponse is a list
+			MessageArray[msg] = SimBatchResultCount;
 			break;
 
 		default: //	process all other message types (i.e. those that don't return a list or don't need special treatment).
@@ -524,3 +818,80 @@ void SendMissionStep(int CommandPort, int i)
 	}
 
 }
+
+void SendTaskProfile(int CommandPort, int TaskIndex)
+{
+	// send the execution time profile of one scheduler task.
+	// tpl,index,name,runs,min us,mean us,max us,overruns,missed deadlines,max lateness ms,histogram buckets...
+	// histogram bucket n counts runs of 2^n to 2^(n+1)-1 microseconds.
+	// V1.0 17/10/2026 John Semmens
+	const SchedulerTaskType* task = SchedulerGetTask(TaskIndex);
+
+	if (task == NULL || task->action == NULL)
+		return;
+
+	(*Serials[CommandPort]).print(F("tpl,"));
+	(*Serials[CommandPort]).print(TaskIndex);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->Name);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->RunCount);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->MinRun_us);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(SchedulerMeanRun_us(task));
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->MaxRun_us);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->Overruns);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->MissedDeadlines);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(task->MaxLateness_ms);
+	for (int i = 0; i < SchedulerHistogramBuckets; i++)
+	{
+		(*Serials[CommandPort]).print(",");
+		(*Serials[CommandPort]).print(task->Histogram[i]);
+	}
+	(*Serials[CommandPort]).println();
+}
+
+void SendSimBatchResult(int CommandPort, int ResultIndex)
+{
+	// send the distribution of one result of the simulated batch runs.
+	// mcr,result name,runs completed,runs requested,runs timed out,count,min,mean,std dev,max
+	// V1.0 17/10/2026 John Semmens
+	sim_stat* stat;
+	const char* name;
+
+	switch (ResultIndex)
+	{
+	case 0: stat = &simulated_batch.MissionTime_s; name = "Time_s"; break;
+	case 1: stat = &simulated_batch.LegTime_s; name = "Leg_s"; break;
+	case 2: stat = &simulated_batch.DistanceSailed_m; name = "Dist_m"; break;
+	case 3: stat = &simulated_batch.Tacks; name = "Tacks"; break;
+	case 4: stat = &simulated_batch.InIrons; name = "InIrons"; break;
+	case 5: stat = &simulated_batch.MaxCTE_m; name = "MaxCTE"; break;
+	default: return;
+	}
+
+	(*Serials[CommandPort]).print(F("mcr,"));
+	(*Serials[CommandPort]).print(name);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(simulated_batch.RunsCompleted);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(simulated_batch.RunsRequested);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(simulated_batch.RunsTimedOut);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stat->count);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stat->min, 1);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stat->mean(), 1);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stat->std_dev(), 1);
+	(*Serials[CommandPort]).print(",");
+	(*Serials[CommandPort]).print(stat->max, 1);
+	(*Serials[CommandPort]).println();
+}
@@ -12,7 +12,7 @@
 enum TelMessageType {Dummy_0
 			//	, SetWing		// wing sail commands are top priority
 			//	, SetWing2		// This is a second slot for Set Wing command. Needed to support two setwing commands in quick succesion. 
-				, PRL, MCP // then lists
+				, PRL, MCP, TPL, MCR, PRD // then lists
 				, LNA, LAT, LPO, LWP, LMI, LWI, LSV, LVS, LPF //, then remaining commands in priority order
 				, MCC, MIG, MIS, HLG, HLS, VER, TMG, LCD
 				, EQG, CCS, CCG, WC1, WC0, SCS, SCG, DBG
@@ -20,14 +20,23 @@ enum TelMessageType {Dummy_0
 				, LWS // wingsail data
 				, PRG // get one parameter
 				, PRM // Max Parameter Number
+				, IDL // scheduler idle mode
 ,EndMarker};
 
 
+// LoRa link, as set up in Init_LoRa(). Used to work out the airtime of each message.
+static const unsigned long LoRaAirDataRate_bps = 2400;	// AIR_DATA_RATE_010_24
+static const unsigned long LoRaWakeUpTime_ms = 250;		// WAKE_UP_250. The preamble sent before each message in wake up mode.
+static const int TelemetryWriteBufferSize = 512;		// bytes added to the telemetry port transmit buffer
+
 void SendMessage(int SerialPortNumber, TelMessageType msg);
 void ProcessQueue(int SerialPortNumber);
+void TelemetryReturnToReceive(int SerialPortNumber);
 
 void QueueMessage(TelMessageType msg);
 void SendMissionStep(int CommandPort, int index);
+void SendTaskProfile(int CommandPort, int TaskIndex);
+void SendSimBatchResult(int CommandPort, int ResultIndex);
 
 //void WakeupPrefix(int CommandPort,char NextAddr);
 
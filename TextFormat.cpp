@@ -0,0 +1,278 @@
+// Text formatting into caller provided buffers.
+// The standard library printf is not used because its floating point conversion can allocate from the heap.
+// V1.0 17/10/2026 John Semmens
+
+#include "TextFormat.h"
+
+struct TextWriterType {
+	char* Buffer;
+	size_t Size;
+	size_t Length;
+};
+
+static void Put(TextWriterType& w, char c)
+{
+	// add a character, if there is room for it and the terminating null.
+	if (w.Length + 1 < w.Size)
+	{
+		w.Buffer[w.Length++] = c;
+	}
+}
+
+static void PutPadded(TextWriterType& w, const char* text, int length, int width, bool left, char pad)
+{
+	// add the text, padded to the width. A sign is kept in front of zero padding.
+	int padding = width - length;
+
+	if (!left && pad == '0' && length > 0 && text[0] == '-')
+	{
+		Put(w, *text++);
+		length--;
+	}
+
+	if (!left)
+	{
+		for (; padding > 0; padding--)
+		{
+			Put(w, pad);
+		}
+	}
+
+	for (int i = 0; i < length; i++)
+	{
+		Put(w, text[i]);
+	}
+
+	for (; padding > 0; padding--)
+	{
+		Put(w, ' ');
+	}
+}
+
+static int UnsignedToText(char* text, unsigned long long value, unsigned int base)
+{
+	// convert the value to digits, most significant first. Returns the number of digits.
+	char digits[24];
+	int count = 0;
+
+	do
+	{
+		unsigned int digit = value % base;
+		digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+		value /= base;
+	} while (value > 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		text[i] = digits[count - 1 - i];
+	}
+	return count;
+}
+
+static int FloatToText(char* text, double value, int precision)
+{
+	// convert the value to fixed point text with the given number of decimal places.
+	// V1.0 17/10/2026 John Semmens
+	int length = 0;
+
+	if (isnan(value))
+	{
+		strcpy(text, "nan");
+		return 3;
+	}
+
+	if (value < 0)
+	{
+		text[length++] = '-';
+		value = -value;
+	}
+
+	if (precision > 9)
+	{
+		precision = 9;
+	}
+
+	unsigned long scale = 1;
+	for (int i = 0; i < precision; i++)
+	{
+		scale *= 10;
+	}
+
+	// 1.8e19 is the largest unsigned long long. Beyond that, and for infinity, show an overflow.
+	if (value * scale >= 1.8e19)
+	{
+		strcpy(text + length, "ovf");
+		return length + 3;
+	}
+
+	unsigned long long scaled = (unsigned long long)(value * scale + 0.5);
+	length += UnsignedToText(text + length, scaled / scale, 10);
+
+	if (precision > 0)
+	{
+		text[length++] = '.';
+		char fraction[12];
+		int digits = UnsignedToText(fraction, scaled % scale, 10);
+		for (int i = digits; i < precision; i++)
+		{
+			text[length++] = '0';
+		}
+		memcpy(text + length, fraction, digits);
+		length += digits;
+	}
+	return length;
+}
+
+size_t FormatTextV(char* buffer, size_t size, const char* format, va_list args)
+{
+	// V1.0 17/10/2026 John Semmens
+	TextWriterType w = { buffer, size, 0 };
+	char text[32];
+
+	if (size == 0)
+	{
+		return 0;
+	}
+
+	while (*format)
+	{
+		if (*format != '%')
+		{
+			Put(w, *format++);
+			continue;
+		}
+		format++;
+
+		bool left = false;
+		char pad = ' ';
+		for (;; format++)
+		{
+			if (*format == '-')
+			{
+				left = true;
+			}
+			else if (*format == '0')
+			{
+				pad = '0';
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		int width = 0;
+		while (*format >= '0' && *format <= '9')
+		{
+			width = width * 10 + (*format++ - '0');
+		}
+
+		int precision = -1;
+		if (*format == '.')
+		{
+			format++;
+			precision = 0;
+			while (*format >= '0' && *format <= '9')
+			{
+				precision = precision * 10 + (*format++ - '0');
+			}
+		}
+
+		bool isLong = false;
+		if (*format == 'l')
+		{
+			isLong = true;
+			format++;
+		}
+
+		int length = 0;
+		switch (*format)
+		{
+		case 'd':
+		case 'i':
+		{
+			long value = isLong ? va_arg(args, long) : va_arg(args, int);
+			unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+			if (value < 0)
+			{
+				text[length++] = '-';
+			}
+			length += UnsignedToText(text + length, magnitude, 10);
+			PutPadded(w, text, length, width, left, pad);
+			break;
+		}
+
+		case 'u':
+		case 'x':
+		{
+			unsigned long value = isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+			length = UnsignedToText(text, value, *format == 'x' ? 16 : 10);
+			PutPadded(w, text, length, width, left, pad);
+			break;
+		}
+
+		case 'f':
+			length = FloatToText(text, va_arg(args, double), precision < 0 ? 6 : precision);
+			PutPadded(w, text, length, width, left, pad);
+			break;
+
+		case 'c':
+			text[0] = (char)va_arg(args, int);
+			PutPadded(w, text, 1, width, left, ' ');
+			break;
+
+		case 's':
+		{
+			const char* s = va_arg(args, const char*);
+			if (!s)
+			{
+				s = "";
+			}
+			length = strlen(s);
+			if (precision >= 0 && precision < length)
+			{
+				length = precision;
+			}
+			PutPadded(w, s, length, width, left, ' ');
+			break;
+		}
+
+		case '%':
+			Put(w, '%');
+			break;
+
+		default:
+			// unsupported conversion. Show it as it is, so the mistake is visible in the output.
+			Put(w, '%');
+			if (*format == '\0')
+			{
+				continue;
+			}
+			Put(w, *format);
+		}
+		format++;
+	}
+
+	buffer[w.Length] = '\0';
+	return w.Length;
+}
+
+size_t FormatText(char* buffer, size_t size, const char* format, ...)
+{
+	// V1.0 17/10/2026 John Semmens
+	va_list args;
+	va_start(args, format);
+	size_t length = FormatTextV(buffer, size, format, args);
+	va_end(args);
+	return length;
+}
+
+const char* EnumText(const char* const table[], int count, int value, const char* invalid)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (value < 0 || value >= count)
+	{
+		return invalid;
+	}
+	return table[value];
+}
@@ -0,0 +1,29 @@
+// TextFormat.h
+
+// Text formatting into caller provided buffers, in place of the Arduino String class.
+// Building messages with String concatenation allocates from the heap for every part of the message,
+// which over months of unattended running can fragment the heap until an allocation fails.
+// FormatText is a small printf into a fixed size buffer. It never allocates, and truncates rather than overflows.
+// Supports %d %i %u %ld %lu %x %lx %c %s %f and %%, with the - and 0 flags, a width, and a precision (.n)
+// for %f (decimal places, default 6) and %s (maximum characters).
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _TEXTFORMAT_h
+#define _TEXTFORMAT_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <stdarg.h>
+
+size_t FormatText(char* buffer, size_t size, const char* format, ...);
+size_t FormatTextV(char* buffer, size_t size, const char* format, va_list args);
+
+// look up the text for an enumerated value in a table of names, indexed by the value.
+// Returns the invalid text for a value outside the table.
+const char* EnumText(const char* const table[], int count, int value, const char* invalid = "Invalid");
+
+#endif
@@ -107,10 +107,41 @@
 // V3.4.50 24/11/2024 improved equipment logging at startup - LoRa and INA3221a
 // V3.4.51  4/12/2024 changed OLED screen for Decisions from C to G to match V4.
 // V3.4.52 23/2/2025 Update PastBoundaryHold test to restrict to beating.
-
-
-char Version[] = "V3.4.52"; 
-char VersionDate[] = "23/2/2025";
+// V3.4.53 17/10/2026 Scheduler V2: tasks registered in setup with priorities, drift-free deadlines, one task per pass of the loop.
+// V3.4.54 17/10/2026 Added per-task execution time profile. CLI tpl/tpc, SD Task record, OLED page t.
+// V3.4.55 17/10/2026 Added scheduler idle mode, processor waits for interrupt between tasks. CLI idl for control and current comparison.
+// V3.4.56 17/10/2026 Added VirtualMillis clock for scheduler, navigation, mission and simulation. CLI sms sets faster than real time simulation.
+// V3.4.57 17/10/2026 Added simulated mission batch runner, sim_batch. CLI mcr.
+// V3.4.58 17/10/2026 sim_vessel VPP from polar table with bilinear interpolation, heel and leeway. CLI spb.
+// V3.4.59 17/10/2026 sim_weather wind field with oscillating and persistent shifts, speed variation and moving gust cells.
+// V3.4.60 17/10/2026 seeded random number generator for the simulation, so that simulated runs can be repeated. Set with srs.
+// V3.4.61 17/10/2026 log replay (lrp) through the sailing navigation, comparing recomputed CTS, CourseType and decisions with the log.
+// V3.4.62 17/10/2026 optional binary 1 second SD log records (parameter 56), decoded with lbd. EEPROM config version 8.
+// V3.4.63 17/10/2026 SD log files written through a RAM buffer, drained a sector at a time by the SDWr task.
+// V3.4.64 17/10/2026 flight recorder. 40 Hz steering state around each decision and in-irons change, written to a .frc file.
+// V3.4.65 17/10/2026 telemetry queue with priority ageing, per message rate limits, interleaved lists and a LoRa airtime budget.
+// V3.4.66 17/10/2026 optional binary telemetry frames with CRC for the LoRa link (parameter 57 TelemetryBinary).
+// V3.4.67 17/10/2026 CLI and Bluetooth commands dispatched from sorted command tables, parameters not copied.
+// V3.4.68 17/10/2026 parameter registry. prg/prs/prl from one table with ranges and units, and prd/prb bulk parameter dump and load.
+// V3.4.69 17/10/2026 CLI session per port, polled every 10 ms by the CLI task, instead of a shared buffer read once a second.
+// V3.4.70 17/10/2026 acknowledged wingsail commands with retransmit, coalescing, round trip times and the wakeup preamble only after an idle link.
+// V3.4.71 17/10/2026 messages, file names and status text formatted into fixed buffers instead of Strings. Heap high water mark monitored after setup.
+// V3.4.72 17/10/2026 OLED partial refresh. Only the columns of each page that have changed are sent over I2C.
+// V3.4.73 17/10/2026 compass read in the background by I2C callbacks, started at the end of each FastLoop and used at the start of the next.
+// V3.4.74 17/10/2026 compass oversampling (parameter 58). Accelerometer FIFO at 200 Hz, FIR filtered and decimated to the FastLoop. EEPROM config version 10.
+// V3.4.75 17/10/2026 I2C transaction manager for buses 0 to 2. Compass read queued, other devices hold the bus, per device statistics (i2c), bus recovery by the I2C task.
+// V3.4.76 17/10/2026 wing angle port sensor sampled at 40 Hz into its FIFO, read in the background with timestamps. Standby starboard sensor read by the health check only.
+// V3.4.77 17/10/2026 compass ellipsoid (hard and soft iron) calibration fitted in the background (mgf), used with parameter 59. Raw compass recording (mgr) and bench comparison (mgb). EEPROM config version 11.
+// V3.4.78 17/10/2026 the scheduler stays on real time. Only the Slow, Med and Sim tasks follow the simulation speed. Bluetooth and wingsail updates moved to WSMon, servo power and wing movement to Log1s.
+// V3.4.79 17/10/2026 serial ports held as Stream, so USB is port 0. USB command line session, running the same commands as LoRa.
+// V3.4.80 17/10/2026 wingsail angle is the mean of the wing angle sensor's 25 ms samples over the 200 ms measurement loop.
+// V3.4.81 17/10/2026 software in the loop build for a Linux host, see sil/Makefile. IMU not read if the compass wasn't found.
+// V3.4.82 17/10/2026 the SD writer task writes one log writer's sector per call. Smaller flight recorder and compass bench buffers.
+// V3.4.83 17/10/2026 the telemetry loop puts the LoRa module back into low power receive once a message has been sent.
+
+
+char Version[] = "V3.4.83"; 
+char VersionDate[] = "17/10/2026";
 
 // Build Notes: use Visual Studio 2019,VS2022
 // teensy 3.6 on Voyager controller board V3.0
@@ -161,10 +192,18 @@ char VersionDate[] = "23/2/2025";
 #include "TelemetryMessages.h"
 #include "sim_vessel.h"
 #include "sim_weather.h"
+#include "sim_batch.h"
+#include "sim_rng.h"
 #include "TimeLib.h"
 #include "HAL_Time.h"
 #include "BluetoothConnection.h"
 #include "HAL_Watchdog.h"
+#include "HAL_SDLogWriter.h"
+#include "FlightRecorder.h"
+#include "CLISession.h"
+#include "TextFormat.h"
+#include "HeapMonitor.h"
+#include "I2CManager.h"
 
 HALGPS gps;							// HAL GPS object
 HALServo servo;						// HAL Servo object
@@ -179,12 +218,14 @@ bool UseSimulatedVessel = false;	// flag to disable the GPS and indicate that th
 
 sim_vessel simulated_vessel;		// Simulated vessel object
 sim_weather simulated_weather;		// Simulated weather object
+sim_batch simulated_batch;			// Simulated mission batch runner
+uint32_t SimulationSeed = 1;		// seed of the simulated weather and vessel random numbers
 
 time_t GPSTime;
 
 uint32_t SSSS;						// Second counter from boot up.
 uint32_t Minute;					// Minute counter from boot up.
-String LogFileName;					// current log file name
+char LogFileName[LogFileNameSize];	// current log file name
 bool RTC_updated = false;
 
 int HWConfigNumber = 0;				// Configuration number. Read from hardware jumpers.
@@ -202,7 +243,17 @@ NavigationDataType NavData; // stucture containing the current navigational data
 
 bool TurnHeadingInitialised = false;
 
-File LogFile;
+uint8_t LogFileBuffer[LogWriterBufferSize];
+uint8_t LogBinaryFileBuffer[LogWriterBufferSize];
+uint8_t FlightRecorderFileBuffer[LogWriterSmallBufferSize];
+uint8_t CompassBenchFileBuffer[LogWriterSmallBufferSize];
+HALSDLogWriter LogFile(LogFileBuffer);						// buffered log file, written to the SD card by the SDWr task
+HALSDLogWriter LogBinaryFile(LogBinaryFileBuffer);			// binary 1 second records, when Configuration.SDCardLogBinary is set
+HALSDLogWriter FlightRecorderFile(FlightRecorderFileBuffer);	// flight recorder blocks, passed a sector at a time
+HALSDLogWriter CompassBenchFile(CompassBenchFileBuffer);	// raw compass samples, while recording with mgr, about 600 bytes/s
+CLISession USBCLI;					// command lines from the USB serial port
+CLISession LoRaCLI;					// command lines from the LoRa telemetry port
+CLISession BluetoothCLI;			// wingsail responses from the Bluetooth port
 bool SD_Card_Present; // Flag for SD Card Presence
 
 // Loop Timer Contants used by the scheduler
@@ -223,10 +274,15 @@ static const int TelemetryLoopTime = 100;  //ms 0.5 seconds
 static const unsigned long WingSailMonitorLoopTime = 5000; //ms 5 seconds 
 static const unsigned long WingSailPowerMonitorLoopTime = 600000; //ms 10 minutes 
 static const unsigned long Logging2hrTime =  7200000; // ms 7200 seconds 2 hours
+static const int SDWriterLoopTime = 10; //ms. about 50 kbytes/s at one sector per call.
+static const int CLILoopTime = 10; //ms. command lines are processed within about 10 ms of arriving.
+static const int I2CLoopTime = 10; //ms. stuck I2C transactions are timed out, and the bus recovered, within about 10 ms.
+static const int SimLoopTime = 1000; //ms 1 second, divided by the simulation speed.
 
 long loop_period_us; // microseconds between successive main loop executions
 
-HardwareSerial* Serials[5]; // array for serial ports
+Stream* Serials[5];			// serial ports by port number, for reading and writing. Port 0 is USB, ports 1 to 4 are the UARTs.
+HardwareSerial* UARTs[5];		// the same ports for begin() and the buffer sizes. NULL for USB.
 
 // strings used to hold the display messages for the LCD/OLED, required the command "dsp"
 char MessageDisplayLine1[10];
@@ -252,8 +308,10 @@ int LastParameterIndex = 0;
 byte BluetoothStatePin = 36; 
 BTStateType BTState = Idle;
 
-void SlowLoop(void*) // 5 seconds
+void SlowLoop(void*) // 5 seconds, divided by the simulation speed
 {
+	// V1.1 17/10/2026 Bluetooth and wingsail updates moved to the WingSailMonitorLoop, which stays on real time.
+
 	// check if the mission has advanced to the next step
 	// and update the next and previous waypoints needed for navigation.
 	MissionUpdate();
@@ -265,23 +323,16 @@ void SlowLoop(void*) // 5 seconds
 	// calculate the best course to steer, including all tacking decisions this sets NavData.CTS
 	UpdateCourseToSteer();
 
-	// work through each step of intialising and connecting BT5.
-	BluetoothManageConnection(Configuration.BluetoothPort);
-
-	// Update Sail Settings e.g set the sails in accordance with the current point of sail.
-	wingsail_update();
-
 	Watchdog_Pat();
 }
 
-void MediumLoop(void*)  // 1 second
+void MediumLoop(void*)  // 1 second, divided by the simulation speed
 {
+	// V1.1 17/10/2026 servo power management and wing movement detection moved to the LoggingLoop, which stays on real time.
+
 	// increment the tack timer
 	NavData.TackDuration = NavData.TackDuration + 1;
 
-	// process serial command messages
-	CLI_Process_Message(Configuration.LoRaPort);
-
 	// Process Vessel Command State Changes from Telemetry Radio Command Line Interpreter
 	CommandState_Processor();
 
@@ -293,9 +344,6 @@ void MediumLoop(void*)  // 1 second
 	// Calculate Headings during a turn by setting the course dead-downwind briefly to force a gybe, when required.
 	// This sets NavData.TurnHDG
 	UpdateTurnHeadingV2();
-
-	servo.PowerManagement();
-	WingAngleSensor.UpdateMovementDetection(WingAngleSensor.Angle);
 }
 
 void FastLoop(void*) // 25 ms
@@ -305,6 +353,8 @@ void FastLoop(void*) // 25 ms
 	NavigationUpdate_FastData(); // calculate the true heading
 	UpdateTargetHeading();	// Target Heading is based on CTS with a Low pass filter
 	SteeringFastUpdate();	// update steering servo postion based on nav data
+	FlightRecorder_Sample();
+	imu.StartRead();	// read the compass in the background, ready for the next FastLoop
 }
 
 void LoggingLoop(void*) 	// 1 second
@@ -315,29 +365,34 @@ void LoggingLoop(void*) 	// 1 second
 	// V1.2 22/12/2018 added reading of Voltage/Current Sensor
 	// V1.3 21/2/2019 added update of usage stats object
 	// V1.4 9/1/2022 added Minute, changed to SSSS
+	// V1.5 17/10/2026 added HeapMonitorUpdate
+	// V1.6 17/10/2026 wait for the background compass read before using the I2C bus
+	// V1.7 17/10/2026 removed the wait. The power sensor and the display hold the bus with the I2C manager.
+	// V1.8 17/10/2026 added the compass ellipsoid fit.
+	// V1.9 17/10/2026 simulated vessel update moved to the SimLoop. Servo power management and wing movement detection moved here from the MediumLoop.
 
 	SSSS = millis() / 1000;
 	Minute = millis() / 60000;
 
 	// Read the INA3221a I2C Triple Voltage/Current Sensor
 	PowerSensor.read();
+	PowerSensor.AccumulateIdleCurrent(SchedulerIdleEnabled());
 
 	// update the usage stats object with the latest individual counters.
 	updateUsageTrackingStats();
 
+	HeapMonitorUpdate();
+
+	imu.FitMagCalibration();
+
+	servo.PowerManagement();
+	WingAngleSensor.UpdateMovementDetection(WingAngleSensor.Angle);
+
 	SD_Logging_1s();
 
 	Display.Page(Configuration.DisplayScreenView);
 	//Display.Page('9'); boot display
 	//Display.Page('u'); //satcomm display
-		
-	// Retrieve any messages from the Bluetooth serial
-	BT_CLI_Process_Message(Configuration.BluetoothPort);
-
-	// If we using a simulated Vessel, then perform a periodic update.
-	if (UseSimulatedVessel) {
-		simulated_vessel.update();
-	}
 }
 
 void LoggingLoop1m(void*) // 1 minute loop
@@ -346,8 +401,6 @@ void LoggingLoop1m(void*) // 1 minute loop
 	SD_Logging_1m();
 //	SD_Logging_Event_Usage(); // temporary logging of usage every minute  **************************************
 
-	simulated_weather.update();
-
 	// If location is good, then time is good, so perfrom a once off update of the RTC
 	if (gps.GPS_LocationIs_Valid(NavData.Currentloc) && !RTC_updated )
 	{
@@ -370,15 +423,91 @@ void SlowLoggingLoop(void*) // 10 minutes
 	}
 }
 
+void SDWriterLoop(void*) // 10 ms
+{
+	// write the next sector of the buffered log files to the SD card.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 one writer's sector per call, rather than one from each. The writers take turns, starting after
+	//					the one that last wrote, and a writer with nothing to write passes its turn on in the same call.
+	static HALSDLogWriter* const Writers[] = { &LogFile, &LogBinaryFile, &FlightRecorderFile, &CompassBenchFile };
+	static const int WriterCount = sizeof(Writers) / sizeof(Writers[0]);
+	static int NextWriter = 0;
+
+	FlightRecorder_Write();
+
+	for (int i = 0; i < WriterCount; i++)
+	{
+		HALSDLogWriter* writer = Writers[NextWriter];
+		NextWriter = (NextWriter + 1) % WriterCount;
+		if (writer->drain())
+		{
+			break;
+		}
+	}
+}
+
+void CLILoop(void*) // 10 ms
+{
+	// move received characters into each port's command line session, and process any complete line.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 added the USB port. A LoRa or Bluetooth port number of 0 means the port is not fitted.
+	USBCLI.poll(0);
+	if (Configuration.LoRaPort)
+		LoRaCLI.poll(Configuration.LoRaPort);
+	if (Configuration.BluetoothPort)
+		BluetoothCLI.poll(Configuration.BluetoothPort);
+}
+
+void SimLoop(void*) // 1 second, divided by the simulation speed
+{
+	// update the simulated vessel, and the simulated weather once a simulated minute.
+	// V1.0 17/10/2026 John Semmens
+	static int SimMinuteCount = 0;
+
+	if (UseSimulatedVessel) {
+		simulated_vessel.update();
+		simulated_batch.update();
+	}
+
+	SimMinuteCount++;
+	if (SimMinuteCount >= 60)
+	{
+		SimMinuteCount = 0;
+		simulated_weather.update();
+	}
+}
+
+void I2CLoop(void*) // 10 ms
+{
+	// time out stuck I2C transactions and recover the buses.
+	// V1.0 17/10/2026 John Semmens
+	I2CManagerPoll();
+}
+
 void TelemetryLoop(void*) // 1 second
 {
 	// pull one message from the queue and send it.
-	if ((Configuration.LoRaPort) && MessageToSend)
-		ProcessQueue(Configuration.LoRaPort);
+	// V1.1 17/10/2026 the LoRa module is put back into low power receive once the last message has been sent.
+	if (Configuration.LoRaPort)
+	{
+		TelemetryReturnToReceive(Configuration.LoRaPort);
+		if (MessageToSend)
+		{
+			ProcessQueue(Configuration.LoRaPort);
+		}
+	}
 }
 
-void WingSailMonitorLoop(void*) // 10 seconds
+void WingSailMonitorLoop(void*) // 5 seconds
 {
+	// V1.1 17/10/2026 Bluetooth connection and wingsail updates moved here from the SlowLoop, so they stay on real time.
+
+	// work through each step of intialising and connecting BT5.
+	BluetoothManageConnection(Configuration.BluetoothPort);
+
+	// Update Sail Settings e.g set the sails in accordance with the current point of sail.
+	wingsail_update();
+
 	// check the wingsail time of last command and time of last response.
 	CheckWingSailServo();
 
@@ -398,9 +527,13 @@ void FastMeasurementLoop(void*) // 200ms
 {
 	gps.Read();			// update location data from the GPS
 
-	// get the position of the wingsail. 
+	// get the position of the wingsail, the mean of the 25 ms samples since the last loop.
+	// The trim tab and the tack tracking see the wing's position over the loop, not one sample of it.
 	WingAngleSensor.Read();
-	WingSail.Angle = WingAngleSensor.Angle;
+	if (!WingAngleSensor.GetMeanAngle(FastMeasurementLoopTime, WingSail.Angle))
+	{
+		WingSail.Angle = WingAngleSensor.Angle;
+	}
 
 	//if using simulation, then override real WingAngle Sensor data with simulated angle.
 	if (UseSimulatedVessel) {
@@ -409,6 +542,9 @@ void FastMeasurementLoop(void*) // 200ms
 
 	// track changes of tack status here, in the fast loop, to ensure fast response to tacking manoeuvre.
 	Wingsail_TrackTackChange();
+
+	// resend wingsail commands that have not been acknowledged.
+	WingSailLinkUpdate();
 }
 
 
@@ -417,10 +553,11 @@ void setup()
 	Serial.begin(9600);
 	delay(1000); // A delay seems necessary before the USB Serial Port is usable.
 
-	Serials[1] = &Serial1; 
-	Serials[2] = &Serial2;
-	Serials[3] = &Serial3;
-	Serials[4] = &Serial4;
+	Serials[0] = &Serial;
+	Serials[1] = UARTs[1] = &Serial1; 
+	Serials[2] = UARTs[2] = &Serial2;
+	Serials[3] = UARTs[3] = &Serial3;
+	Serials[4] = UARTs[4] = &Serial4;
 
 	// send start up message to the configured USB Serial Port.
 	Serial.println(F("*** Voyager OS Starting *****"));
@@ -437,6 +574,7 @@ void setup()
 	// load the configuration from the EEPROM and validate the version of the stored structure
 	Load_ConfigValues();
 
+	I2CManagerInit();	// before the I2C devices are initialised
 	Display.Init();		// OLED Display
 	Display.Page('v');  // initially display the Version information on the LCD. 
 					    //This is for a few seconds prior to the configured screen being displayed.
@@ -454,7 +592,6 @@ void setup()
 	Navigation_Init();// set up True Wind low-pass Filter
 	servo.Servos_Init(); // Init the Servo Out Channels
 	SteeringPID_Init();
-	SchedulerInit();
 
 	time_init();
 
@@ -509,17 +646,57 @@ void setup()
 
 	simulated_weather.init();
 	simulated_vessel.init();
+	if (SD_Card_Present && simulated_vessel.LoadPolar("POLAR.TXT"))
+	{
+		SD_Logging_Event_Messsage(F("Sim Polar loaded from POLAR.TXT"));
+	}
+	SetSimulationSeed(SimulationSeed); // the seed is in the header of each log file
+
+	char message[32];
 
 	SD_Logging_Event_Messsage(Configuration.VesselName);
 
-	SD_Logging_Event_Messsage("F_CPU " + String(F_CPU / 1000000) + "MHz");
-	SD_Logging_Event_Messsage("F_BUS " + String(F_BUS / 1000000) + "MHz");
+	FormatText(message, sizeof(message), "F_CPU %luMHz", (unsigned long)(F_CPU / 1000000));
+	SD_Logging_Event_Messsage(message);
+	Serial.println(message);
 
-	Serial.println("F_CPU " + String(F_CPU / 1000000) + "MHz");
-	Serial.println("F_BUS " + String(F_BUS / 1000000) + "MHz");
+	FormatText(message, sizeof(message), "F_BUS %luMHz", (unsigned long)(F_BUS / 1000000));
+	SD_Logging_Event_Messsage(message);
+	Serial.println(message);
 
 	Watchdog_Init(20); // seconds timeout -- pat dog in 5 second loop
 
+	// register the tasks with the scheduler. Each task is due immediately, so runs on the first passes of the loop.
+	// priority 0 is the highest. When several tasks are due, the highest priority task is run first.
+	USBCLI.begin(CLI_Processor);
+	LoRaCLI.begin(CLI_Processor);
+	BluetoothCLI.begin(BT_CLI_Processor);
+
+	SchedulerInit();
+	SchedulerAddTask(0, &SlowLoop, SlowLoopTime, 4, "Slow");
+	SchedulerAddTask(1, &MediumLoop, MediumLoopTime, 3, "Med");
+	SchedulerAddTask(2, &FastLoop, FastLoopTime, 0, "Fast");
+	SchedulerAddTask(3, &LoggingLoop, LoggingLoopTime, 5, "Log1s");
+	SchedulerAddTask(4, &SlowLoggingLoop, SlowLoggingLoopTime, 8, "SLog");
+	SchedulerAddTask(5, &TelemetryLoop, TelemetryLoopTime, 2, "Telem");
+	SchedulerAddTask(6, &WingSailMonitorLoop, WingSailMonitorLoopTime, 6, "WSMon");
+	SchedulerAddTask(7, &WingSailPowerMonitorLoop, WingSailPowerMonitorLoopTime, 8, "WSPwr");
+	SchedulerAddTask(8, &FastMeasurementLoop, FastMeasurementLoopTime, 1, "FMeas");
+	SchedulerAddTask(9, &LoggingLoop1m, Logging1mTime, 7, "Log1m");
+	//SchedulerAddTask(10, &IMULoop, IMULoopTime, 0, "IMU");
+	SchedulerAddTask(11, &SDWriterLoop, SDWriterLoopTime, 9, "SDWr");
+	SchedulerAddTask(12, &CLILoop, CLILoopTime, 2, "CLI");
+	SchedulerAddTask(13, &I2CLoop, I2CLoopTime, 1, "I2C");
+	SchedulerAddTask(14, &SimLoop, SimLoopTime, 5, "Sim");
+
+	// the scheduler runs on real time. The navigation and simulation tasks run faster than real time when the simulation speed is set.
+	SchedulerSetSimulated(0);
+	SchedulerSetSimulated(1);
+	SchedulerSetSimulated(14);
+
+	// from here on the heap should not be used. Record the heap use as the baseline for the high water mark.
+	HeapMonitorBegin();
+
 	Serial.println(F("*** Voyager OS Pilot is Ready *****"));
 	Serial.println();
 }
@@ -529,18 +706,11 @@ void loop()
 {
 	static long prev_loop_time_us; // used for loop timing statistics
 
-	//give the scheduler a chance to act
-	SchedulerTick(0, &SlowLoop, SlowLoopTime);
-	SchedulerTick(1, &MediumLoop, MediumLoopTime);
-	SchedulerTick(2, &FastLoop, FastLoopTime);
-	SchedulerTick(3, &LoggingLoop, LoggingLoopTime);
-	SchedulerTick(4, &SlowLoggingLoop, SlowLoggingLoopTime);
-	SchedulerTick(5, &TelemetryLoop, TelemetryLoopTime);
-	SchedulerTick(6, &WingSailMonitorLoop, WingSailMonitorLoopTime);
-	SchedulerTick(7, &WingSailPowerMonitorLoop, WingSailPowerMonitorLoopTime);
-	SchedulerTick(8, &FastMeasurementLoop, FastMeasurementLoopTime);
-	SchedulerTick(9, &LoggingLoop1m, Logging1mTime);
-	//SchedulerTick(10, &IMULoop, IMULoopTime);
+	//give the scheduler a chance to act. If there is nothing to do, wait in low power for the next task or serial input.
+	if (!SchedulerRun())
+	{
+		SchedulerIdle();
+	}
 
 	// update loop timing statistics
 	long micro = micros();
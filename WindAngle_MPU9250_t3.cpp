@@ -41,26 +41,40 @@ Added support for both MPU-9250 and MPU-9255
 
 #include "configValues.h"
 
-// Pin definitions
-int intPin = 12;  // These can be changed, 2 and 3 are the Arduinos ext int pins
+extern configValuesType Configuration;
 
+// Background reads. V1.0 17/10/2026 John Semmens
+static const uint8_t WingAnglePriority = 1;		// after the compass
+static const uint32_t WingAngleDeadline_us = 50000;
 
-extern configValuesType Configuration;
+// times of the last data ready pulse from each bus's sensor, when its interrupt pin is connected.
+static volatile uint32_t DataReady_us[I2CManagerBuses];
+static void DataReady0(void) { DataReady_us[0] = micros(); }
+static void DataReady1(void) { DataReady_us[1] = micros(); }
+static void DataReady2(void) { DataReady_us[2] = micros(); }
+static void (* const DataReadyInterrupts[I2CManagerBuses])(void) = { DataReady0, DataReady1, DataReady2 };
 
 
-void WindAngle_9250::Init(uint8_t I2CPort)
+void WindAngle_9250::Init(uint8_t I2CPort, int device, bool fifo, int interruptPin)
 {
 	// V1.1 22/10/2016 updated to support parameterised serial port
 	// V1.2 22/11/2016 updated to improve handling where there's no IMU found.
+	// V1.3 17/10/2026 background sampling, with the I2C manager device, FIFO mode and interrupt pin as parameters.
+	//                 The fixed interrupt pin 12 is removed. It is the servo 0 power pin.
 
 	// TWBR = 12;  // 400 kbit/sec I2C speed
 	WingSailAngleSensor->I2CPort = I2CPort;
+	this->I2CPort = I2CPort;
+	Device = device;
+	Fifo = fifo;
+	InterruptPin = interruptPin;
+	SampleCount = 0;
+	SampleNext = 0;
+	Pending = 0;
+	ReadStarted = false;
+	FifoReads = FifoOverflows = ReadErrors = ReadOverruns = 0;
 	i2c_t3(I2CPort).begin();
 
-	// Set up the interrupt pin, its set as active high, push-pull
-	pinMode(intPin, INPUT);
-	digitalWrite(intPin, LOW);
-
 	// enable a calibration update on each read.
 	//WingSailAngleSensor->MagneticCompassCalibrationMode = true;
 
@@ -97,6 +111,18 @@ void WindAngle_9250::Init(uint8_t I2CPort)
 
 		// Get magnetometer calibration from AK8963 ROM
 		WingSailAngleSensor->initAK8963(WingSailAngleSensor->magCalibration);
+		WingSailAngleSensor->getMres();
+
+		// the MPU9250 now reads the magnetometer itself, at each sample.
+		WingSailAngleSensor->initSampling(WingAngleSampleRateDivider);
+		WingSailAngleSensor->enableFifo(Fifo);
+
+		// Set up the interrupt pin, its set as active high, push-pull
+		if (InterruptPin >= 0)
+		{
+			pinMode(InterruptPin, INPUT);
+			attachInterrupt(digitalPinToInterrupt(InterruptPin), DataReadyInterrupts[I2CPort], RISING);
+		}
 
 	//	IMU_Mag_Init();
 		status = true;
@@ -139,61 +165,214 @@ void  WindAngle_9250::IMU_Mag_Calibrate()
 	if (Configuration.WingAngle_mYScale < abs(WingSailAngleSensor->my)) Configuration.WingAngle_mYScale = abs(WingSailAngleSensor->my);
 }
 
-void  WindAngle_9250::Read()
+bool  WindAngle_9250::Read()
 {
-	// If intPin goes high, all data registers have new data
-	// On interrupt, check if data ready interrupt
-	if (WingSailAngleSensor->readByte( MPU9250_ADDRESS, INT_STATUS) & 0x01)
+	// V1.3 17/10/2026 one transfer of ACCEL_XOUT_H to EXT_SENS_DATA, which has the magnetometer record copied
+	// there by the MPU9250 at the last sample. The bus is held with the I2C manager for the read.
+	uint8_t raw[22];	// accelerometer, temperature, gyro and magnetometer record
+	const int RawTemp = 6;
+	const int RawMag = 14;
+
+	if (!status)
 	{
-		WingSailAngleSensor->readAccelData(WingSailAngleSensor->accelCount);  // Read the x/y/z adc values
-		WingSailAngleSensor->getAres();
+		return false;
+	}
 
-		// Now we'll calculate the acceleration value into actual g's
-		// This depends on scale being set
-		WingSailAngleSensor->ax = (float)WingSailAngleSensor->accelCount[0] * WingSailAngleSensor->aRes; // - accelBias[0];
-		WingSailAngleSensor->ay = (float)WingSailAngleSensor->accelCount[1] * WingSailAngleSensor->aRes; // - accelBias[1];
-		WingSailAngleSensor->az = (float)WingSailAngleSensor->accelCount[2] * WingSailAngleSensor->aRes; // - accelBias[2];
+	I2CBusBegin(Device);
+	bool ok = WingSailAngleSensor->readBytes(MPU9250_ADDRESS, ACCEL_XOUT_H, sizeof(raw), raw) == sizeof(raw);
+	I2CBusEnd(Device);
 
-		WingSailAngleSensor->readGyroData(WingSailAngleSensor->gyroCount);  // Read the x/y/z adc values
-		WingSailAngleSensor->getGres();
+	if (!ok)
+	{
+		ReadErrors++;
+		return false;
+	}
 
-		// Calculate the gyro value into actual degrees per second
-		// This depends on scale being set
-		WingSailAngleSensor->gx = (float)WingSailAngleSensor->gyroCount[0] * WingSailAngleSensor->gRes;
-		WingSailAngleSensor->gy = (float)WingSailAngleSensor->gyroCount[1] * WingSailAngleSensor->gRes;
-		WingSailAngleSensor->gz = (float)WingSailAngleSensor->gyroCount[2] * WingSailAngleSensor->gRes;
+	for (int i = 0; i < 3; i++)
+	{
+		WingSailAngleSensor->accelCount[i] = ((int16_t)raw[i * 2] << 8) | raw[i * 2 + 1];
+	}
+	WingSailAngleSensor->getAres();
 
-		WingSailAngleSensor->readMagData(WingSailAngleSensor->magCount);  // Read the x/y/z adc values
-		WingSailAngleSensor->getMres();
+	// Now we'll calculate the acceleration value into actual g's
+	// This depends on scale being set
+	WingSailAngleSensor->ax = (float)WingSailAngleSensor->accelCount[0] * WingSailAngleSensor->aRes; // - accelBias[0];
+	WingSailAngleSensor->ay = (float)WingSailAngleSensor->accelCount[1] * WingSailAngleSensor->aRes; // - accelBias[1];
+	WingSailAngleSensor->az = (float)WingSailAngleSensor->accelCount[2] * WingSailAngleSensor->aRes; // - accelBias[2];
 
-		// Calculate the magnetometer values in milliGauss
-		// Include factory calibration per data sheet and user environmental
-		// corrections
-		// Get actual magnetometer value, this depends on scale being set
-		WingSailAngleSensor->mx = (float)WingSailAngleSensor->magCount[0] * WingSailAngleSensor->mRes*WingSailAngleSensor->magCalibration[0] - WingSailAngleSensor->magbias[0];
-		WingSailAngleSensor->my = (float)WingSailAngleSensor->magCount[1] * WingSailAngleSensor->mRes*WingSailAngleSensor->magCalibration[1] - WingSailAngleSensor->magbias[1];
-		WingSailAngleSensor->mz = (float)WingSailAngleSensor->magCount[2] * WingSailAngleSensor->mRes*WingSailAngleSensor->magCalibration[2] - WingSailAngleSensor->magbias[2];
-	
-		float mx_cal = WingSailAngleSensor->mx / (Configuration.WingAngle_mXScale);
-		float my_cal = WingSailAngleSensor->my / (Configuration.WingAngle_mYScale);
-		
-		
-		MagneticBearing = atan2(my_cal, mx_cal) * RAD_TO_DEG; // swap to y over x to provide a 90 degree orientation
-
-		// simple Pitch and Roll calculation. No Yaw.
-		roll = atan2(WingSailAngleSensor->ax, WingSailAngleSensor->az)  * RAD_TO_DEG;
-		pitch = atan2(WingSailAngleSensor->ay, WingSailAngleSensor->az) * RAD_TO_DEG;
-
-	} // if (readByte(MPU9250_ADDRESS, INT_STATUS) & 0x01)
-
-	WingSailAngleSensor->tempCount = WingSailAngleSensor->readTempData();  // Read the adc values
-												// Temperature in degrees Centigrade
+	// simple Pitch and Roll calculation. No Yaw.
+	roll = atan2(WingSailAngleSensor->ax, WingSailAngleSensor->az)  * RAD_TO_DEG;
+	pitch = atan2(WingSailAngleSensor->ay, WingSailAngleSensor->az) * RAD_TO_DEG;
+
+	WingSailAngleSensor->tempCount = ((int16_t)raw[RawTemp] << 8) | raw[RawTemp + 1];
+	// Temperature in degrees Centigrade
 	temperature = ((float)WingSailAngleSensor->tempCount) / 333.87 + 21.0;
 
+	if (!WingSailAngleSensor->decodeMagRecord(raw + RawMag))
+	{
+		return false;
+	}
+	CalculateBearing();
+
+	// in FIFO mode the samples come from the FIFO, in order.
+	if (!Fifo)
+	{
+		AddSample(millis());
+	}
+	return true;
+}
+
+void  WindAngle_9250::CalculateBearing(void)
+{
+	// the bearing from the latest mx and my, and in calibration mode, extend the calibration limits.
+	// V1.0 17/10/2026 John Semmens
+	float mx_cal = WingSailAngleSensor->mx / (Configuration.WingAngle_mXScale);
+	float my_cal = WingSailAngleSensor->my / (Configuration.WingAngle_mYScale);
+
+	MagneticBearing = atan2(my_cal, mx_cal) * RAD_TO_DEG; // swap to y over x to provide a 90 degree orientation
+
 	if (WingSailAngleSensor->MagneticCompassCalibrationMode==true)
 			IMU_Mag_Calibrate();
 }
 
+void  WindAngle_9250::SetupTransaction(I2CTransactionType& t, uint8_t reg, uint16_t length, uint8_t* data)
+{
+	t.Device = Device;
+	t.Priority = WingAnglePriority;
+	t.TxLength = 1;
+	t.Tx[0] = reg;
+	t.RxLength = length;
+	t.Rx = data;
+	t.Deadline_us = WingAngleDeadline_us;
+	t.Done = TransactionDone;
+	t.Context = this;
+}
+
+void  WindAngle_9250::StartRead()
+{
+	// read the FIFO count, then from TransactionDone, that many records.
+	// V1.0 17/10/2026 John Semmens
+	if (!status || !Fifo || Device < 0 || Pending > 0)
+	{
+		// the last read hasn't finished. Collect counts it.
+		return;
+	}
+
+	ReadStarted = true;
+	ReadFailed = false;
+	SetupTransaction(CountTransaction, FIFO_COUNTH, 2, CountRaw);
+	SetupTransaction(DataTransaction, FIFO_R_W, 0, FifoRaw);
+
+	Pending = 1;
+	I2CQueue(&CountTransaction);
+}
+
+void  WindAngle_9250::TransactionDone(I2CTransactionType* t)
+{
+	// called from the I2C interrupt when a transaction of the read has finished.
+	// V1.0 17/10/2026 John Semmens
+	WindAngle_9250* sensor = (WindAngle_9250*)t->Context;
+
+	if (t->Result != I2CResultType::Ok)
+	{
+		sensor->ReadFailed = true;
+	}
+	else if (t == &sensor->CountTransaction)
+	{
+		// the newest record was measured within a sample period of now, or at the last data ready pulse.
+		sensor->Newest_us = (sensor->InterruptPin >= 0) ? DataReady_us[sensor->I2CPort] : micros();
+		sensor->FifoCount = (((uint16_t)sensor->CountRaw[0] << 8) | sensor->CountRaw[1]) & 0x1FFF;
+
+		if (sensor->FifoCount >= MPU9250::FifoSize)
+		{
+			// full, so records have been lost and the times of the rest aren't known. Empty it and start again.
+			sensor->FifoOverflows++;
+			sensor->FifoCount = 0;
+			sensor->SetupTransaction(sensor->ResetTransaction, USER_CTRL, 0, NULL);
+			sensor->ResetTransaction.TxLength = 2;
+			sensor->ResetTransaction.Tx[1] = 0x64;	// reset the FIFO, FIFO and I2C master still on
+			sensor->Pending++;
+			I2CQueue(&sensor->ResetTransaction);
+		}
+		else
+		{
+			// the oldest records first. Any more are left for the next read.
+			int records = min(sensor->FifoCount / MPU9250::MagRecordLength, WingAngleFifoBurst);
+			if (records > 0)
+			{
+				sensor->DataTransaction.RxLength = records * MPU9250::MagRecordLength;
+				sensor->Pending++;
+				I2CQueue(&sensor->DataTransaction);
+			}
+		}
+	}
+
+	sensor->Pending--;
+}
+
+bool  WindAngle_9250::Collect()
+{
+	// V1.0 17/10/2026 John Semmens
+	if (!ReadStarted)
+	{
+		return false;
+	}
+
+	if (Pending > 0)
+	{
+		// the previous read hasn't finished. Leave it to finish, and collect it next time.
+		ReadOverruns++;
+		return false;
+	}
+
+	ReadStarted = false;
+	if (ReadFailed)
+	{
+		ReadErrors++;
+		return false;
+	}
+	FifoReads++;
+
+	// the records are one sample period apart, and the last one read was (total - records) places before the newest.
+	int records = DataTransaction.RxLength / MPU9250::MagRecordLength;
+	int total = FifoCount / MPU9250::MagRecordLength;
+	unsigned long newest_ms = millis() - (micros() - Newest_us) / 1000;
+	bool added = false;
+
+	for (int i = 0; i < records; i++)
+	{
+		if (WingSailAngleSensor->decodeMagRecord(FifoRaw + i * MPU9250::MagRecordLength))
+		{
+			CalculateBearing();
+			AddSample(newest_ms - (total - 1 - i) * (WingAngleSamplePeriod_us / 1000));
+			added = true;
+		}
+	}
+	return added;
+}
+
+void  WindAngle_9250::AddSample(unsigned long time_ms)
+{
+	Samples[SampleNext].Time_ms = time_ms;
+	Samples[SampleNext].MagneticBearing = MagneticBearing;
+	SampleNext = (SampleNext + 1) % WingAngleSamples;
+	if (SampleCount < WingAngleSamples)
+	{
+		SampleCount++;
+	}
+}
+
+bool  WindAngle_9250::GetSample(int age, WingAngleSampleType& sample)
+{
+	// V1.0 17/10/2026 John Semmens
+	if (age < 0 || age >= SampleCount)
+	{
+		return false;
+	}
+	sample = Samples[(SampleNext - 1 - age + WingAngleSamples) % WingAngleSamples];
+	return true;
+}
+
 void  WindAngle_9250::Load_IMU_Calibation_Values()
 {
 	// load the config values relating to the IMU, into the IMU.
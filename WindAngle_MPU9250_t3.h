@@ -10,6 +10,18 @@
 #endif
 
 #include "MPU9250_t3.h"
+#include "I2CManager.h"
+
+// V1.1 17/10/2026 background FIFO reads with timestamped samples. John Semmens
+static const uint8_t WingAngleSampleRateDivider = 24;	// 1 kHz / (1 + 24) = 40 Hz, one sample each 25 ms
+static const uint32_t WingAngleSamplePeriod_us = 25000;
+static const int WingAngleSamples = 32;				// samples kept, 0.8 s at 40 Hz
+static const int WingAngleFifoBurst = 32;			// most records read in one transfer. 256 bytes, within the i2c_t3 buffer.
+
+struct WingAngleSampleType {
+	unsigned long Time_ms;		// millis() when the sample was measured
+	int MagneticBearing;
+};
 
 class WindAngle_9250
 {
@@ -24,8 +36,28 @@ public:
 	int MagneticBearing;
 	bool status;
 
-	void Init(uint8_t I2CPort);
-	void Read();
+	// fifo: read the samples in the background from the FIFO, with StartRead and Collect.
+	// Otherwise only Read, e.g. for a standby sensor checked now and then.
+	// interruptPin: the data ready pin, to timestamp the samples, or -1 if it isn't connected.
+	void Init(uint8_t I2CPort, int device, bool fifo, int interruptPin = -1);
+
+	// blocking read of the latest sample and the temperature, from the registers.
+	// Returns false on an I2C error or a magnetic sensor overflow.
+	bool Read();
+
+	// queue a background read of the FIFO with the I2C manager.
+	void StartRead();
+
+	// add the samples from the finished background read. Returns true if there are new samples.
+	bool Collect();
+
+	// the sample age places before the latest. Returns false if there isn't one.
+	bool GetSample(int age, WingAngleSampleType& sample);
+
+	unsigned long FifoReads;
+	unsigned long FifoOverflows;	// the FIFO filled, and was emptied
+	unsigned long ReadErrors;
+	unsigned long ReadOverruns;		// reads still in progress when Collect was called
 
 	void IMU_Mag_Init();
 	void IMU_Mag_Calibrate();
@@ -34,8 +66,28 @@ public:
 	void Load_IMU_Calibation_Values();
 
 private:
+	int Device;					// from I2CAddDevice
+	int InterruptPin;
+	bool Fifo;
 
+	WingAngleSampleType Samples[WingAngleSamples];
+	int SampleCount;
+	int SampleNext;
+	void AddSample(unsigned long time_ms);
 
+	I2CTransactionType CountTransaction;
+	I2CTransactionType DataTransaction;
+	I2CTransactionType ResetTransaction;
+	uint8_t CountRaw[2];
+	uint8_t FifoRaw[WingAngleFifoBurst * MPU9250::MagRecordLength];
+	uint16_t FifoCount;			// bytes in the FIFO when the read started
+	uint32_t Newest_us;			// micros() when the newest record in the FIFO was measured
+	volatile uint8_t Pending;
+	volatile bool ReadFailed;
+	bool ReadStarted;
+	static void TransactionDone(I2CTransactionType* t);
+	void SetupTransaction(I2CTransactionType& t, uint8_t reg, uint16_t length, uint8_t* data);
+	void CalculateBearing(void);
 };
 
 #endif //_WindAngle_mpu2950_t3_h
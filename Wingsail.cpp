@@ -12,8 +12,10 @@
 #include "WearTracking.h"
 #include "Mission.h"
 #include "HAL_WingAngle.h"
+#include "BluetoothConnection.h"
+#include "HAL_SDCard.h"
 
-extern HardwareSerial *Serials[];
+extern Stream *Serials[];
 
 extern configValuesType Configuration;		// stucture holding Configuration values; preset variables
 extern WingSailType WingSail;
@@ -24,9 +26,18 @@ extern WearCounter TrimTabUsage;
 extern MissionValuesStruct MissionValues;
 extern HALGPS gps;
 extern HALWingAngle WingAngleSensor;		// HAL WingSail Angle Sensor object
+extern BTStateType BTState;
 
 const uint16_t Deadband = 10; // us
 
+// Wingsail link. One request of each type can be outstanding.
+static WingSailLinkStatsType LinkStats[wlCommandCount];
+static bool RequestPending[wlCommandCount];
+static uint32_t RequestSentTime[wlCommandCount];	// ms. last transmission of the outstanding request.
+static int ServoAttempts;							// transmissions of the outstanding servo command
+static int PendingServo_us;							// the servo position sent, waiting to be acknowledged
+static uint32_t LastLinkActivity_ms;				// last command sent or response received
+
 void wingsail_init(void)
 {
 	// set to forward, at least until we have control over the state. 
@@ -201,9 +212,65 @@ int TrimTabAngle_to_us(int TrimTabAngle)
 	return ServoMicroSeconds;
 }
 
+static void WingSailSend(WingSailLinkCommandType cmd)
+{
+	// send a command to the wingsail.
+	// The wingsail needs prompting to wake up, and it misses characters, so the wakeup preamble is sent first,
+	// unless there has been a command or response recently enough that it is still awake.
+	// V1.0 17/10/2026 John Semmens
+	if (millis() - LastLinkActivity_ms > WingSailWakeIdle_ms)
+	{
+		(*Serials[Configuration.BluetoothPort]).println("wake");
+		(*Serials[Configuration.BluetoothPort]).println("wake");
+		(*Serials[Configuration.BluetoothPort]).println("");
+		(*Serials[Configuration.BluetoothPort]).println("");
+	}
+
+	switch (cmd)
+	{
+	case wlServo:
+		// the gsv response acknowledges the servo position.
+		PendingServo_us = WingSail.Servo_microseconds;
+		(*Serials[Configuration.BluetoothPort]).print("srv,");
+		(*Serials[Configuration.BluetoothPort]).println(PendingServo_us);
+		(*Serials[Configuration.BluetoothPort]).println("gsv");
+		WingSail.LastCommandTime = millis();
+		break;
+
+	case wlQuery:
+		(*Serials[Configuration.BluetoothPort]).println("gsv");
+		WingSail.LastRequestTime = millis();
+		break;
+
+	case wlPower:
+		(*Serials[Configuration.BluetoothPort]).println("pow");
+		break;
+
+	case wlVersion:
+		(*Serials[Configuration.BluetoothPort]).println("ver");
+		break;
+
+	default:;
+	}
+
+	LastLinkActivity_ms = millis();
+	RequestPending[cmd] = true;
+	RequestSentTime[cmd] = millis();
+	LinkStats[cmd].Sent++;
+}
+
+static void SendServoCommand(void)
+{
+	// send the current servo position, as a new command.
+	ServoAttempts = 1;
+	WingSailSend(wlServo);
+}
+
 void WingSailServo(int SailIn_us)
 {
 	// send the serial message to the Servo
+	// V1.1 17/10/2026 sent through the wingsail link. A new position while the previous one is still waiting to be
+	//					acknowledged is sent when the acknowledgement arrives, so several changes are coalesced into one command.
 	static uint16_t prev_SailIn_us;
 
 	if (abs(SailIn_us - prev_SailIn_us) >= Deadband)  
@@ -212,20 +279,16 @@ void WingSailServo(int SailIn_us)
 		WingSail.Servo_microseconds = SailIn_us;
 
 		// send message to Wingsail servo
-		//QueueMessage(TelMessageType::SetWing);
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("");
-		//(*Serials[Configuration.BluetoothPort]).print("srv,");
-		//(*Serials[Configuration.BluetoothPort]).println(WingSail.Servo_microseconds);
-		(*Serials[Configuration.BluetoothPort]).println("");
-		(*Serials[Configuration.BluetoothPort]).print("srv,");
-		(*Serials[Configuration.BluetoothPort]).println(WingSail.Servo_microseconds);
+		if (RequestPending[wlServo])
+		{
+			LinkStats[wlServo].Coalesced++;
+		}
+		else
+		{
+			SendServoCommand();
+		}
 
 		TrimTabUsage.TrackServoUsage(WingSail.Servo_microseconds);
-
-		// record the time of sending command
-		WingSail.LastCommandTime = millis();
 	}
 };
 
@@ -279,6 +342,8 @@ void CheckWingSailServo(void)
 {
 	// Check the wingsail in a separate thread. called every 5 seconds
 	// Query current position, and if it doesn't match the command position, then send another command
+	// V1.1 17/10/2026 the servo command is normally acknowledged within seconds by the wingsail link.
+	//					This is the check for when the link has given up, or the wingsail has since been reset.
 
 	WingSail.TimeSinceLastCommand = (millis() - WingSail.LastCommandTime) / 1000;
 	WingSail.TimeSinceLastRequest = (millis() - WingSail.LastRequestTime) / 1000;
@@ -286,35 +351,19 @@ void CheckWingSailServo(void)
 	WingSail.TimeSinceLastPowerReponse = (millis() - WingSail.LastPowerResponseTime) / 1000;
 
 	// if a command has been recently sent AND we haven't checked in the laat 60 seconds then check again
-	if (WingSail.TimeSinceLastCommand > 5 && WingSail.TimeSinceLastRequest > 60)
+	if (WingSail.TimeSinceLastCommand > 5 && WingSail.TimeSinceLastRequest > 60 && !RequestPending[wlQuery])
 	{
 		// send query to Wingsail servo
-		//QueueMessage(TelMessageType::GSV);
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("");
-		(*Serials[Configuration.BluetoothPort]).println("");
-		(*Serials[Configuration.BluetoothPort]).println("gsv");
-
-		// record the time of sending command
-		WingSail.LastRequestTime = millis();
+		WingSailSend(wlQuery);
 	}
 
 	// if we've recently had a response, AND the response doesn't match the command, AND its at least 60 seconds since last command
 	// then send another command
-	if (WingSail.TimeSinceLastReponse > 5 && WingSail.TimeSinceLastCommand > 60 && (WingSail.Servo_microseconds != WingSail.Servo_microseconds_reponse))
+	if (WingSail.TimeSinceLastReponse > 5 && WingSail.TimeSinceLastCommand > 60 && (WingSail.Servo_microseconds != WingSail.Servo_microseconds_reponse)
+		&& !RequestPending[wlServo])
 	{
 		// send message to Wingsail servo
-		//QueueMessage(TelMessageType::SetWing);
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("wake");
-		(*Serials[Configuration.BluetoothPort]).println("");
-		(*Serials[Configuration.BluetoothPort]).println("");
-		(*Serials[Configuration.BluetoothPort]).print("srv,");
-		(*Serials[Configuration.BluetoothPort]).println(WingSail.Servo_microseconds);
-
-		// record the time of sending command
-		WingSail.LastCommandTime = millis();
+		SendServoCommand();
 
 		SD_Logging_Event_Wingsail_Monitor("Corrrection");
 	}
@@ -323,18 +372,106 @@ void CheckWingSailServo(void)
 
 void CheckWingSailPower(void)
 {
-	(*Serials[Configuration.BluetoothPort]).println("wake");
-	(*Serials[Configuration.BluetoothPort]).println("wake");
-	(*Serials[Configuration.BluetoothPort]).println("");
-	(*Serials[Configuration.BluetoothPort]).println("");
-	(*Serials[Configuration.BluetoothPort]).println("pow");
+	WingSailSend(wlPower);
 }
 
 void CheckWingSailVersion(void)
 {
-	(*Serials[Configuration.BluetoothPort]).println("wake");
-	(*Serials[Configuration.BluetoothPort]).println("wake");
-	(*Serials[Configuration.BluetoothPort]).println("");
-	(*Serials[Configuration.BluetoothPort]).println("");
-	(*Serials[Configuration.BluetoothPort]).println("ver");
-}
\ No newline at end of file
+	WingSailSend(wlVersion);
+}
+
+static void RecordAck(WingSailLinkCommandType cmd, int attempts)
+{
+	// the request has been acknowledged.
+	// The round trip time is only recorded for requests sent once, as the response to a resent request
+	// could be to either transmission.
+	WingSailLinkStatsType& stats = LinkStats[cmd];
+	unsigned long rtt = millis() - RequestSentTime[cmd];
+
+	RequestPending[cmd] = false;
+	stats.Acks++;
+
+	if (attempts == 1)
+	{
+		if (stats.RTTCount == 0 || rtt < stats.MinRTT_ms)
+		{
+			stats.MinRTT_ms = rtt;
+		}
+		if (rtt > stats.MaxRTT_ms)
+		{
+			stats.MaxRTT_ms = rtt;
+		}
+		stats.TotalRTT_ms += rtt;
+		stats.RTTCount++;
+	}
+}
+
+void WingSailLinkResponse(WingSailLinkCommandType cmd)
+{
+	// a response has been received from the wingsail. Called from the Bluetooth response handlers.
+	// V1.0 17/10/2026 John Semmens
+	LastLinkActivity_ms = millis();
+
+	if (cmd == wlQuery && RequestPending[wlServo] && WingSail.Servo_microseconds_reponse == PendingServo_us)
+	{
+		RecordAck(wlServo, ServoAttempts);
+
+		// send the latest position, if it changed while waiting.
+		if (WingSail.Servo_microseconds != PendingServo_us)
+		{
+			SendServoCommand();
+		}
+	}
+
+	if (RequestPending[cmd])
+	{
+		RecordAck(cmd, 1);
+	}
+}
+
+void WingSailLinkUpdate(void)
+{
+	// resend the servo command if it has not been acknowledged in time, and time out the other requests.
+	// Called from the 200 ms loop.
+	// V1.0 17/10/2026 John Semmens
+	if (BTState != BTStateType::Connected)
+	{
+		// hold the requests until the connection is made.
+		return;
+	}
+
+	for (int cmd = 0; cmd < wlCommandCount; cmd++)
+	{
+		if (!RequestPending[cmd] || millis() - RequestSentTime[cmd] < WingSailAckTimeout_ms)
+		{
+			continue;
+		}
+
+		if (cmd == wlServo && ServoAttempts < WingSailMaxAttempts)
+		{
+			ServoAttempts++;
+			LinkStats[cmd].Retries++;
+			WingSailSend(wlServo);
+		}
+		else
+		{
+			RequestPending[cmd] = false;
+			LinkStats[cmd].Failures++;
+
+			if (cmd == wlServo)
+			{
+				SD_Logging_Event_Wingsail_Monitor("No Ack");
+			}
+		}
+	}
+}
+
+const WingSailLinkStatsType& WingSailLinkStats(WingSailLinkCommandType cmd)
+{
+	return LinkStats[cmd];
+}
+
+void WingSailLinkResetStats(void)
+{
+	memset(LinkStats, 0, sizeof(LinkStats));
+}
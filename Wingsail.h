@@ -50,6 +50,31 @@ struct WingSailType {
 	char VersionDate[30];
 };
 
+// Commands to the wingsail over Bluetooth, and the response that acknowledges each.
+enum WingSailLinkCommandType {
+	wlServo,		// srv, followed by gsv. Acknowledged by a gsv response with the commanded position.
+	wlQuery,		// gsv, acknowledged by the gsv response
+	wlPower,		// pow, acknowledged by the pow response
+	wlVersion,		// ver, acknowledged by the ver response
+	wlCommandCount
+};
+
+struct WingSailLinkStatsType {
+	unsigned long Sent;				// including retransmissions
+	unsigned long Retries;			// servo commands sent again after no acknowledgement
+	unsigned long Acks;
+	unsigned long Failures;			// no acknowledgement after the last attempt
+	unsigned long Coalesced;		// servo positions replaced by a newer position before being sent
+	unsigned long MinRTT_ms;		// round trip time, from acknowledgements of commands sent once
+	unsigned long MaxRTT_ms;
+	unsigned long TotalRTT_ms;
+	unsigned long RTTCount;
+};
+
+static const unsigned long WingSailAckTimeout_ms = 2000;	// resend the servo command if not acknowledged in this time
+static const int WingSailMaxAttempts = 4;					// servo command attempts before giving up until the next check
+static const unsigned long WingSailWakeIdle_ms = 5000;		// send the wakeup preamble if nothing has been sent or received for this long
+
 void wingsail_init(void);
 
 void wingsail_update(void);
@@ -71,5 +96,10 @@ void CheckWingSailServo(void);
 void CheckWingSailPower(void);
 void CheckWingSailVersion(void);
 
+void WingSailLinkUpdate(void);
+void WingSailLinkResponse(WingSailLinkCommandType cmd);
+const WingSailLinkStatsType& WingSailLinkStats(WingSailLinkCommandType cmd);
+void WingSailLinkResetStats(void);
+
 #endif
 
@@ -13,6 +13,10 @@
 // V1.9 11/12/2021 added UseGPSInitString
 // V1.10 4/2/2022 added support for different default config settings based on HardWare Config setting.
 // V1.11 22/7/2023 removed GPS power controls.
+// V1.12 17/10/2026 added SDCardLogBinary.
+// V1.13 17/10/2026 added TelemetryBinary.
+// V1.14 17/10/2026 added CompassOversampling.
+// V1.15 17/10/2026 added the compass ellipsoid calibration.
 
 #include "configValues.h"
 #include <EEPROM.h>
@@ -29,7 +33,7 @@ extern configValuesType Configuration;
 extern MissionCommand MissionList[MaxMissionCommands];
 extern MissionValuesStruct MissionValues;
 extern StateValuesStruct StateValues;
-extern HardwareSerial *Serials[];
+extern Stream *Serials[];
 extern NavigationDataType NavData;
 extern int HWConfigNumber;
 
@@ -172,6 +176,10 @@ void Load_Config_default_values(void)
 	// V1.9 21/2/2019 added TackingMethod
 	// V1.10 11/12/2021 added UseGPSInitString
 	// V1.11 4/2/2022 added support for different default config settings based on HardWare Config setting.
+	// V1.12 17/10/2026 added SDCardLogBinary.
+	// V1.13 17/10/2026 added TelemetryBinary.
+	// V1.14 17/10/2026 added CompassOversampling.
+	// V1.15 17/10/2026 added the compass ellipsoid calibration.
 
 	Configuration.TackingMethod = ManoeuvreType::mtGybe;
 	Configuration.MinimumAngleDownWind = 20; // degrees off dead downwind
@@ -193,6 +201,21 @@ void Load_Config_default_values(void)
 	Configuration.MagnetVariation = 12; // about 12 degrees East for Port Phillip
 
 	Configuration.MaxFileSize = 2048; //kb.  was 1024 kb 
+	Configuration.SDCardLogBinary = false;
+	Configuration.TelemetryBinary = false;
+	Configuration.CompassOversampling = false;
+
+	// no ellipsoid calibration until one is fitted and saved.
+	Configuration.CompassEllipsoid = false;
+	for (int i = 0; i < 9; i++)
+	{
+		Configuration.CompassSoftIron[i] = (i % 4 == 0) ? 1 : 0;
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		Configuration.CompassHardIron[i] = 0;
+	}
+	Configuration.CompassFitQuality = 0;
 
 	Configuration.Servo_Channel_Steering = 0;		// channel number
 	Configuration.Servo_Channel_Steering_Stbd = 1;	// channel number
@@ -13,7 +13,8 @@
 #include "CommandState_Processor.h"
 #include "HAL_GPS.h"
 
-static const int EEPROM_Storage_Version_Const = 7;   // change this number to force config to be cleared and revert to default.
+static const int EEPROM_Storage_Version_Const = 8;   // change this number to force config to be cleared and revert to default.
+// 8: 17/10/2026 SDCardLogBinary, TelemetryBinary, CompassOversampling and the compass ellipsoid calibration. One change for all four, so the config is cleared once.
 
 struct configValuesType {
 	byte EEPROM_Storage_Version = EEPROM_Storage_Version_Const; // stored object version. this is to test if the data being retrieve is valid with reference to this version. 
@@ -66,6 +67,13 @@ struct configValuesType {
 	short int CompassMaxZ;
 
 	int MaxFileSize; // Maximum file size for log files on the SD Card. // kbytes 1024 bytes.
+	bool SDCardLogBinary; // True: the 1 second log records are written in binary to a .bin file. False: text records in the .log file.
+	bool TelemetryBinary; // True: LNA, LAT, LPO and LWI telemetry is sent in binary frames (TelemetryFrame.h). False: text messages.
+	bool CompassOversampling; // True: compass accelerometer FIFO read at 200 Hz and filtered, see MagneticSensorLsm303::setOversampling. False: one sample per read.
+	bool CompassEllipsoid; // True: the heading uses the ellipsoid calibration below, and the cardinal corrections are not applied. False: min/max calibration.
+	float CompassSoftIron[9]; // ellipsoid calibration, saved from the fit with mgf,s. See MagCalibration.h.
+	float CompassHardIron[3];
+	float CompassFitQuality; // rms % of the saved fit, for reference.
 
 	int Servo_Channel_Steering; // channel steering and port steering channel in the case of dual rudder servos is true 
 	int Servo_Channel_Steering_Stbd; //  starboard sterering channel in the case of dual rudder servos is true 
@@ -0,0 +1,597 @@
+// Host (Linux) replacement for the Teensyduino core. See Arduino.h.
+// micros() wraps at 32 bits, as on the Teensy, so the tree's uint32_t times keep working on a 64 bit host.
+// An unsigned long duration measured across the wrap, once every 71 minutes, is wrong on the host, where
+// unsigned long is 64 bits.
+// V1.0 17/10/2026 John Semmens
+
+#include "Arduino.h"
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+static uint64_t Clock_us = 0;
+static float Speed = 0;				// 0 for as fast as possible
+static uint64_t PaceStart_us = 0;	// virtual time when the speed was set
+static uint64_t RealStart_ns = 0;
+
+static uint64_t RealTime_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void Pace(void)
+{
+	// hold the virtual clock to the set multiple of real time.
+	if (Speed <= 0)
+	{
+		return;
+	}
+	uint64_t due_ns = RealStart_ns + (uint64_t)((Clock_us - PaceStart_us) * 1000.0 / Speed);
+	uint64_t now_ns = RealTime_ns();
+	if (due_ns > now_ns)
+	{
+		struct timespec ts;
+		ts.tv_sec = (due_ns - now_ns) / 1000000000ULL;
+		ts.tv_nsec = (due_ns - now_ns) % 1000000000ULL;
+		nanosleep(&ts, NULL);
+	}
+}
+
+unsigned long millis(void)
+{
+	Clock_us++;
+	return (unsigned long)(uint32_t)(Clock_us / 1000);
+}
+
+unsigned long micros(void)
+{
+	Clock_us++;
+	return (unsigned long)(uint32_t)Clock_us;
+}
+
+void delay(unsigned long ms)
+{
+	Clock_us += (uint64_t)ms * 1000;
+	Pace();
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	Clock_us += us;
+}
+
+void yield(void)
+{
+}
+
+void SilIdleUntil(unsigned long wake_ms)
+{
+	// the scheduler has nothing due until wake_ms. Serial input is polled by the tasks, so nothing wakes it earlier.
+	long ahead_ms = (long)(uint32_t)(wake_ms - (uint32_t)(Clock_us / 1000));
+	if (ahead_ms > 0)
+	{
+		Clock_us += (uint64_t)ahead_ms * 1000 - Clock_us % 1000;
+	}
+	Pace();
+}
+
+void SilSetSpeed(float speed)
+{
+	Speed = speed;
+	PaceStart_us = Clock_us;
+	RealStart_ns = RealTime_ns();
+}
+
+uint64_t SilTime_us(void)
+{
+	return Clock_us;
+}
+
+// ===============================================
+// pins
+// ===============================================
+static uint8_t PinOutput[64];
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (pin < sizeof(PinOutput))
+	{
+		PinOutput[pin] = value;
+	}
+}
+
+int digitalRead(uint8_t pin)
+{
+	return HIGH;
+}
+
+int analogRead(uint8_t pin)
+{
+	return 0;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+}
+
+void analogReadResolution(unsigned int bits)
+{
+}
+
+void attachInterrupt(uint8_t pin, void (*function)(void), int mode)
+{
+}
+
+void detachInterrupt(uint8_t pin)
+{
+}
+
+long random(long howbig)
+{
+	if (howbig <= 0)
+	{
+		return 0;
+	}
+	return rand() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+	if (howsmall >= howbig)
+	{
+		return howsmall;
+	}
+	return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+	srand(seed);
+}
+
+char* dtostrf(double number, signed char width, unsigned char prec, char* s)
+{
+	sprintf(s, "%*.*f", width, prec, number);
+	return s;
+}
+
+volatile uint16_t WDOG_UNLOCK, WDOG_STCTRLH, WDOG_TOVALL, WDOG_TOVALH, WDOG_PRESC, WDOG_REFRESH;
+volatile uint32_t SilNVIC[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+
+// the RTC starts at the host time, and runs on the virtual clock.
+static unsigned long RTCBase = 0;
+static uint64_t RTCBase_us = 0;
+
+unsigned long teensy3_clock_class::get(void)
+{
+	if (RTCBase == 0)
+	{
+		RTCBase = time(NULL);
+		RTCBase_us = Clock_us;
+	}
+	return RTCBase + (Clock_us - RTCBase_us) / 1000000;
+}
+
+void teensy3_clock_class::set(unsigned long t)
+{
+	RTCBase = t;
+	RTCBase_us = Clock_us;
+}
+
+teensy3_clock_class Teensy3Clock;
+
+// ===============================================
+// String
+// ===============================================
+static std::string FormatNumber(unsigned long long value, unsigned char base)
+{
+	if (base < 2)
+	{
+		base = 10;
+	}
+	char buf[65];
+	char* p = buf + sizeof(buf) - 1;
+	*p = '\0';
+	do
+	{
+		int digit = value % base;
+		*--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		value /= base;
+	} while (value);
+	return std::string(p);
+}
+
+String::String(int value, unsigned char base) : Text(value < 0 && base == 10 ? "-" + FormatNumber(-(long long)value, base) : FormatNumber((unsigned int)value, base)) {}
+String::String(unsigned int value, unsigned char base) : Text(FormatNumber(value, base)) {}
+String::String(long value, unsigned char base) : Text(value < 0 && base == 10 ? "-" + FormatNumber(-(long long)value, base) : FormatNumber((unsigned long)value, base)) {}
+String::String(unsigned long value, unsigned char base) : Text(FormatNumber(value, base)) {}
+
+String::String(float value, unsigned char decimalPlaces)
+{
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+	Text = buf;
+}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+	Text = buf;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+	size_t i = Text.find(c, from);
+	return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String& s, unsigned int from) const
+{
+	size_t i = Text.find(s.Text, from);
+	return i == std::string::npos ? -1 : (int)i;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+	if (to > Text.length())
+	{
+		to = Text.length();
+	}
+	if (from > to)
+	{
+		unsigned int t = from;
+		from = to;
+		to = t;
+	}
+	return String(Text.substr(from, to - from));
+}
+
+void String::toCharArray(char* buf, unsigned int size, unsigned int index) const
+{
+	if (size == 0)
+	{
+		return;
+	}
+	strncpy(buf, index < Text.length() ? Text.c_str() + index : "", size - 1);
+	buf[size - 1] = '\0';
+}
+
+void String::trim(void)
+{
+	size_t first = Text.find_first_not_of(" \t\r\n");
+	size_t last = Text.find_last_not_of(" \t\r\n");
+	Text = (first == std::string::npos) ? "" : Text.substr(first, last - first + 1);
+}
+
+void String::replace(const String& find, const String& with)
+{
+	if (find.Text.empty())
+	{
+		return;
+	}
+	size_t i = 0;
+	while ((i = Text.find(find.Text, i)) != std::string::npos)
+	{
+		Text.replace(i, find.Text.length(), with.Text);
+		i += with.Text.length();
+	}
+}
+
+void String::toUpperCase(void)
+{
+	for (size_t i = 0; i < Text.length(); i++)
+	{
+		Text[i] = toupper(Text[i]);
+	}
+}
+
+void String::toLowerCase(void)
+{
+	for (size_t i = 0; i < Text.length(); i++)
+	{
+		Text[i] = tolower(Text[i]);
+	}
+}
+
+bool String::endsWith(const String& s) const
+{
+	return Text.length() >= s.Text.length() && Text.compare(Text.length() - s.Text.length(), s.Text.length(), s.Text) == 0;
+}
+
+// ===============================================
+// Print
+// ===============================================
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+	{
+		n += write(*buffer++);
+	}
+	return n;
+}
+
+size_t Print::printSigned(long long n, int base)
+{
+	if (n < 0 && base == DEC)
+	{
+		return print('-') + printNumber(-(unsigned long long)n, base);
+	}
+	return printNumber((unsigned long long)n, base);
+}
+
+size_t Print::printNumber(unsigned long long n, int base)
+{
+	return write(FormatNumber(n, base).c_str());
+}
+
+size_t Print::printFloat(double number, int digits)
+{
+	if (isnan(number))
+	{
+		return print("nan");
+	}
+	if (isinf(number))
+	{
+		return print("inf");
+	}
+	if (number > 4294967040.0 || number < -4294967040.0)
+	{
+		return print("ovf");
+	}
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%.*f", digits, number);
+	return write(buf);
+}
+
+int Print::printf(const char* format, ...)
+{
+	char buf[256];
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+	write(buf);
+	return n;
+}
+
+// ===============================================
+// Stream
+// ===============================================
+int Stream::timedRead(void)
+{
+	// input is polled, so there is no point waiting for more.
+	return read();
+}
+
+int Stream::timedPeek(void)
+{
+	return peek();
+}
+
+int Stream::peekNextDigit(bool fraction)
+{
+	while (true)
+	{
+		int c = timedPeek();
+		if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (fraction && c == '.'))
+		{
+			return c;
+		}
+		read();
+	}
+}
+
+long Stream::parseInt(void)
+{
+	bool negative = false;
+	long value = 0;
+	int c = peekNextDigit(false);
+	if (c < 0)
+	{
+		return 0;
+	}
+	do
+	{
+		if (c == '-')
+		{
+			negative = true;
+		}
+		else if (c >= '0' && c <= '9')
+		{
+			value = value * 10 + c - '0';
+		}
+		read();
+		c = timedPeek();
+	} while ((c >= '0' && c <= '9'));
+	return negative ? -value : value;
+}
+
+float Stream::parseFloat(void)
+{
+	bool negative = false;
+	bool fraction = false;
+	double value = 0;
+	double scale = 1;
+	int c = peekNextDigit(true);
+	if (c < 0)
+	{
+		return 0;
+	}
+	do
+	{
+		if (c == '-')
+		{
+			negative = true;
+		}
+		else if (c == '.')
+		{
+			fraction = true;
+		}
+		else if (c >= '0' && c <= '9')
+		{
+			value = value * 10 + c - '0';
+			if (fraction)
+			{
+				scale *= 10;
+			}
+		}
+		read();
+		c = timedPeek();
+	} while ((c >= '0' && c <= '9') || (c == '.' && !fraction));
+	value /= scale;
+	return negative ? -value : value;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length)
+{
+	size_t count = 0;
+	while (count < length)
+	{
+		int c = timedRead();
+		if (c < 0)
+		{
+			break;
+		}
+		*buffer++ = (char)c;
+		count++;
+	}
+	return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length)
+{
+	size_t count = 0;
+	while (count < length)
+	{
+		int c = timedRead();
+		if (c < 0 || c == terminator)
+		{
+			break;
+		}
+		*buffer++ = (char)c;
+		count++;
+	}
+	return count;
+}
+
+String Stream::readString(void)
+{
+	String s;
+	int c;
+	while ((c = timedRead()) >= 0)
+	{
+		s += (char)c;
+	}
+	return s;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+	String s;
+	int c;
+	while ((c = timedRead()) >= 0 && c != terminator)
+	{
+		s += (char)c;
+	}
+	return s;
+}
+
+bool Stream::find(const char* target)
+{
+	size_t matched = 0;
+	size_t length = strlen(target);
+	while (matched < length)
+	{
+		int c = timedRead();
+		if (c < 0)
+		{
+			return false;
+		}
+		matched = (c == target[matched]) ? matched + 1 : (c == target[0] ? 1 : 0);
+	}
+	return true;
+}
+
+// ===============================================
+// serial ports
+// ===============================================
+void HardwareSerial::connect(int in_fd, int out_fd)
+{
+	InFd = in_fd;
+	OutFd = out_fd;
+	if (InFd >= 0)
+	{
+		fcntl(InFd, F_SETFL, fcntl(InFd, F_GETFL) | O_NONBLOCK);
+	}
+}
+
+int HardwareSerial::peek(void)
+{
+	if (Peeked < 0 && InFd >= 0)
+	{
+		uint8_t c;
+		if (::read(InFd, &c, 1) == 1)
+		{
+			Peeked = c;
+		}
+	}
+	return Peeked;
+}
+
+int HardwareSerial::available(void)
+{
+	return peek() >= 0 ? 1 : 0;
+}
+
+int HardwareSerial::read(void)
+{
+	int c = peek();
+	Peeked = -1;
+	return c;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+	BytesWritten += size;
+	if (OutFd >= 0)
+	{
+		size_t done = 0;
+		while (done < size)
+		{
+			ssize_t n = ::write(OutFd, buffer + done, size - done);
+			if (n < 0 && errno != EINTR && errno != EAGAIN)
+			{
+				break;
+			}
+			if (n > 0)
+			{
+				done += n;
+			}
+		}
+	}
+	return size;
+}
+
+int HardwareSerial::availableForWrite(void)
+{
+	// the host port never holds the data back, so the transmit buffer is always empty.
+	return WriteBufferSize;
+}
+
+usb_serial_class Serial;
+HardwareSerial Serial1(1), Serial2(2), Serial3(3), Serial4(4), Serial5(5);
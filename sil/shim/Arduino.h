@@ -0,0 +1,296 @@
+// Arduino.h
+
+// Host (Linux) replacement for the Teensyduino core, for the software in the loop build. See sil/Makefile.
+// millis() and micros() run from a virtual clock. The clock is moved on by delay(), and by SchedulerIdle()
+// to the next task deadline, so the vessel runs as fast as the host can run the tasks.
+// Each call to the clock also moves it on by a microsecond, so loops waiting on the clock still finish.
+// Serial is the USB port, on stdin and stdout. Serial1 to Serial5 are connected to a file, pipe or pty
+// with the -p option, and discard their output otherwise.
+// The Teensy registers used by the tree (watchdog, NVIC) are plain variables.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_ARDUINO_h
+#define _SIL_ARDUINO_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+#include <string>
+
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F_CPU 180000000
+#define F_BUS 60000000
+
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define RISING 3
+#define FALLING 2
+#define CHANGE 4
+
+#define LED_BUILTIN 13
+#define PIN_A0 14
+#define PIN_A1 15
+#define PIN_A2 16
+#define PIN_A3 17
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// the Teensyduino core defines these as macros, and the tree uses them with mixed types.
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+// virtual clock
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+// SIL control of the virtual clock, see sil_main.cpp.
+void SilIdleUntil(unsigned long wake_ms);	// nothing is due until wake_ms, so move the clock on to it.
+void SilSetSpeed(float speed);				// 0 for as fast as possible, otherwise a multiple of real time.
+uint64_t SilTime_us(void);
+
+// pins. Outputs are remembered, inputs read high.
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void analogReadResolution(unsigned int bits);
+void attachInterrupt(uint8_t pin, void (*function)(void), int mode);
+void detachInterrupt(uint8_t pin);
+inline int digitalPinToInterrupt(int pin) { return pin; }
+
+// as in the Teensyduino core, these end with their own semicolon, and the tree relies on it.
+#define __enable_irq() __asm__ volatile("" ::: "memory");
+#define __disable_irq() __asm__ volatile("" ::: "memory");
+#define interrupts() __enable_irq()
+#define noInterrupts() __disable_irq()
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+char* dtostrf(double number, signed char width, unsigned char prec, char* s);
+
+// Teensy registers used by the tree.
+extern volatile uint16_t WDOG_UNLOCK, WDOG_STCTRLH, WDOG_TOVALL, WDOG_TOVALH, WDOG_PRESC, WDOG_REFRESH;
+#define WDOG_UNLOCK_SEQ1 0xC520
+#define WDOG_UNLOCK_SEQ2 0xD928
+
+enum IRQ_NUMBER_t { IRQ_I2C0 = 24, IRQ_I2C1 = 25, IRQ_I2C2 = 74 };
+extern volatile uint32_t SilNVIC[4];
+#define NVIC_ENABLE_IRQ(n) (SilNVIC[(n) >> 5] |= (1UL << ((n) & 31)))
+#define NVIC_DISABLE_IRQ(n) (SilNVIC[(n) >> 5] &= ~(1UL << ((n) & 31)))
+#define NVIC_IS_ENABLED(n) (SilNVIC[(n) >> 5] & (1UL << ((n) & 31)))
+
+class teensy3_clock_class
+{
+public:
+	static unsigned long get(void);
+	static void set(unsigned long t);
+	static void compensate(int adjust) {}
+};
+extern teensy3_clock_class Teensy3Clock;
+
+class String
+{
+public:
+	String(const char* s = "") : Text(s ? s : "") {}
+	String(const __FlashStringHelper* s) : Text((const char*)s) {}
+	String(const std::string& s) : Text(s) {}
+	String(char c) : Text(1, c) {}
+	String(int value, unsigned char base = 10);
+	String(unsigned int value, unsigned char base = 10);
+	String(long value, unsigned char base = 10);
+	String(unsigned long value, unsigned char base = 10);
+	String(float value, unsigned char decimalPlaces = 2);
+	String(double value, unsigned char decimalPlaces = 2);
+
+	const char* c_str(void) const { return Text.c_str(); }
+	unsigned int length(void) const { return Text.length(); }
+	char charAt(unsigned int index) const { return index < Text.length() ? Text[index] : 0; }
+	char operator[](unsigned int index) const { return charAt(index); }
+	int indexOf(char c, unsigned int from = 0) const;
+	int indexOf(const String& s, unsigned int from = 0) const;
+	String substring(unsigned int from, unsigned int to = 0xFFFFFFFF) const;
+	void toCharArray(char* buf, unsigned int size, unsigned int index = 0) const;
+	long toInt(void) const { return atol(Text.c_str()); }
+	float toFloat(void) const { return atof(Text.c_str()); }
+	void trim(void);
+	void replace(const String& find, const String& with);
+	void toUpperCase(void);
+	void toLowerCase(void);
+	bool startsWith(const String& s) const { return Text.compare(0, s.Text.length(), s.Text) == 0; }
+	bool endsWith(const String& s) const;
+	bool equals(const String& s) const { return Text == s.Text; }
+	bool operator==(const String& s) const { return Text == s.Text; }
+	bool operator==(const char* s) const { return Text == (s ? s : ""); }
+	bool operator!=(const String& s) const { return Text != s.Text; }
+	bool operator!=(const char* s) const { return Text != (s ? s : ""); }
+	String& operator+=(const String& s) { Text += s.Text; return *this; }
+	String& operator+=(const char* s) { Text += s ? s : ""; return *this; }
+	String& operator+=(char c) { Text += c; return *this; }
+	String& concat(const String& s) { Text += s.Text; return *this; }
+	friend String operator+(const String& a, const String& b) { return String(a.Text + b.Text); }
+	friend String operator+(const String& a, const char* b) { return String(a.Text + (b ? b : "")); }
+	friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.Text); }
+	friend String operator+(const String& a, char b) { return String(a.Text + b); }
+
+private:
+	std::string Text;
+};
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+	size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+	virtual int availableForWrite(void) { return 0; }
+	virtual void flush(void) {}
+
+	size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+	size_t print(const String& s) { return write(s.c_str()); }
+	size_t print(const char* s) { return write(s); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char n, int base = DEC) { return printNumber(n, base); }
+	size_t print(int n, int base = DEC) { return printSigned(n, base); }
+	size_t print(unsigned int n, int base = DEC) { return printNumber(n, base); }
+	size_t print(long n, int base = DEC) { return printSigned(n, base); }
+	size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+	size_t print(long long n, int base = DEC) { return printSigned(n, base); }
+	size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base); }
+	size_t print(double n, int digits = 2) { return printFloat(n, digits); }
+
+	size_t println(void) { return write((const uint8_t*)"\r\n", 2); }
+	template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+	template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+	int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+	size_t printSigned(long long n, int base);
+	size_t printNumber(unsigned long long n, int base);
+	size_t printFloat(double n, int digits);
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available(void) = 0;
+	virtual int read(void) = 0;
+	virtual int peek(void) = 0;
+	using Print::write;
+
+	void setTimeout(unsigned long timeout) { Timeout = timeout; }
+	long parseInt(void);
+	float parseFloat(void);
+	size_t readBytes(char* buffer, size_t length);
+	size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+	size_t readBytesUntil(char terminator, char* buffer, size_t length);
+	bool find(const char* target);
+	String readString(void);
+	String readStringUntil(char terminator);
+
+protected:
+	unsigned long Timeout = 1000;
+	int timedRead(void);
+	int timedPeek(void);
+	int peekNextDigit(bool fraction);
+};
+
+// a serial port. Connected to a file descriptor, or discarding its output if not connected.
+class HardwareSerial : public Stream
+{
+public:
+	HardwareSerial(int port) : Port(port) {}
+	void begin(uint32_t baud, uint32_t format = 0) { Baud = baud; }
+	void end(void) {}
+	void addMemoryForRead(void* buffer, size_t size) { ReadBufferSize += size; }
+	void addMemoryForWrite(void* buffer, size_t size) { WriteBufferSize += size; }
+	void clear(void) {}
+
+	virtual int available(void);
+	virtual int read(void);
+	virtual int peek(void);
+	virtual size_t write(uint8_t c);
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	using Print::write;
+	virtual int availableForWrite(void);
+	virtual void flush(void) {}
+	operator bool() { return true; }
+
+	void connect(int in_fd, int out_fd);
+
+	unsigned long BytesWritten = 0;
+
+private:
+	int Port;
+	int InFd = -1;
+	int OutFd = -1;
+	int Peeked = -1;
+	uint32_t Baud = 0;
+	size_t ReadBufferSize = 64;
+	size_t WriteBufferSize = 64;
+};
+
+// the USB serial port, on stdin and stdout.
+class usb_serial_class : public HardwareSerial
+{
+public:
+	usb_serial_class() : HardwareSerial(0) {}
+	void begin(long baud = 0) {}
+};
+
+extern usb_serial_class Serial;
+extern HardwareSerial Serial1, Serial2, Serial3, Serial4, Serial5;
+
+#endif
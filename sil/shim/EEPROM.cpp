@@ -0,0 +1,63 @@
+// Host replacement for the Teensy EEPROM. See EEPROM.h.
+// V1.0 17/10/2026 John Semmens
+
+#include "EEPROM.h"
+#include <unistd.h>
+#include <fcntl.h>
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::begin(const char* filename)
+{
+	Fd = open(filename, O_RDWR | O_CREAT, 0644);
+	Loaded = false;
+}
+
+void EEPROMClass::load(void)
+{
+	memset(Data, 0xFF, sizeof(Data));
+	if (Fd >= 0)
+	{
+		pread(Fd, Data, sizeof(Data), 0);
+	}
+	Loaded = true;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+	if (!Loaded)
+	{
+		load();
+	}
+	if (address < 0 || address >= SilEEPROMSize)
+	{
+		return 0xFF;
+	}
+	return Data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+	if (!Loaded)
+	{
+		load();
+	}
+	if (address < 0 || address >= SilEEPROMSize)
+	{
+		return;
+	}
+	Data[address] = value;
+
+	// written through, so a killed run keeps what it saved, as the EEPROM would.
+	if (Fd >= 0)
+	{
+		if (lseek(Fd, 0, SEEK_END) < SilEEPROMSize)
+		{
+			pwrite(Fd, Data, sizeof(Data), 0);
+		}
+		else
+		{
+			pwrite(Fd, &value, 1, address);
+		}
+	}
+}
@@ -0,0 +1,47 @@
+// EEPROM.h
+
+// Host replacement for the Teensy EEPROM, for the software in the loop build.
+// The 4096 bytes are kept in a file, so the configuration, mission and usage counters survive a restart
+// as they do on the boat. The file is set with EEPROM.begin, see sil_main.cpp. A new file reads as erased, 0xFF.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_EEPROM_h
+#define _SIL_EEPROM_h
+
+#include "Arduino.h"
+
+static const int SilEEPROMSize = 4096;	// Teensy 3.6
+
+class EEPROMClass
+{
+public:
+	void begin(const char* filename);
+	uint8_t read(int address);
+	void write(int address, uint8_t value);
+	void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+	int length(void) { return SilEEPROMSize; }
+
+	template <typename T> T& get(int address, T& value)
+	{
+		for (unsigned int i = 0; i < sizeof(T); i++)
+			((uint8_t*)&value)[i] = read(address + i);
+		return value;
+	}
+
+	template <typename T> const T& put(int address, const T& value)
+	{
+		for (unsigned int i = 0; i < sizeof(T); i++)
+			update(address + i, ((const uint8_t*)&value)[i]);
+		return value;
+	}
+
+private:
+	uint8_t Data[SilEEPROMSize];
+	bool Loaded = false;
+	int Fd = -1;
+	void load(void);
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
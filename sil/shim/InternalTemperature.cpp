@@ -0,0 +1,32 @@
+// Host replacement for the Teensy internal temperature sensor, for the software in the loop build.
+// Only the calls the tree makes. The temperature is a constant 25 C.
+// V1.0 17/10/2026 John Semmens
+
+#include "Arduino.h"
+#include "InternalTemperature.h"
+
+InternalTemperatureClass InternalTemperature;
+
+InternalTemperatureClass::InternalTemperatureClass()
+{
+}
+
+bool InternalTemperatureClass::begin(int temperature_settings_type)
+{
+	return true;
+}
+
+float InternalTemperatureClass::readTemperatureC(void)
+{
+	return 25.0;
+}
+
+float InternalTemperatureClass::readTemperatureF(void)
+{
+	return toFahrenheit(readTemperatureC());
+}
+
+float InternalTemperatureClass::toFahrenheit(float temperatureCelsius)
+{
+	return temperatureCelsius * 9.0 / 5.0 + 32.0;
+}
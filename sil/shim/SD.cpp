@@ -0,0 +1,194 @@
+// Host replacement for the Teensy SD library. See SD.h.
+// V1.0 17/10/2026 John Semmens
+
+#include "SD.h"
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SDClass SD;
+
+File::File(FILE* f, const char* name)
+{
+	State = std::make_shared<FileState>();
+	State->Handle = f;
+	strncpy(State->Name, name, sizeof(State->Name) - 1);
+	State->Name[sizeof(State->Name) - 1] = '\0';
+}
+
+size_t File::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size)
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	return fwrite(buf, 1, size, State->Handle);
+}
+
+int File::read(void)
+{
+	if (!*this)
+	{
+		return -1;
+	}
+	return fgetc(State->Handle);
+}
+
+int File::peek(void)
+{
+	if (!*this)
+	{
+		return -1;
+	}
+	int c = fgetc(State->Handle);
+	if (c >= 0)
+	{
+		ungetc(c, State->Handle);
+	}
+	return c;
+}
+
+int File::available(void)
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	uint32_t remaining = size() - position();
+	return remaining > 0x7FFFFFFF ? 0x7FFFFFFF : (int)remaining;
+}
+
+void File::flush(void)
+{
+	if (*this)
+	{
+		fflush(State->Handle);
+	}
+}
+
+int File::read(void* buf, uint16_t nbyte)
+{
+	if (!*this)
+	{
+		return -1;
+	}
+	return fread(buf, 1, nbyte, State->Handle);
+}
+
+bool File::seek(uint32_t pos)
+{
+	return *this && fseek(State->Handle, pos, SEEK_SET) == 0;
+}
+
+uint32_t File::position(void)
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	return ftell(State->Handle);
+}
+
+uint32_t File::size(void)
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	fflush(State->Handle);
+	struct stat st;
+	return fstat(fileno(State->Handle), &st) == 0 ? st.st_size : 0;
+}
+
+void File::close(void)
+{
+	State.reset();
+}
+
+File::operator bool()
+{
+	return State && State->Handle;
+}
+
+char* File::name(void)
+{
+	return State ? State->Name : (char*)"";
+}
+
+bool SDClass::begin(uint8_t csPin)
+{
+	// the card is present if its directory exists, or can be made.
+	::mkdir(Directory, 0755);
+	struct stat st;
+	return stat(Directory, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+void SDClass::setDirectory(const char* path)
+{
+	strncpy(Directory, path, sizeof(Directory) - 1);
+	Directory[sizeof(Directory) - 1] = '\0';
+}
+
+bool SDClass::Path(const char* filename, char* path, size_t size)
+{
+	// the host path of a file on the card, matching an existing file without regard to case.
+	// returns true if the file exists.
+	while (*filename == '/')
+	{
+		filename++;
+	}
+
+	DIR* dir = opendir(Directory);
+	if (dir)
+	{
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != NULL)
+		{
+			if (strcasecmp(entry->d_name, filename) == 0)
+			{
+				snprintf(path, size, "%s/%s", Directory, entry->d_name);
+				closedir(dir);
+				return true;
+			}
+		}
+		closedir(dir);
+	}
+	snprintf(path, size, "%s/%s", Directory, filename);
+	return false;
+}
+
+File SDClass::open(const char* filename, uint8_t mode)
+{
+	// FILE_WRITE creates the file, and appends to it. It can also be read and seeked, as on the card.
+	char path[512];
+	bool found = Path(filename, path, sizeof(path));
+	if (!found && mode != FILE_WRITE)
+	{
+		return File();
+	}
+
+	FILE* f = fopen(path, mode == FILE_WRITE ? "a+b" : "rb");
+	if (!f)
+	{
+		return File();
+	}
+	return File(f, filename);
+}
+
+bool SDClass::exists(const char* filename)
+{
+	char path[512];
+	return Path(filename, path, sizeof(path));
+}
+
+bool SDClass::remove(const char* filename)
+{
+	char path[512];
+	return Path(filename, path, sizeof(path)) && unlink(path) == 0;
+}
@@ -0,0 +1,78 @@
+// SD.h
+
+// Host replacement for the Teensy SD library, for the software in the loop build.
+// The card is a directory on the host, set with SD.setDirectory, see sil_main.cpp. File names are matched
+// without regard to case, as on the FAT card. Only the root directory is used by the tree.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_SD_h
+#define _SIL_SD_h
+
+#include "Arduino.h"
+#include <memory>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+#define O_RDONLY 0
+#define BUILTIN_SDCARD 254
+
+#define FAT_DATE(year, month, day) (uint16_t)(((year) - 1980) << 9 | (month) << 5 | (day))
+#define FAT_TIME(hour, minute, second) (uint16_t)((hour) << 11 | (minute) << 5 | (second) >> 1)
+
+class File : public Stream
+{
+public:
+	File(void) {}
+	File(FILE* f, const char* name);
+
+	virtual size_t write(uint8_t c);
+	virtual size_t write(const uint8_t* buf, size_t size);
+	using Print::write;
+	virtual int read(void);
+	virtual int peek(void);
+	virtual int available(void);
+	virtual void flush(void);
+	int read(void* buf, uint16_t nbyte);
+	bool seek(uint32_t pos);
+	uint32_t position(void);
+	uint32_t size(void);
+	void close(void);
+	operator bool();
+	char* name(void);
+	bool isDirectory(void) { return false; }
+
+private:
+	struct FileState
+	{
+		FILE* Handle;
+		char Name[13];
+		~FileState() { if (Handle) fclose(Handle); }
+	};
+	std::shared_ptr<FileState> State;	// copies of a File share the open file, as in the SD library.
+};
+
+class SDClass
+{
+public:
+	bool begin(uint8_t csPin = BUILTIN_SDCARD);
+	File open(const char* filename, uint8_t mode = FILE_READ);
+	bool exists(const char* filename);
+	bool remove(const char* filename);
+	bool mkdir(const char* filename) { return false; }
+
+	void setDirectory(const char* path);
+
+private:
+	char Directory[256] = "sd";
+	bool Path(const char* filename, char* path, size_t size);
+};
+
+extern SDClass SD;
+
+class SdFile
+{
+public:
+	static void dateTimeCallback(void (*dateTime)(uint16_t* date, uint16_t* time)) {}
+};
+
+#endif
@@ -0,0 +1,6 @@
+// Host replacement for the SPI library. See SPI.h.
+// V1.0 17/10/2026 John Semmens
+
+#include "SPI.h"
+
+SPIClass SPI;
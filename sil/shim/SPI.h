@@ -0,0 +1,42 @@
+// SPI.h
+
+// Host replacement for the SPI library, for the software in the loop build. Nothing is connected.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_SPI_h
+#define _SIL_SPI_h
+
+#include "Arduino.h"
+
+#define SPI_HAS_TRANSACTION 1
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+#define SPI_CLOCK_DIV4 0x00
+
+class SPISettings
+{
+public:
+	SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+	SPISettings(void) {}
+};
+
+class SPIClass
+{
+public:
+	void begin(void) {}
+	void end(void) {}
+	void beginTransaction(SPISettings settings) {}
+	void endTransaction(void) {}
+	uint8_t transfer(uint8_t data) { return 0xFF; }
+	void setClockDivider(uint8_t divider) {}
+	void setBitOrder(uint8_t order) {}
+	void setDataMode(uint8_t mode) {}
+};
+
+extern SPIClass SPI;
+
+#endif
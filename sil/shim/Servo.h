@@ -0,0 +1,29 @@
+// Servo.h
+
+// Host replacement for the Servo library, for the software in the loop build.
+// The pulse width is only remembered. The simulated vessel takes the rudder from the steering output.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_SERVO_h
+#define _SIL_SERVO_h
+
+#include "Arduino.h"
+
+class Servo
+{
+public:
+	uint8_t attach(int pin) { Pin = pin; return 0; }
+	uint8_t attach(int pin, int min, int max) { Pin = pin; return 0; }
+	void detach(void) { Pin = -1; }
+	void write(int value) { PulseWidth = value < 200 ? 544 + value * (2400 - 544) / 180 : value; }
+	void writeMicroseconds(int value) { PulseWidth = value; }
+	int read(void) { return (PulseWidth - 544) * 180 / (2400 - 544); }
+	int readMicroseconds(void) { return PulseWidth; }
+	bool attached(void) { return Pin >= 0; }
+
+private:
+	int Pin = -1;
+	int PulseWidth = 1500;
+};
+
+#endif
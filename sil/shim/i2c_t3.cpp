@@ -0,0 +1,57 @@
+// Host replacement for the Teensy 3 I2C library. See i2c_t3.h.
+// V1.0 17/10/2026 John Semmens
+
+#include "i2c_t3.h"
+
+uint8_t i2c_t3::TxAddress[I2C_BUS_NUM];
+i2c_status i2c_t3::Status[I2C_BUS_NUM];
+uint32_t i2c_t3::ErrorCount[I2C_BUS_NUM][I2C_ERRCNT_DMA_ERR + 1];
+void (*i2c_t3::TransmitDone[I2C_BUS_NUM])(void);
+void (*i2c_t3::RequestDone[I2C_BUS_NUM])(void);
+void (*i2c_t3::Error[I2C_BUS_NUM])(void);
+
+i2c_t3 Wire(0);
+i2c_t3 Wire1(1);
+i2c_t3 Wire2(2);
+
+void i2c_t3::Nak(void)
+{
+	Status[Bus] = I2C_ADDR_NAK;
+	ErrorCount[Bus][I2C_ERRCNT_ADDR_NAK]++;
+}
+
+uint8_t i2c_t3::endTransmission(i2c_stop sendStop, uint32_t timeout)
+{
+	Nak();
+	return 2; // address NAK, as Wire returns it
+}
+
+void i2c_t3::sendTransmission(i2c_stop sendStop)
+{
+	Nak();
+	if (Error[Bus])
+	{
+		Error[Bus]();
+	}
+}
+
+size_t i2c_t3::requestFrom(uint8_t address, size_t length, i2c_stop sendStop, uint32_t timeout)
+{
+	Nak();
+	return 0;
+}
+
+void i2c_t3::sendRequest(uint8_t address, size_t length, i2c_stop sendStop)
+{
+	Nak();
+	if (Error[Bus])
+	{
+		Error[Bus]();
+	}
+}
+
+void i2c_t3::I2Cscan(void)
+{
+	Serial.println("Scanning...");
+	Serial.println("No I2C devices found\n");
+}
@@ -0,0 +1,100 @@
+// i2c_t3.h
+
+// Host replacement for the Teensy 3 I2C library, for the software in the loop build.
+// The buses have no devices on them. Every transfer ends with the address not acknowledged, at once,
+// so the drivers find their sensors missing, and the navigation runs from the simulated vessel.
+// Background transfers call their error callback before returning, as a NAK from the bus interrupt would.
+// The bus state is kept per bus number, as in the library, so a temporary i2c_t3(bus) works on the same bus.
+// V1.0 17/10/2026 John Semmens
+
+#ifndef _SIL_I2C_T3_h
+#define _SIL_I2C_T3_h
+
+#include "Arduino.h"
+
+#define I2C_TX_BUFFER_LENGTH 259
+#define I2C_RX_BUFFER_LENGTH 259
+#define I2C_BUS_NUM 3
+
+enum i2c_mode { I2C_MASTER, I2C_SLAVE };
+enum i2c_pins { I2C_PINS_3_4, I2C_PINS_7_8, I2C_PINS_16_17, I2C_PINS_18_19, I2C_PINS_26_31, I2C_PINS_29_30,
+	I2C_PINS_33_34, I2C_PINS_37_38, I2C_PINS_47_48, I2C_PINS_56_57, I2C_PINS_DEFAULT };
+enum i2c_pullup { I2C_PULLUP_EXT, I2C_PULLUP_INT };
+enum i2c_rate { I2C_RATE_100 = 100000, I2C_RATE_200 = 200000, I2C_RATE_300 = 300000, I2C_RATE_400 = 400000,
+	I2C_RATE_600 = 600000, I2C_RATE_800 = 800000, I2C_RATE_1000 = 1000000 };
+enum i2c_op_mode { I2C_OP_MODE_IMM, I2C_OP_MODE_ISR, I2C_OP_MODE_DMA };
+enum i2c_stop { I2C_NOSTOP, I2C_STOP };
+enum i2c_status { I2C_WAITING, I2C_TIMEOUT, I2C_ADDR_NAK, I2C_DATA_NAK, I2C_ARB_LOST, I2C_BUF_OVF, I2C_NOT_ACQ,
+	I2C_DMA_ERR, I2C_SENDING, I2C_SEND_ADDR, I2C_RECEIVING, I2C_SLAVE_TX, I2C_SLAVE_RX };
+enum i2c_err_count { I2C_ERRCNT_RESET_BUS, I2C_ERRCNT_TIMEOUT, I2C_ERRCNT_ADDR_NAK, I2C_ERRCNT_DATA_NAK,
+	I2C_ERRCNT_ARBL, I2C_ERRCNT_NOT_ACQ, I2C_ERRCNT_DMA_ERR };
+
+class i2c_t3 : public Stream
+{
+public:
+	i2c_t3(uint8_t bus) : Bus(bus < I2C_BUS_NUM ? bus : 0) {}
+
+	void begin(void) {}
+	void begin(int address) {}
+	void begin(i2c_mode mode, uint8_t address, i2c_pins pins, i2c_pullup pullup, uint32_t rate, i2c_op_mode opMode = I2C_OP_MODE_ISR) {}
+	void setClock(uint32_t rate) {}
+	void setRate(uint32_t busFreq, uint32_t rate) {}
+	void setOpMode(i2c_op_mode opMode) {}
+	void setDefaultTimeout(uint32_t timeout) {}
+	void resetBus(void) { ErrorCount[Bus][I2C_ERRCNT_RESET_BUS]++; }
+
+	void beginTransmission(uint8_t address) { TxAddress[Bus] = address; }
+	void beginTransmission(int address) { TxAddress[Bus] = address; }
+	uint8_t endTransmission(void) { return endTransmission(I2C_STOP); }
+	uint8_t endTransmission(uint8_t sendStop) { return endTransmission(sendStop ? I2C_STOP : I2C_NOSTOP); }
+	uint8_t endTransmission(i2c_stop sendStop, uint32_t timeout = 0);
+	void sendTransmission(i2c_stop sendStop = I2C_STOP);
+
+	size_t requestFrom(uint8_t address, size_t length) { return requestFrom(address, length, I2C_STOP); }
+	size_t requestFrom(int address, int length) { return requestFrom((uint8_t)address, (size_t)length, I2C_STOP); }
+	size_t requestFrom(uint8_t address, size_t length, i2c_stop sendStop, uint32_t timeout = 0);
+	void sendRequest(uint8_t address, size_t length, i2c_stop sendStop = I2C_STOP);
+
+	uint8_t finish(uint32_t timeout = 0) { return 0; }
+	uint8_t done(void) { return 1; }
+	i2c_status status(void) { return Status[Bus]; }
+	uint8_t getError(void) { return Status[Bus] == I2C_ADDR_NAK ? 2 : 4; }
+
+	virtual size_t write(uint8_t data) { return 1; }
+	virtual size_t write(const uint8_t* data, size_t quantity) { return quantity; }
+	size_t write(int data) { return 1; }
+	using Print::write;
+	size_t send(uint8_t data) { return write(data); }
+
+	virtual int available(void) { return 0; }
+	virtual int read(void) { return -1; }
+	size_t read(uint8_t* data, size_t count) { return 0; }
+	virtual int peek(void) { return -1; }
+	uint8_t receive(void) { return 0; }
+
+	uint32_t getErrorCount(i2c_err_count counter) { return ErrorCount[Bus][counter]; }
+	void zeroErrorCount(i2c_err_count counter) { ErrorCount[Bus][counter] = 0; }
+
+	void onTransmitDone(void (*function)(void)) { TransmitDone[Bus] = function; }
+	void onReqFromDone(void (*function)(void)) { RequestDone[Bus] = function; }
+	void onError(void (*function)(void)) { Error[Bus] = function; }
+
+	void I2Cscan(void);
+
+private:
+	uint8_t Bus;
+	void Nak(void);
+
+	static uint8_t TxAddress[I2C_BUS_NUM];
+	static i2c_status Status[I2C_BUS_NUM];
+	static uint32_t ErrorCount[I2C_BUS_NUM][I2C_ERRCNT_DMA_ERR + 1];
+	static void (*TransmitDone[I2C_BUS_NUM])(void);
+	static void (*RequestDone[I2C_BUS_NUM])(void);
+	static void (*Error[I2C_BUS_NUM])(void);
+};
+
+extern i2c_t3 Wire;
+extern i2c_t3 Wire1;
+extern i2c_t3 Wire2;
+
+#endif
@@ -0,0 +1,118 @@
+// Software in the loop (SIL) host program for VoyagerOS3. See Makefile.
+// Runs setup() and loop() of the autopilot on a Linux host, on a virtual clock. When the scheduler has nothing due,
+// the clock is moved on to the next deadline, so a mission runs as fast as the host can run the tasks,
+// thousands of times faster than real time, or at a set multiple of real time with -s.
+// The USB serial port is stdin and stdout, so the command line (CLI) commands can be piped in, e.g. lcs, mis, mcr.
+// The SD card is a directory, and the EEPROM a file, so the log files and the configuration are kept between runs.
+// There are no I2C devices. The simulated vessel (lcs) provides the position, heading and wind.
+//
+// usage: voyager_sil [-t seconds] [-s speed] [-d sd directory] [-e eeprom file] [-p port=path] ...
+//	-t	virtual seconds to run for. 0, the default, runs until stopped.
+//	-s	multiple of real time. 0, the default, runs as fast as possible.
+//	-d	directory used as the SD card. Default sd.
+//	-e	file used as the EEPROM. Default eeprom.bin.
+//	-p	connect serial port 1 to 5 to a file, pipe or pty, e.g. -p 1=telemetry.txt for the LoRa port.
+// V1.0 17/10/2026 John Semmens
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "SD.h"
+#include "HAL_SDLogWriter.h"
+#include <unistd.h>
+#include <fcntl.h>
+
+void setup(void);
+void loop(void);
+
+extern HALSDLogWriter LogFile;
+extern HALSDLogWriter LogBinaryFile;
+extern HALSDLogWriter FlightRecorderFile;
+extern HALSDLogWriter CompassBenchFile;
+
+static HardwareSerial* const Ports[] = { &Serial, &Serial1, &Serial2, &Serial3, &Serial4, &Serial5 };
+
+static void Usage(void)
+{
+	fprintf(stderr, "usage: voyager_sil [-t seconds] [-s speed] [-d sd directory] [-e eeprom file] [-p port=path] ...\n");
+	exit(2);
+}
+
+static void ConnectPort(const char* option)
+{
+	// port=path. The path is opened for reading and writing, e.g. a pty or fifo, or else created for writing.
+	int port = atoi(option);
+	const char* path = strchr(option, '=');
+	if (port < 1 || port > 5 || path == NULL)
+	{
+		Usage();
+	}
+	path++;
+
+	int fd = open(path, O_RDWR | O_NONBLOCK);
+	if (fd >= 0)
+	{
+		Ports[port]->connect(fd, fd);
+		return;
+	}
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		perror(path);
+		exit(1);
+	}
+	Ports[port]->connect(-1, fd);
+}
+
+static void FlushLogWriter(HALSDLogWriter& writer)
+{
+	// write out what the SDWr task hasn't yet.
+	writer.flush();
+	while (writer.QueueDepth() > 0)
+	{
+		writer.drain();
+	}
+	writer.drain();
+	writer.drain();
+}
+
+int main(int argc, char* argv[])
+{
+	// V1.0 17/10/2026 John Semmens
+	double run_s = 0;
+	float speed = 0;
+	const char* sd = "sd";
+	const char* eeprom = "eeprom.bin";
+
+	int opt;
+	while ((opt = getopt(argc, argv, "t:s:d:e:p:")) != -1)
+	{
+		switch (opt)
+		{
+		case 't': run_s = atof(optarg); break;
+		case 's': speed = atof(optarg); break;
+		case 'd': sd = optarg; break;
+		case 'e': eeprom = optarg; break;
+		case 'p': ConnectPort(optarg); break;
+		default: Usage();
+		}
+	}
+
+	Serial.connect(STDIN_FILENO, STDOUT_FILENO);
+	EEPROM.begin(eeprom);
+	SD.setDirectory(sd);
+	SilSetSpeed(speed);
+
+	setup();
+
+	uint64_t end_us = SilTime_us() + (uint64_t)(run_s * 1000000);
+	while (run_s <= 0 || SilTime_us() < end_us)
+	{
+		loop();
+	}
+
+	FlushLogWriter(LogFile);
+	FlushLogWriter(LogBinaryFile);
+	FlushLogWriter(FlightRecorderFile);
+	FlushLogWriter(CompassBenchFile);
+	return 0;
+}
@@ -0,0 +1,279 @@
+// Host test of SchedulerCooperative. See Makefile, make test.
+// The scheduler is driven from a fake clock, set with SchedulerSetClock(). Each task moves the clock on by its run time,
+// so the effect of a slow task on the others can be checked exactly.
+// The clock functions of the Arduino core are defined here, in place of shim/Arduino.cpp, and so is the WFI step of
+// SchedulerIdle(), SilIdleUntil().
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 added the idle tests.
+
+#include "Arduino.h"
+#include "SchedulerCooperative.h"
+
+static unsigned long FakeTime_us = 0;
+static int Failures = 0;
+
+unsigned long millis(void)
+{
+	return FakeTime_us / 1000;
+}
+
+unsigned long micros(void)
+{
+	return FakeTime_us;
+}
+
+static unsigned long FakeMillis(void)
+{
+	return FakeTime_us / 1000;
+}
+
+// the WFI step. Either the processor wakes at the next 1 ms SysTick, as on the Teensy,
+// or the clock moves on to the deadline, as in the SIL build.
+static bool IdleToDeadline = false;
+static unsigned long IdleCalls;
+static unsigned long IdleWhenDue;		// calls to the WFI step when a task was already due
+
+void SilIdleUntil(unsigned long wake_ms)
+{
+	IdleCalls++;
+	if ((long)(wake_ms - FakeMillis()) <= 0)
+	{
+		IdleWhenDue++;
+		return;
+	}
+
+	if (IdleToDeadline)
+	{
+		FakeTime_us = wake_ms * 1000;
+	}
+	else
+	{
+		FakeTime_us = (FakeTime_us / 1000 + 1) * 1000;
+	}
+}
+
+static void Check(bool ok, const char* test, const char* what, unsigned long value)
+{
+	if (!ok)
+	{
+		printf("FAIL %s: %s (%lu)\n", test, what, value);
+		Failures++;
+	}
+}
+
+// ===============================================
+// tasks
+// ===============================================
+static const int FastTask = 0;
+static const int SlowTask = 1;
+static const unsigned long FastInterval_ms = 25;	// the FastLoop interval
+static const unsigned long SlowInterval_ms = 100;
+
+static unsigned long SlowRun_ms = 60;				// run time of the slow task, normally
+static unsigned long SlowLongRun = 0;				// the slow task run number that takes SlowLongRun_ms, or 0 for none
+static unsigned long SlowLongRun_ms = 250;
+static unsigned long SlowRuns;
+
+static unsigned long FastLateStarts;				// runs of the fast task that didn't start on its 25 ms phase
+static bool FastPhaseLost;
+
+static void FastAction(void*)
+{
+	// the fast task takes no time, and records whether it started and stayed on its phase.
+	if (FakeMillis() % FastInterval_ms != 0)
+	{
+		FastLateStarts++;
+	}
+
+	const SchedulerTaskType* task = SchedulerGetTask(FastTask);
+	if (task->next_run_ms % FastInterval_ms != 0 || (long)(task->next_run_ms - FakeMillis()) <= 0)
+	{
+		FastPhaseLost = true;
+	}
+}
+
+static void SlowAction(void*)
+{
+	SlowRuns++;
+	FakeTime_us += (SlowRuns == SlowLongRun ? SlowLongRun_ms : SlowRun_ms) * 1000;
+}
+
+static void Start(void)
+{
+	FakeTime_us = 0;
+	IdleCalls = 0;
+	IdleWhenDue = 0;
+	SlowRuns = 0;
+	FastLateStarts = 0;
+	FastPhaseLost = false;
+
+	SchedulerSetClock(FakeMillis);
+	SchedulerInit();
+	SchedulerAddTask(FastTask, &FastAction, FastInterval_ms, 0, "Fast");
+	SchedulerAddTask(SlowTask, &SlowAction, SlowInterval_ms, 4, "Slow");
+}
+
+static void RunUntil(unsigned long end_ms, bool idle)
+{
+	// the LOOP. With idle off it spins, 100 us a pass.
+	SchedulerSetIdle(idle);
+	while (FakeMillis() < end_ms)
+	{
+		if (!SchedulerRun())
+		{
+			SchedulerIdle();
+			if (!idle)
+			{
+				FakeTime_us += 100;
+			}
+		}
+	}
+}
+
+static void CheckDeadlinesAccounted(const char* test, int TaskIndex)
+{
+	// every deadline before the next one is either run, or counted as missed.
+	const SchedulerTaskType* task = SchedulerGetTask(TaskIndex);
+	Check(task->RunCount + task->MissedDeadlines == task->next_run_ms / task->interval_ms, test, "runs + missed deadlines", task->RunCount + task->MissedDeadlines);
+}
+
+// ===============================================
+// tests
+// ===============================================
+static void TestFastPhaseWithSlowTask(void)
+{
+	// the slow task takes 60 ms of each 100. The fast task is held up past its 25 ms deadline each time,
+	// runs once when the slow task returns, skips the deadline it also missed, and is back on its phase after.
+	const char* test = "FastPhaseWithSlowTask";
+	Start();
+	RunUntil(1000, false);
+
+	const SchedulerTaskType* fast = SchedulerGetTask(FastTask);
+	Check(!FastPhaseLost, test, "fast task off its 25 ms phase", fast->next_run_ms);
+	Check(SlowRuns == 10, test, "slow task runs", SlowRuns);
+	Check(FastLateStarts == 10, test, "fast task late starts", FastLateStarts);
+	Check(fast->MissedDeadlines == 10, test, "fast task missed deadlines", fast->MissedDeadlines);
+	Check(fast->MaxLateness_ms == 35, test, "fast task max lateness", fast->MaxLateness_ms);
+	Check(fast->RunCount == 30, test, "fast task runs", fast->RunCount);
+	CheckDeadlinesAccounted(test, FastTask);
+
+	const SchedulerTaskType* slow = SchedulerGetTask(SlowTask);
+	Check(slow->MissedDeadlines == 0, test, "slow task missed deadlines", slow->MissedDeadlines);
+	Check(slow->Overruns == 0, test, "slow task overruns", slow->Overruns);
+}
+
+static void TestFastPhaseWithOverrun(void)
+{
+	// the third run of the slow task takes 250 ms, longer than its own interval.
+	// Both tasks skip the deadlines they missed, and the fast task is still on its phase.
+	const char* test = "FastPhaseWithOverrun";
+	Start();
+	SlowLongRun = 3;
+	RunUntil(1000, false);
+	SlowLongRun = 0;
+
+	const SchedulerTaskType* fast = SchedulerGetTask(FastTask);
+	Check(!FastPhaseLost, test, "fast task off its 25 ms phase", fast->next_run_ms);
+	Check(fast->MaxLateness_ms == 225, test, "fast task max lateness", fast->MaxLateness_ms);
+	CheckDeadlinesAccounted(test, FastTask);
+
+	const SchedulerTaskType* slow = SchedulerGetTask(SlowTask);
+	Check(slow->Overruns == 1, test, "slow task overruns", slow->Overruns);
+	Check(slow->MissedDeadlines == 1, test, "slow task missed deadlines", slow->MissedDeadlines);
+	CheckDeadlinesAccounted(test, SlowTask);
+}
+
+// the tasks for the idle tests. Their run times are under their intervals and don't line up with the milliseconds,
+// and their intervals don't divide into each other, so their deadlines fall in every position relative to each other.
+static const int IdleTasks = 4;
+static const unsigned long IdleInterval_ms[IdleTasks] = { 25, 7, 13, 100 };
+static const unsigned long IdleRun_us[IdleTasks] = { 1300, 450, 2100, 6700 };
+static bool IdleTasksTakeTime;				// the tasks take their IdleRun_us, or no time
+
+static void IdleAction0(void*) { FakeTime_us += IdleTasksTakeTime ? IdleRun_us[0] : 0; }
+static void IdleAction1(void*) { FakeTime_us += IdleTasksTakeTime ? IdleRun_us[1] : 0; }
+static void IdleAction2(void*) { FakeTime_us += IdleTasksTakeTime ? IdleRun_us[2] : 0; }
+static void IdleAction3(void*) { FakeTime_us += IdleTasksTakeTime ? IdleRun_us[3] : 0; }
+static void(* const IdleActions[IdleTasks])(void*) = { IdleAction0, IdleAction1, IdleAction2, IdleAction3 };
+
+static void StartIdleTasks(bool takeTime)
+{
+	FakeTime_us = 0;
+	IdleCalls = 0;
+	IdleWhenDue = 0;
+	IdleTasksTakeTime = takeTime;
+
+	SchedulerSetClock(FakeMillis);
+	SchedulerInit();
+	for (int i = 0; i < IdleTasks; i++)
+	{
+		SchedulerAddTask(i, IdleActions[i], IdleInterval_ms[i], i, "Idle");
+	}
+}
+
+static void TestIdleNoLateStart(bool toDeadline)
+{
+	// the tasks take no time. With idle, every task starts in the millisecond it is due, and the idle step is only
+	// entered when nothing is due.
+	const char* test = toDeadline ? "IdleToDeadlineNoLateStart" : "IdleSysTickNoLateStart";
+	IdleToDeadline = toDeadline;
+	StartIdleTasks(false);
+	RunUntil(20000, true);
+
+	for (int i = 0; i < IdleTasks; i++)
+	{
+		const SchedulerTaskType* task = SchedulerGetTask(i);
+		Check(task->MaxLateness_ms == 0, test, "max lateness", task->MaxLateness_ms);
+		Check(task->MissedDeadlines == 0, test, "missed deadlines", task->MissedDeadlines);
+		Check(task->RunCount == 20000 / IdleInterval_ms[i] + (20000 % IdleInterval_ms[i] ? 1 : 0), test, "runs", task->RunCount);
+	}
+	Check(IdleCalls > 0, test, "idle calls", IdleCalls);
+	Check(IdleWhenDue == 0, test, "idle when a task was due", IdleWhenDue);
+	Check(SchedulerIdlePercent() > 50, test, "idle percent", SchedulerIdlePercent());
+}
+
+static void TestIdleSameAsSpinning(bool toDeadline)
+{
+	// the tasks take 0.45 to 6.7 ms, so they hold each other up. With idle, each task runs exactly as often,
+	// misses no more deadlines, and is no later, than when the loop spins.
+	const char* test = toDeadline ? "IdleToDeadlineSameAsSpinning" : "IdleSysTickSameAsSpinning";
+	SchedulerTaskType spinning[IdleTasks];
+
+	StartIdleTasks(true);
+	RunUntil(20000, false);
+	for (int i = 0; i < IdleTasks; i++)
+	{
+		spinning[i] = *SchedulerGetTask(i);
+	}
+
+	IdleToDeadline = toDeadline;
+	StartIdleTasks(true);
+	RunUntil(20000, true);
+	for (int i = 0; i < IdleTasks; i++)
+	{
+		const SchedulerTaskType* task = SchedulerGetTask(i);
+		Check(task->RunCount == spinning[i].RunCount, test, "runs", task->RunCount);
+		Check(task->MissedDeadlines <= spinning[i].MissedDeadlines, test, "missed deadlines", task->MissedDeadlines);
+		Check(task->MaxLateness_ms <= spinning[i].MaxLateness_ms, test, "max lateness", task->MaxLateness_ms);
+	}
+	Check(IdleCalls > 0, test, "idle calls", IdleCalls);
+	Check(IdleWhenDue == 0, test, "idle when a task was due", IdleWhenDue);
+}
+
+int main(void)
+{
+	TestFastPhaseWithSlowTask();
+	TestFastPhaseWithOverrun();
+	TestIdleNoLateStart(false);
+	TestIdleNoLateStart(true);
+	TestIdleSameAsSpinning(false);
+	TestIdleSameAsSpinning(true);
+
+	if (Failures)
+	{
+		printf("test_scheduler: %d failed\n", Failures);
+		return 1;
+	}
+	printf("test_scheduler: passed\n");
+	return 0;
+}
@@ -0,0 +1,249 @@
+// Simulated mission batch runner.
+// Runs the current mission repeatedly from the same start, each with a different simulated wind,
+// and accumulates the distribution of the mission time, leg time, distance sailed, tacks, in-irons events and max CTE.
+// Use with the simulation speed (sms) to complete many runs in less time.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 each run is seeded, so that the wind and vessel random sequences of any run can be repeated.
+//					Use srs to set the seed of the run, then mcr,1. The result is close to, not exactly, the same:
+//					the steering runs on real time, so its timing against the simulation differs from run to run.
+// V1.2 17/10/2026 each run restarts the navigation, steering and loiter state, and no longer clears the mission boundary (NavData.MaxCTE).
+//					The distributions use Welford's method.
+
+#include "sim_batch.h"
+#include "sim_vessel.h"
+#include "sim_weather.h"
+#include "AP_Math.h"
+#include "Mission.h"
+#include "Navigation.h"
+#include "CommandState_Processor.h"
+#include "HAL_SDCard.h"
+#include "HAL_Time.h"
+#include "TextFormat.h"
+#include "Steering.h"
+#include "Loiter.h"
+
+extern sim_vessel simulated_vessel;
+extern sim_weather simulated_weather;
+extern NavigationDataType NavData;
+extern StateValuesStruct StateValues;
+extern MissionValuesStruct MissionValues;
+extern LoiterStruct LoiterData;
+extern uint32_t SimulationSeed;
+
+// a run that has not finished the mission after this time is abandoned.
+static const unsigned long MaxRunTime_ms = 86400000UL; // 24 hours
+
+// range of the random change to the major wind direction for each run, +/- degrees.
+static const int WindDirectionSpread = 30;
+
+void sim_stat::reset()
+{
+	min = 0;
+	max = 0;
+	mean_value = 0;
+	m2 = 0;
+	count = 0;
+}
+
+void sim_stat::add(float value)
+{
+	if (count == 0 || value < min)
+		min = value;
+	if (count == 0 || value > max)
+		max = value;
+
+	count++;
+	double delta = value - mean_value;
+	mean_value += delta / count;
+	m2 += delta * (value - mean_value);
+}
+
+float sim_stat::mean()
+{
+	return count ? (float)mean_value : 0;
+}
+
+float sim_stat::std_dev()
+{
+	if (count < 2)
+		return 0;
+
+	double variance = m2 / (count - 1);
+	return variance > 0 ? (float)sqrt(variance) : 0;
+}
+
+void sim_batch::start(int runs)
+{
+	// start a batch of runs of the current mission, from the current simulated location and heading.
+	// V1.0 17/10/2026 John Semmens
+	if (runs <= 0 || MissionValues.mission_size == 0)
+		return;
+
+	StartLoc = simulated_vessel.Currentloc;
+	StartHeading = simulated_vessel.Heading;
+	StartMajorWindDirection = simulated_weather.MajorWindDirection;
+
+	BatchSeed = SimulationSeed;
+	RunsRequested = runs;
+	RunsCompleted = 0;
+	RunsTimedOut = 0;
+
+	MissionTime_s.reset();
+	LegTime_s.reset();
+	DistanceSailed_m.reset();
+	Tacks.reset();
+	InIrons.reset();
+	MaxCTE_m.reset();
+
+	Active = true;
+	char message[32];
+	FormatText(message, sizeof(message), "Sim Batch Start %d", runs);
+	SD_Logging_Event_Messsage(message);
+
+	start_run();
+}
+
+void sim_batch::stop()
+{
+	if (!Active)
+		return;
+
+	Active = false;
+	simulated_weather.MajorWindDirection = StartMajorWindDirection;
+	char message[32];
+	FormatText(message, sizeof(message), "Sim Batch End %d", RunsCompleted);
+	SD_Logging_Event_Messsage(message);
+}
+
+void sim_batch::start_run()
+{
+	// put the vessel back at the start, choose a new wind, and restart the mission.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 seed the simulation for this run.
+	// V1.2 17/10/2026 restart the navigation, steering and loiter state. The mission sets the boundary as it restarts.
+	RunSeed = BatchSeed + RunsCompleted;
+	SetSimulationSeed(RunSeed);
+	Rng.seed(RunSeed, 3);
+
+	simulated_vessel.Currentloc = StartLoc;
+	simulated_vessel.Heading = StartHeading;
+
+	simulated_weather.MajorWindDirection = wrap_360_Int(StartMajorWindDirection + Rng.range(-WindDirectionSpread, WindDirectionSpread + 1));
+	simulated_weather.update();
+
+	NavData.Currentloc = StartLoc;
+	NavData.HDG = StartHeading;
+
+	// filters, in-irons and manoeuvre state, tack timers and the steering PID start afresh, 
+	// so the run doesn't depend on how the previous run ended.
+	Navigation_Reset();
+	SteeringPID_Reset();
+	LoiterData.LoiterState = LoiterStateType::lsNotLoitering;
+
+	StateValues.mission_index = 0;
+	StateValues.StartingMission = true;
+	StateValues.CommandState = vcsFollowMission;
+
+	RunTime_s = 0;
+	Distance_m = 0;
+	TackCount = 0;
+	InIronsCount = 0;
+	MaxCTE = 0;
+	RunComplete = false;
+
+	RunStartTime = VirtualMillis();
+	LegStartTime = RunStartTime;
+}
+
+void sim_batch::end_run(bool timed_out)
+{
+	// record the results of the run, then start the next, or finish the batch.
+	// V1.0 17/10/2026 John Semmens
+	RunTime_s = (VirtualMillis() - RunStartTime) / 1000.0;
+
+	if (timed_out)
+	{
+		RunsTimedOut++;
+	}
+	else
+	{
+		MissionTime_s.add(RunTime_s);
+		DistanceSailed_m.add(Distance_m);
+		Tacks.add(TackCount);
+		InIrons.add(InIronsCount);
+		MaxCTE_m.add(MaxCTE);
+	}
+	RunsCompleted++;
+
+	SD_Logging_Event_SimRun(timed_out);
+
+	if (RunsCompleted < RunsRequested)
+		start_run();
+	else
+		stop();
+}
+
+void sim_batch::update()
+{
+	// called each second, after the simulated vessel has been updated.
+	// V1.0 17/10/2026 John Semmens
+	if (!Active)
+		return;
+
+	if (RunComplete)
+	{
+		end_run(false);
+		return;
+	}
+
+	if ((VirtualMillis() - RunStartTime) > MaxRunTime_ms)
+	{
+		end_run(true);
+		return;
+	}
+
+	Distance_m += simulated_vessel.SOG_mps * simulated_vessel.update_time_ms / 1000.0;
+
+	if (abs(NavData.CTE) > MaxCTE)
+		MaxCTE = abs(NavData.CTE);
+}
+
+void sim_batch::event(DecisionEventType decision, DecisionEventReasonType reason)
+{
+	// count the navigation decisions of interest during a run.
+	// Called for each decision event, as it is logged.
+	// V1.0 17/10/2026 John Semmens
+	if (!Active || RunComplete)
+		return;
+
+	switch (decision)
+	{
+	case deTackToPort:
+	case deTackToStarboard:
+	case deTackToPortRunning:
+	case deTackToStarboardRunning:
+		TackCount++;
+		break;
+
+	case deRecoverInIronsToPort:
+	case deRecoverInIronsToStbd:
+		InIronsCount++;
+		break;
+
+	case deIncrementMissionIndex:
+		if (reason == rPastWaypoint)
+		{
+			unsigned long now_ms = VirtualMillis();
+			LegTime_s.add((now_ms - LegStartTime) / 1000.0);
+			LegStartTime = now_ms;
+		}
+		break;
+
+	case deEndOfMission:
+		// finish the run at the next update, outside of the mission processing.
+		RunComplete = true;
+		break;
+
+	default:;
+	}
+}
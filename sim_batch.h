@@ -0,0 +1,70 @@
+#pragma once
+
+#include "location.h"
+#include "DisplayStrings.h"
+#include "sim_rng.h"
+
+// Simulated mission batch runner.
+// Repeats the current mission with the simulated vessel, and collects the distribution of the results of each run.
+// V1.0 17/10/2026 John Semmens
+
+struct sim_stat
+{
+	// running distribution of one result. min, max, mean and standard deviation.
+	// The mean and variance are updated by Welford's method, in double, so the variance doesn't lose precision
+	// by subtracting large sums. e.g. mission times of many hours over hundreds of runs.
+	float min;
+	float max;
+	double mean_value;
+	double m2;						// sum of squared differences from the mean
+	int count;
+
+	void reset();
+	void add(float value);
+	float mean();
+	float std_dev();
+};
+
+class sim_batch
+{
+private:
+	Location StartLoc;
+	int StartHeading;
+	int StartMajorWindDirection;
+	unsigned long RunStartTime;			// VirtualMillis at the start of the current run
+	unsigned long LegStartTime;			// VirtualMillis at the start of the current mission leg
+	bool RunComplete;
+	uint32_t BatchSeed;					// seed of the first run. Each run uses BatchSeed + run number.
+	sim_rng Rng;
+
+	void start_run();
+	void end_run(bool timed_out);
+
+public:
+	bool Active;
+	int RunsRequested;
+	int RunsCompleted;
+	int RunsTimedOut;
+
+	// results of the current run
+	uint32_t RunSeed;
+	float RunTime_s;
+	float Distance_m;
+	int TackCount;
+	int InIronsCount;
+	int MaxCTE;							// metres. the largest CTE of the run. NavData.MaxCTE is the mission boundary.
+
+	// distribution of the results over all completed runs
+	sim_stat MissionTime_s;
+	sim_stat LegTime_s;					// time from one waypoint to the next
+	sim_stat DistanceSailed_m;
+	sim_stat Tacks;
+	sim_stat InIrons;
+	sim_stat MaxCTE_m;
+
+	void start(int runs);
+	void stop();
+	void update();
+	void event(DecisionEventType decision, DecisionEventReasonType reason);
+};
+
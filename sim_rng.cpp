@@ -0,0 +1,53 @@
+// Seedable pseudo random number generator for the simulation.
+// PCG32, as described by M.E. O'Neill at www.pcg-random.org.
+// V1.0 17/10/2026 John Semmens
+
+#include "sim_rng.h"
+#include "sim_weather.h"
+#include "sim_vessel.h"
+
+extern sim_vessel simulated_vessel;
+extern sim_weather simulated_weather;
+extern uint32_t SimulationSeed;
+
+void SetSimulationSeed(uint32_t seed)
+{
+	// restart the random sequences of the simulated weather and vessel from the given seed.
+	// V1.0 17/10/2026 John Semmens
+	SimulationSeed = seed;
+	simulated_weather.seed(seed);
+	simulated_vessel.seed(seed);
+}
+
+void sim_rng::seed(uint32_t seed, uint32_t stream)
+{
+	// the stream selects one of 2^31 independent sequences for the same seed.
+	state = 0;
+	inc = ((uint64_t)stream << 1) | 1;
+	next();
+	state += seed;
+	next();
+}
+
+uint32_t sim_rng::next()
+{
+	uint64_t oldstate = state;
+	state = oldstate * 6364136223846793005ULL + inc;
+
+	uint32_t xorshifted = (uint32_t)(((oldstate >> 18) ^ oldstate) >> 27);
+	uint32_t rot = (uint32_t)(oldstate >> 59);
+	return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+long sim_rng::range(long low, long high)
+{
+	if (high <= low)
+		return low;
+
+	return low + (long)(next() % (uint32_t)(high - low));
+}
+
+float sim_rng::uniform(float low, float high)
+{
+	return low + (high - low) * (next() / 4294967296.0f);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+// Seedable pseudo random number generator for the simulation. PCG32 (www.pcg-random.org).
+// Each simulation object has its own generator, so that the random wind and vessel sequences of a run can be repeated from its seed,
+// and the sequence of one object is not affected by how often another draws numbers.
+// The run as a whole is not repeated exactly: the steering runs on real time, so its timing against the simulation varies.
+// V1.0 17/10/2026 John Semmens
+// V1.1 17/10/2026 SetSimulationSeed moved here from sim_batch.
+
+class sim_rng
+{
+private:
+	uint64_t state;
+	uint64_t inc;
+
+public:
+	void seed(uint32_t seed, uint32_t stream);
+	uint32_t next();
+	long range(long low, long high);		// low to high-1, the same as random(low, high)
+	float uniform(float low, float high);
+};
+
+void SetSimulationSeed(uint32_t seed);
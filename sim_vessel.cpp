@@ -3,13 +3,82 @@
 #include "AP_Math.h"
 #include "configValues.h"
 #include "sim_weather.h"
+#include "HAL_Time.h"
+#include "SD.h"
 
 extern configValuesType Configuration;		// stucture holding Configuration values; preset variables
 extern double SteeringServoOutput_LPF;
 extern sim_weather simulated_weather;
 
+// Default polar performance table. Boat speed in metres/second.
+// Rows: True Wind Angle 0, 15, 30 .. 180 degrees. Columns: True Wind Speed 0, 5, 10, 15, 20, 25 knots.
+// This can be replaced by a table loaded from the SD card with LoadPolar().
+static const float DefaultPolar[PolarTWA_Count][PolarTWS_Count] = {
+	//  0     5     10    15    20    25 knots
+	{ 0.00, 0.00, 0.00, 0.00, 0.00, 0.00 },	//   0
+	{ 0.00, 0.00, 0.00, 0.00, 0.00, 0.00 },	//  15
+	{ 0.00, 0.10, 0.20, 0.25, 0.25, 0.20 },	//  30
+	{ 0.00, 0.30, 0.55, 0.70, 0.75, 0.70 },	//  45
+	{ 0.00, 0.40, 0.75, 0.95, 1.00, 0.95 },	//  60
+	{ 0.00, 0.50, 0.90, 1.10, 1.20, 1.15 },	//  75
+	{ 0.00, 0.55, 1.00, 1.25, 1.35, 1.30 },	//  90
+	{ 0.00, 0.55, 1.00, 1.30, 1.45, 1.45 },	// 105
+	{ 0.00, 0.50, 0.95, 1.25, 1.45, 1.50 },	// 120
+	{ 0.00, 0.45, 0.90, 1.15, 1.35, 1.45 },	// 135
+	{ 0.00, 0.40, 0.80, 1.05, 1.25, 1.35 },	// 150
+	{ 0.00, 0.35, 0.70, 0.95, 1.15, 1.25 },	// 165
+	{ 0.00, 0.30, 0.65, 0.90, 1.05, 1.15 }	// 180
+};
+
+// leeway and heel model constants
+static const float MaxLeeway = 8.0;				// degrees. leeway when close hauled at low speed.
+static const float HeelPerKnot2 = 0.12;			// degrees of heel per knot^2 of beam wind.
+static const float MaxHeel = 35.0;				// degrees.
+static const float HeelSpeedLoss = 0.01;		// fraction of boat speed lost per degree of heel.
+
 void sim_vessel::init()
 {
+	// V1.1 17/10/2026 load the default polar table.
+	memcpy(Polar, DefaultPolar, sizeof(Polar));
+	seed(1);
+}
+
+void sim_vessel::seed(uint32_t seed)
+{
+	Rng.seed(seed, 2);
+}
+
+bool sim_vessel::LoadPolar(const char* filename)
+{
+	// load the polar performance table from a file on the SD card, replacing the default table.
+	// The file holds 13 rows of 6 comma or space separated boat speeds in metres/second,
+	// with the same layout as the default table.
+	// returns false, and keeps the current table, if the file is missing or incomplete.
+	// V1.0 17/10/2026 John Semmens
+
+	File PolarFile = SD.open(filename);
+	if (!PolarFile)
+		return false;
+
+	float table[PolarTWA_Count][PolarTWS_Count];
+	bool complete = true;
+
+	for (int twa = 0; twa < PolarTWA_Count && complete; twa++)
+	{
+		for (int tws = 0; tws < PolarTWS_Count && complete; tws++)
+		{
+			if (PolarFile.available())
+				table[twa][tws] = PolarFile.parseFloat();
+			else
+				complete = false;
+		}
+	}
+	PolarFile.close();
+
+	if (complete)
+		memcpy(Polar, table, sizeof(Polar));
+
+	return complete;
 }
 
 void sim_vessel::update()
@@ -17,9 +86,17 @@ void sim_vessel::update()
 	// update the simulated vessel position and attitude 
 	// // called in a 1 second loop
 	// V1.1 8/1/2022 added random component to heading update.
+	// V1.2 17/10/2026 elapsed time from VirtualMillis, to support faster than real time simulation.
+	
+	// V1.3 17/10/2026 boat speed from polar table with heel loss, and leeway added to the course over ground.
+	// V1.4 17/10/2026 wind sampled from the simulated wind field at the vessel location.
+	// V1.5 17/10/2026 random heading component from a seeded generator.
+	// V1.6 17/10/2026 wind sampled at the virtual time of this update.
 	
+	unsigned long start_us = micros();
+
 	// maintain an elapsed time between updates.
-	unsigned long current_time = millis();
+	unsigned long current_time = VirtualMillis();
 	update_time_ms = current_time - prev_update_time;
 	prev_update_time = current_time;
 
@@ -27,6 +104,9 @@ void sim_vessel::update()
 
 	if (update_time_ms < 10000) // < 10seconds
 	{
+		// get the wind at the vessel's location
+		simulated_weather.sample(Currentloc, current_time);
+
 		windAngle = wrap_180(simulated_weather.WindDirection - Heading);// -ve is port tack, +ve starboard tack
 
 		int SimTrueWindError = 40;
@@ -37,22 +117,34 @@ void sim_vessel::update()
 		else
 			windAngle = windAngle + SimTrueWindError; // eg. 190
 
+		// heel increases with the beam component of the wind, and slows the boat. 
+		// Roll is -ve to port, so heel is to port on starboard tack.
+		float Heel = constrain(HeelPerKnot2 * simulated_weather.WindSpeed * simulated_weather.WindSpeed * fabs(sin(radians(windAngle))), 0, MaxHeel);
+		Roll = (windAngle > 0) ? -Heel : Heel;
+
 		// calculate the simulated distance moved based on the VPP and elapsed time since last update
-		SOG_mps = vpp( windAngle, simulated_weather.WindSpeed);
+		SOG_mps = vpp( windAngle, simulated_weather.WindSpeed) * (1.0 - HeelSpeedLoss * Heel);
 		float UpdateDistance = SOG_mps * update_time_ms / 1000;
 
+		// leeway is greatest close hauled and at low boat speed, and none when running.
+		// the boat slips to leeward, i.e. away from the wind.
+		float LeewayMagnitude = 0;
+		if (abs(windAngle) < 90 && SOG_mps > 0)
+			LeewayMagnitude = MaxLeeway * cos(radians(windAngle)) / (1.0 + SOG_mps);
+		Leeway = (windAngle > 0) ? -LeewayMagnitude : LeewayMagnitude;
+
 		// calculate the simulated heading change based on rudder position, and SOG (sort of boat speed) and elapsed time since last update
 		float TurnRateFactor = 40; // 30; // degrees/second
 		HeadingChange = ((SteeringServoOutput_LPF - Configuration.pidCentre) / 500.0) * SOG_mps / 1.0 * (update_time_ms / 1000.0) * TurnRateFactor; // update heading, in degrees
 
 		// Add a random component to the heading
-		RandomHeadingComponent = random(-3, 4);
+		RandomHeadingComponent = Rng.range(-3, 4);
 	
 		Heading = wrap_360_Int(Heading - HeadingChange + RandomHeadingComponent);
+		COG = wrap_360_Int(Heading + (int)Leeway);
 
-
-		// update the simulated vessel postion  based on new heading and distance.
-		location_update(Currentloc, (float)Heading, UpdateDistance);	
+		// update the simulated vessel postion  based on course over ground and distance.
+		location_update(Currentloc, (float)COG, UpdateDistance);	
 		
 		if (windAngle > 0) // simulatethe real wing angle in response to apparent wind.
 			WingsailAngle = windAngle - 15; 
@@ -72,25 +164,29 @@ void sim_vessel::update()
 			}
 		}
 	}
+
+	update_duration_us = micros() - start_us;
 }
 
 float sim_vessel::vpp(int windAngle, int windspeed) // degrees from head-to-wind, knots
 {
 	// V1.0 9/4/2021 initial simple VPP program
-	
-	int AbsWindAngle = abs(windAngle);
-	float velocity; // Metres/second
+	// V1.1 17/10/2026 replaced linear model with bilinear interpolation of the polar table.
+	// The table is a regular grid, so the cell is found by division rather than searching.
 
-	// 10 knot wind at 90 degrees yields 1 m/s boat speed.
+	float twa = constrain(abs(wrap_180(windAngle)), 0, 180);
+	float tws = constrain(windspeed, 0, (PolarTWS_Count - 1) * PolarTWS_Step);
 
-	if (AbsWindAngle <= 90) // 0 to 90 degrees, increase speed proportionally with angle
-	{
-		velocity = AbsWindAngle / 90.0 * windspeed / 10.0;
-	}
-	else
-	{
-		velocity =  windspeed / 10.0; // speed is constant in lower half of polar diagram.
-	}
+	// cell indexes, limited so that the upper neighbour is always in the table
+	int i = min((int)(twa / PolarTWA_Step), PolarTWA_Count - 2);
+	int j = min((int)(tws / PolarTWS_Step), PolarTWS_Count - 2);
+
+	// position within the cell, 0 to 1
+	float u = (twa - i * PolarTWA_Step) / PolarTWA_Step;
+	float v = (tws - j * PolarTWS_Step) / PolarTWS_Step;
 
-	return velocity;
-}
\ No newline at end of file
+	float lower = Polar[i][j] + (Polar[i][j + 1] - Polar[i][j]) * v;
+	float upper = Polar[i + 1][j] + (Polar[i + 1][j + 1] - Polar[i + 1][j]) * v;
+
+	return lower + (upper - lower) * u; // Metres/second
+}
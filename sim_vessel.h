@@ -1,16 +1,26 @@
 #pragma once
 
 //#include "waypoints.h"
+#include "sim_rng.h"
+
+// Polar performance table dimensions. Rows are True Wind Angle, columns are True Wind Speed.
+static const int PolarTWA_Count = 13;	// 0 to 180 degrees
+static const int PolarTWA_Step = 15;	// degrees
+static const int PolarTWS_Count = 6;	// 0 to 25 knots
+static const int PolarTWS_Step = 5;		// knots
 
 class sim_vessel
 {
 private:
 	unsigned long prev_update_time;
+	sim_rng Rng;
 
 public:
 	int Heading; // degrees
+	int COG; // degrees. Heading plus leeway.
 	int Pitch; 
 	int Roll; 
+	float Leeway; // degrees. +ve is to starboard.
 
 	Location Currentloc;
 
@@ -19,11 +29,16 @@ public:
 	int WingsailAngle;
 
 	void init();
+	void seed(uint32_t seed);
 	void update();
 	unsigned long update_time_ms;
 	int HeadingChange;
 	int RandomHeadingComponent;
 
 	float vpp(int windAngle, int windspeed); // degrees from head-to--wind, knots
+
+	float Polar[PolarTWA_Count][PolarTWS_Count]; // boat speed, metres/second
+	bool LoadPolar(const char* filename);
+	unsigned long update_duration_us;
 };
 
@@ -1,11 +1,68 @@
+// Simulated Weather
+// A wind field for use with the simulated vessel.
+// V1.2 17/10/2026 replaced the random component with a wind field model:
+//					an oscillating shift, a persistent shift that wanders each minute, a slow variation in speed,
+//					and gust cells that drift downwind across a grid around the vessel.
+//					The gust effects are cached at the grid nodes and interpolated at the vessel location,
+//					so a sample costs the same regardless of the number of gusts.
+// V1.3 17/10/2026 random numbers from a seeded generator, so the wind can be repeated from its seed.
+// V1.4 17/10/2026 the wind is sampled at a given time. Gusts are removed and spawned in wind aligned coordinates,
+//					so a gust spawned upwind of the grid in a diagonal wind is not removed before it reaches the grid.
+
 #include "sim_weather.h"
 #include "AP_Math.h"
+#include "HAL_Time.h"
+
+// oscillating shift
+static const float OscillationAmplitude = 10.0;		// degrees
+static const float OscillationPeriod_s = 600.0;		// 10 minutes
+
+// persistent shift
+static const float MaxPersistentShift = 30.0;		// degrees
+static const float MaxShiftRate = 2.0;				// degrees per minute
+
+// speed variation
+static const float SpeedVariation = 0.15;			// fraction of the base wind speed
+static const float SpeedPeriod_s = 900.0;			// 15 minutes
+
+// gusts
+static const float MinGustRadius = 150.0;			// metres
+static const float MaxGustRadius = 400.0;			// metres
+static const float MinGustStrength = 3.0;			// knots
+static const float MaxGustStrength = 8.0;			// knots
+static const float MaxGustVeer = 10.0;				// degrees
+static const unsigned long GridRefreshTime_ms = 5000;
+
+static const float KnotsToMps = 0.514444;
+static const float GridHalfSize = (WindGridSize - 1) * WindGridSpacing / 2;
+static const float GridExtent = GridHalfSize * 1.41421356;	// half the diagonal. The grid fits within this distance of the origin in any direction.
 
 void sim_weather::init()
 {
 	WindSpeed = 10; // knots
 	WindDirection = 350; // NNW
 	MajorWindDirection = 350;
+
+	BaseWindSpeed = 10;
+
+	seed(1);
+}
+
+void sim_weather::seed(uint32_t seed)
+{
+	// restart the random parts of the wind field from the given seed.
+	// The major wind direction and mean wind speed are not changed.
+	// V1.0 17/10/2026 John Semmens
+	Rng.seed(seed, 1);
+
+	PersistentShift = 0;
+	ShiftRate = 0;
+	OriginSet = false;
+
+	for (int g = 0; g < WindGustCells; g++)
+	{
+		spawn_gust(Gusts[g], false);
+	}
 }
 
 
@@ -14,5 +71,169 @@ void sim_weather::update()
 	// called in a 1 minute
 	
 	// V1.1 8/1/2022 added random component to wind direction
-	 WindDirection = MajorWindDirection + random(-15,16) ; // NNW + random component
+	// V1.2 17/10/2026 the persistent shift wanders, by a random change to its rate.
+	ShiftRate = constrain(ShiftRate + Rng.uniform(-0.5, 0.5), -MaxShiftRate, MaxShiftRate);
+	PersistentShift = PersistentShift + ShiftRate;
+
+	// turn the shift back when it reaches the limit
+	if (fabs(PersistentShift) > MaxPersistentShift)
+	{
+		PersistentShift = constrain(PersistentShift, -MaxPersistentShift, MaxPersistentShift);
+		ShiftRate = -ShiftRate;
+	}
+
+	if (OriginSet)
+		sample(Origin, VirtualMillis());
+}
+
+void sim_weather::sample(const Location& loc, unsigned long now_ms)
+{
+	// set WindSpeed and WindDirection to the wind at the given location, at the given virtual time.
+	// The oscillation and speed variation are those at now_ms. The gusts only move forward in time,
+	// so a time earlier than the last grid refresh sees the gusts where they are now.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 time passed in, rather than read from VirtualMillis.
+	float t = now_ms / 1000.0;
+
+	if (!OriginSet)
+		recentre(loc, now_ms);
+
+	// location relative to the grid origin
+	float distance = get_distance(Origin, loc);
+	float bearing = radians(get_bearingf(Origin, loc));
+	float north = distance * cos(bearing);
+	float east = distance * sin(bearing);
+
+	// keep the grid centred near the vessel
+	if (fabs(north) > GridHalfSize * 0.75 || fabs(east) > GridHalfSize * 0.75)
+	{
+		recentre(loc, now_ms);
+		north = 0;
+		east = 0;
+	}
+
+	if ((long)(now_ms - GridTime) >= (long)GridRefreshTime_ms)
+		refresh_grid(now_ms);
+
+	// bilinear interpolation of the gust effects at the location
+	float x = constrain((east + GridHalfSize) / WindGridSpacing, 0, WindGridSize - 1.001);
+	float y = constrain((north + GridHalfSize) / WindGridSpacing, 0, WindGridSize - 1.001);
+	int i = (int)x;
+	int j = (int)y;
+	float u = x - i;
+	float v = y - j;
+
+	float GustSpeed = (GridSpeed[i][j] * (1 - u) + GridSpeed[i + 1][j] * u) * (1 - v)
+		+ (GridSpeed[i][j + 1] * (1 - u) + GridSpeed[i + 1][j + 1] * u) * v;
+	float GustVeer = (GridDirection[i][j] * (1 - u) + GridDirection[i + 1][j] * u) * (1 - v)
+		+ (GridDirection[i][j + 1] * (1 - u) + GridDirection[i + 1][j + 1] * u) * v;
+
+	float Oscillation = OscillationAmplitude * sin(TWO_PI * t / OscillationPeriod_s);
+	float Speed = BaseWindSpeed * (1 + SpeedVariation * sin(TWO_PI * t / SpeedPeriod_s)) + GustSpeed;
+
+	WindDirection = wrap_360_Int(MajorWindDirection + (int)(PersistentShift + Oscillation + GustVeer));
+	WindSpeed = (int)(Speed + 0.5);
+	if (WindSpeed < 0)
+		WindSpeed = 0;
+}
+
+void sim_weather::refresh_grid(unsigned long now_ms)
+{
+	// move the gust cells downwind, and recalculate the gust effect at each grid node.
+	// V1.0 17/10/2026 John Semmens
+	float dt = (now_ms - GridTime) / 1000.0;
+	if (dt > 60)
+		dt = 60; // limit the movement after a long gap, e.g. the first refresh
+	GridTime = now_ms;
+
+	// the wind direction is where the wind comes from, so the gusts move the opposite way.
+	// V1.1 17/10/2026 gusts removed in wind aligned coordinates, matching where spawn_gust starts them.
+	float wind = radians(MajorWindDirection + PersistentShift);
+	float drift = BaseWindSpeed * KnotsToMps * dt;
+
+	for (int g = 0; g < WindGustCells; g++)
+	{
+		Gusts[g].north -= drift * cos(wind);
+		Gusts[g].east -= drift * sin(wind);
+
+		// once a gust has passed downwind of the grid, or is clear to one side, start a new one on the upwind side.
+		// along is +ve upwind of the origin.
+		float along = Gusts[g].north * cos(wind) + Gusts[g].east * sin(wind);
+		float across = -Gusts[g].north * sin(wind) + Gusts[g].east * cos(wind);
+		if (along < -(GridExtent + Gusts[g].radius) || fabs(across) > GridExtent + Gusts[g].radius)
+			spawn_gust(Gusts[g], true);
+	}
+
+	for (int i = 0; i < WindGridSize; i++)
+	{
+		for (int j = 0; j < WindGridSize; j++)
+		{
+			float east = i * WindGridSpacing - GridHalfSize;
+			float north = j * WindGridSpacing - GridHalfSize;
+			float speed = 0;
+			float veer = 0;
+
+			for (int g = 0; g < WindGustCells; g++)
+			{
+				float dn = north - Gusts[g].north;
+				float de = east - Gusts[g].east;
+				float r2 = (dn * dn + de * de) / (Gusts[g].radius * Gusts[g].radius);
+				if (r2 < 1)
+				{
+					speed += Gusts[g].strength * (1 - r2);
+					veer += Gusts[g].veer * (1 - r2);
+				}
+			}
+			GridSpeed[i][j] = speed;
+			GridDirection[i][j] = veer;
+		}
+	}
+}
+
+void sim_weather::spawn_gust(gust_cell& gust, bool upwind)
+{
+	// start a new gust cell. Either anywhere on the grid, or just upwind of the grid, whatever the wind direction.
+	// V1.0 17/10/2026 John Semmens
+	// V1.1 17/10/2026 spawned upwind of the grid extent rather than the grid edge, so it is inside the removal test of refresh_grid.
+	gust.radius = Rng.uniform(MinGustRadius, MaxGustRadius);
+	gust.strength = Rng.uniform(MinGustStrength, MaxGustStrength);
+	gust.veer = Rng.uniform(-MaxGustVeer, MaxGustVeer);
+
+	if (upwind)
+	{
+		float wind = radians(MajorWindDirection + PersistentShift);
+		float across = Rng.uniform(-GridExtent, GridExtent);
+		float along = GridExtent + gust.radius * 0.9;
+
+		gust.north = along * cos(wind) - across * sin(wind);
+		gust.east = along * sin(wind) + across * cos(wind);
+	}
+	else
+	{
+		gust.north = Rng.uniform(-GridHalfSize, GridHalfSize);
+		gust.east = Rng.uniform(-GridHalfSize, GridHalfSize);
+	}
+}
+
+void sim_weather::recentre(const Location& loc, unsigned long now_ms)
+{
+	// move the grid origin to the given location, keeping the gusts where they are.
+	// V1.0 17/10/2026 John Semmens
+	if (OriginSet)
+	{
+		float distance = get_distance(Origin, loc);
+		float bearing = radians(get_bearingf(Origin, loc));
+		float north = distance * cos(bearing);
+		float east = distance * sin(bearing);
+
+		for (int g = 0; g < WindGustCells; g++)
+		{
+			Gusts[g].north -= north;
+			Gusts[g].east -= east;
+		}
+	}
+
+	Origin = loc;
+	OriginSet = true;
+	GridTime = now_ms - GridRefreshTime_ms; // force a refresh of the grid
 }
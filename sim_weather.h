@@ -1,12 +1,48 @@
 #pragma once
+
+#include "location.h"
+#include "sim_rng.h"
+
+// wind field grid. Gust effects are cached at the grid nodes and interpolated at the vessel location.
+static const int WindGridSize = 9;				// nodes along each side
+static const float WindGridSpacing = 250.0;		// metres between nodes
+static const int WindGustCells = 4;
+
+struct gust_cell
+{
+	float north;		// metres from the grid origin
+	float east;			// metres from the grid origin
+	float radius;		// metres
+	float strength;		// knots added at the centre of the cell
+	float veer;			// degrees added to the wind direction at the centre of the cell
+};
+
 class sim_weather
 {
+private:
+	Location Origin;			// centre of the wind grid
+	bool OriginSet;
+	unsigned long GridTime;		// VirtualMillis of the last grid refresh
+	float GridSpeed[WindGridSize][WindGridSize];		// knots added by the gusts at each node
+	float GridDirection[WindGridSize][WindGridSize];	// degrees added by the gusts at each node
+	gust_cell Gusts[WindGustCells];
+	sim_rng Rng;
+
+	void refresh_grid(unsigned long now_ms);
+	void spawn_gust(gust_cell& gust, bool upwind);
+	void recentre(const Location& loc, unsigned long now_ms);
+
 public:
 	int WindSpeed; // knots
 	int WindDirection; // degrees. 0 degrees is a northerly wind
 	int MajorWindDirection;
 
+	float BaseWindSpeed;		// knots. mean wind speed before variation and gusts
+	float PersistentShift;		// degrees. slowly wandering shift from the major direction
+	float ShiftRate;			// degrees/minute. rate of change of the persistent shift
+
 	void init();
+	void seed(uint32_t seed);
 	void update();
+	void sample(const Location& loc, unsigned long now_ms);
 };
-